@@ -0,0 +1,198 @@
+#ifndef BENCHUTIL_H
+#define BENCHUTIL_H
+
+#include <chrono>
+#include <fstream>
+#include <cstdio>
+#include <cstdint>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <unistd.h>
+#endif
+
+#include "../Headers/OutfitPicker.h"
+
+using namespace std;
+
+/* LegacyClothingItem
+ * The original string-based item layout, kept as a baseline for comparisons.
+ */
+struct LegacyClothingItem {
+    string type;
+    bool isLong;
+    string material;
+    string color;
+    string pattern;
+};
+
+struct LegacyWardrobe {
+    vector<LegacyClothingItem> jackets;
+    vector<LegacyClothingItem> tops;
+    vector<LegacyClothingItem> bottoms;
+    vector<LegacyClothingItem> shoes;
+};
+
+/* legacyLoadDatabase
+ * The original getline/substr/erase loader, kept as the baseline.
+ */
+inline LegacyWardrobe legacyLoadDatabase(const string& filename) {
+    LegacyWardrobe clothingDatabase;
+    ifstream file(filename);
+    string line;
+
+    while (getline(file, line)) {
+        LegacyClothingItem item;
+        size_t pos = 0;
+        pos = line.find(',');
+        item.type = line.substr(0, pos);
+        line.erase(0, pos + 1);
+
+        pos = line.find(',');
+        item.isLong = (line.substr(0, pos) == "true");
+        line.erase(0, pos + 1);
+
+        pos = line.find(',');
+        item.material = line.substr(0, pos);
+        line.erase(0, pos + 1);
+
+        pos = line.find(',');
+        item.color = line.substr(0, pos);
+        line.erase(0, pos + 1);
+
+        item.pattern = line;
+
+        if (item.type == "top") clothingDatabase.tops.push_back(item);
+        else if (item.type == "bottom") clothingDatabase.bottoms.push_back(item);
+        else if (item.type == "shoes") clothingDatabase.shoes.push_back(item);
+        else if (item.type == "jacket") clothingDatabase.jackets.push_back(item);
+    }
+    return clothingDatabase;
+}
+
+/* residentBytes
+ * Returns the current resident set size of this process, or 0 if unknown.
+ */
+inline size_t residentBytes() {
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) return counters.WorkingSetSize;
+    return 0;
+#else
+    FILE* statm = fopen("/proc/self/statm", "r");
+    if (statm == nullptr) return 0;
+    size_t pages = 0, resident = 0;
+    if (fscanf(statm, "%zu %zu", &pages, &resident) != 2) resident = 0;
+    fclose(statm);
+    return resident * sysconf(_SC_PAGESIZE);
+#endif
+}
+
+/* Stopwatch
+ * Measures wall-clock time since construction or the last reset().
+ */
+struct Stopwatch {
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+
+    void reset() { start = chrono::steady_clock::now(); }
+    double seconds() const {
+        return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    }
+};
+
+/* argOr
+ * Reads a numeric command-line argument, falling back to a default.
+ *
+ * Parameters:
+ *   argc, argv - arguments passed to main.
+ *   index      - position of the argument to read.
+ *   fallback   - value used when the argument is missing.
+ */
+inline size_t argOr(int argc, char** argv, int index, size_t fallback) {
+    return index < argc ? strtoull(argv[index], nullptr, 10) : fallback;
+}
+
+/* generateWardrobeCsv
+ * Writes a synthetic wardrobe CSV in the same format as outfits.csv.
+ *
+ * Parameters:
+ *   filename    - path of the file to create.
+ *   rows        - number of clothing items to write.
+ *   cardinality - number of distinct materials, colors and patterns to draw from.
+ *   seed        - RNG seed, so the same arguments always produce the same file.
+ *
+ * Returns:
+ *   Number of bytes written.
+ */
+inline size_t generateWardrobeCsv(const string& filename, size_t rows, size_t cardinality = 24, uint64_t seed = 42) {
+    static const char* types[] = {"jacket", "top", "bottom", "shoes"};
+    static const char* materials[] = {"cotton", "wool", "synthetic", "silk", "denim", "leather", "linen", "rubber"};
+    static const char* colors[] = {"black", "white", "grey", "blue", "navy", "cream", "brown", "green", "red"};
+    static const char* patterns[] = {"solid", "striped", "plaid", "plain", "checked", "floral"};
+
+    //Attribute pools repeat the base words with a numeric suffix once cardinality exceeds them
+    auto makePool = [&](const char* const* words, size_t count) {
+        vector<string> pool;
+        for (size_t i = 0; i < cardinality; i++) {
+            pool.push_back(words[i % count]);
+            if (i >= count) pool.back() += to_string(i / count);
+        }
+        return pool;
+    };
+    vector<string> materialPool = makePool(materials, 8);
+    vector<string> colorPool = makePool(colors, 9);
+    vector<string> patternPool = makePool(patterns, 6);
+
+    FILE* file = fopen(filename.c_str(), "wb");
+    if (file == nullptr) return 0;
+    setvbuf(file, nullptr, _IOFBF, 1 << 20);
+
+    mt19937_64 rng(seed);
+    size_t bytes = 0;
+    for (size_t i = 0; i < rows; i++) {
+        uint64_t r = rng();
+        bytes += fprintf(file, "%s,%s,%s,%s,%s\n",
+                         types[r & 3],
+                         (r >> 2) & 1 ? "true" : "false",
+                         materialPool[(r >> 8) % cardinality].c_str(),
+                         colorPool[(r >> 24) % cardinality].c_str(),
+                         patternPool[(r >> 40) % cardinality].c_str());
+    }
+    fclose(file);
+    return bytes;
+}
+
+/* randomWardrobe
+ * Builds an indexed wardrobe of random items without going through a file.
+ *
+ * Parameters:
+ *   items       - number of clothing items to create.
+ *   cardinality - number of distinct materials, colors and patterns to draw from.
+ *   seed        - RNG seed.
+ */
+inline Wardrobe randomWardrobe(size_t items, size_t cardinality = 24, uint64_t seed = 42) {
+    vector<AttributeId> ids;
+    for (size_t i = 0; i < cardinality; i++) ids.push_back(internAttribute("attr" + to_string(i)));
+
+    Wardrobe outfits;
+    mt19937_64 rng(seed);
+    for (size_t i = 0; i < items; i++) {
+        uint64_t r = rng();
+        ClothingItem item;
+        item.type = r & 3;
+        item.isLong = (r >> 2) & 1;
+        item.material = ids[(r >> 8) % cardinality];
+        item.color = ids[(r >> 24) % cardinality];
+        item.pattern = ids[(r >> 40) % cardinality];
+        insertClothing(outfits, item);
+    }
+    return outfits;
+}
+
+#endif
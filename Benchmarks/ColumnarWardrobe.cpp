@@ -0,0 +1,308 @@
+/* Nolan Pierce - Columnar Wardrobe Implementation
+ *
+ * Overview:
+ *   Keeps a copy of a Wardrobe's attributes column by column so filters such
+ *   as "long-sleeved, wool, not striped" scan contiguous 16-bit IDs instead of
+ *   whole items. filterColumns compares 16 (SSE2) or 32 (AVX2) rows per step
+ *   and writes the matching rows out as a candidate list.
+ *
+ * Details:
+ *   - The columns are a read-only copy for measuring filter kernels and are
+ *     only built into filterBench; picks filter through the attribute groups
+ *     of the WardrobeIndex instead, which edits keep current.
+ */
+#include "ColumnarWardrobe.h"
+#include <algorithm>
+#include <stdexcept>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define COLUMNS_SSE2 1
+#include <immintrin.h>
+#endif
+
+//GCC and Clang build the AVX2 kernel for any x86 target and pick it at run time;
+//MSVC only has it when the whole program is compiled with /arch:AVX2
+#if defined(COLUMNS_SSE2) && (defined(__GNUC__) || defined(__clang__))
+#define COLUMNS_AVX2 1
+#define AVX2_TARGET __attribute__((target("avx2")))
+#elif defined(COLUMNS_SSE2) && defined(__AVX2__)
+#define COLUMNS_AVX2 1
+#define AVX2_TARGET
+#endif
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+using namespace std;
+
+// One attribute comparison; equal checks keep matching rows, unequal ones drop them
+struct ColumnCheck {
+    const AttributeId* column;
+    AttributeId value;
+    bool equal;
+};
+
+// A filter flattened into the checks that actually constrain something
+struct CompiledFilter {
+    ColumnCheck checks[6];
+    size_t checkCount = 0;
+    uint8_t length = LENGTH_ANY;
+    const uint64_t* isLong = nullptr;
+};
+
+/* lowestBit
+ * Returns the index of the lowest set bit of a non-zero mask.
+ */
+static inline unsigned lowestBit(uint32_t mask) {
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return index;
+#else
+    return __builtin_ctz(mask);
+#endif
+}
+
+/* emitRows
+ * Writes base + i for every set bit i of mask and returns the new end of the list.
+ */
+static inline uint32_t* emitRows(uint32_t* out, uint32_t mask, uint32_t base) {
+    while (mask != 0) {
+        *out++ = base + lowestBit(mask);
+        mask &= mask - 1;
+    }
+    return out;
+}
+
+/* lengthMask
+ * Applies the isLong condition to a block of up to 32 rows starting at row.
+ *
+ * Details:
+ *   - row must be a multiple of the block width, so the block never straddles two words.
+ */
+static inline uint32_t lengthMask(const CompiledFilter& filter, size_t row, uint32_t mask, uint32_t width) {
+    if (filter.length == LENGTH_ANY) return mask;
+    uint64_t blockMask = width == 32 ? 0xFFFFFFFFull : (uint64_t(1) << width) - 1;
+    uint32_t bits = uint32_t((filter.isLong[row >> 6] >> (row & 63)) & blockMask);
+    return filter.length == LENGTH_LONG ? mask & bits : mask & ~bits;
+}
+
+/* matchesRow
+ * Scalar check of one row, used by the scalar kernel and for block tails.
+ */
+static inline bool matchesRow(const CompiledFilter& filter, size_t row) {
+    for (size_t c = 0; c < filter.checkCount; c++) {
+        const ColumnCheck& check = filter.checks[c];
+        if ((check.column[row] == check.value) != check.equal) return false;
+    }
+    if (filter.length == LENGTH_ANY) return true;
+    bool isLong = (filter.isLong[row >> 6] >> (row & 63)) & 1;
+    return isLong == (filter.length == LENGTH_LONG);
+}
+
+static uint32_t* filterScalar(const CompiledFilter& filter, size_t begin, size_t rows, uint32_t* out) {
+    for (size_t row = begin; row < rows; row++) {
+        if (matchesRow(filter, row)) *out++ = uint32_t(row);
+    }
+    return out;
+}
+
+#ifdef COLUMNS_SSE2
+/* filterSse2
+ * Tests 16 rows per step: two 8-lane compares per check, packed into one byte mask.
+ */
+static uint32_t* filterSse2(const CompiledFilter& filter, size_t rows, uint32_t* out) {
+    __m128i values[6];
+    for (size_t c = 0; c < filter.checkCount; c++) values[c] = _mm_set1_epi16(short(filter.checks[c].value));
+
+    size_t row = 0;
+    for (; row + 16 <= rows; row += 16) {
+        __m128i low = _mm_set1_epi8(-1);
+        __m128i high = low;
+        for (size_t c = 0; c < filter.checkCount; c++) {
+            const __m128i* column = reinterpret_cast<const __m128i*>(filter.checks[c].column + row);
+            __m128i lowHit = _mm_cmpeq_epi16(_mm_loadu_si128(column), values[c]);
+            __m128i highHit = _mm_cmpeq_epi16(_mm_loadu_si128(column + 1), values[c]);
+            if (filter.checks[c].equal) {
+                low = _mm_and_si128(low, lowHit);
+                high = _mm_and_si128(high, highHit);
+            }
+            else {
+                low = _mm_andnot_si128(lowHit, low);
+                high = _mm_andnot_si128(highHit, high);
+            }
+        }
+        uint32_t mask = uint32_t(_mm_movemask_epi8(_mm_packs_epi16(low, high)));
+        out = emitRows(out, lengthMask(filter, row, mask, 16), uint32_t(row));
+    }
+    return filterScalar(filter, row, rows, out);
+}
+#endif
+
+#ifdef COLUMNS_AVX2
+/* filterAvx2
+ * Tests 32 rows per step: two 16-lane compares per check, packed into one byte mask.
+ *
+ * Details:
+ *   - packs_epi16 interleaves the 128-bit halves of its inputs, so the packed
+ *     result is permuted back into row order before taking the mask.
+ */
+AVX2_TARGET static uint32_t* filterAvx2(const CompiledFilter& filter, size_t rows, uint32_t* out) {
+    __m256i values[6];
+    for (size_t c = 0; c < filter.checkCount; c++) values[c] = _mm256_set1_epi16(short(filter.checks[c].value));
+
+    size_t row = 0;
+    for (; row + 32 <= rows; row += 32) {
+        __m256i low = _mm256_set1_epi8(-1);
+        __m256i high = low;
+        for (size_t c = 0; c < filter.checkCount; c++) {
+            const __m256i* column = reinterpret_cast<const __m256i*>(filter.checks[c].column + row);
+            __m256i lowHit = _mm256_cmpeq_epi16(_mm256_loadu_si256(column), values[c]);
+            __m256i highHit = _mm256_cmpeq_epi16(_mm256_loadu_si256(column + 1), values[c]);
+            if (filter.checks[c].equal) {
+                low = _mm256_and_si256(low, lowHit);
+                high = _mm256_and_si256(high, highHit);
+            }
+            else {
+                low = _mm256_andnot_si256(lowHit, low);
+                high = _mm256_andnot_si256(highHit, high);
+            }
+        }
+        __m256i packed = _mm256_permute4x64_epi64(_mm256_packs_epi16(low, high), _MM_SHUFFLE(3, 1, 2, 0));
+        uint32_t mask = uint32_t(_mm256_movemask_epi8(packed));
+        out = emitRows(out, lengthMask(filter, row, mask, 32), uint32_t(row));
+    }
+    return filterScalar(filter, row, rows, out);
+}
+#endif
+
+/* buildColumns
+ * Copies a wardrobe's items into columns.
+ *
+ * Parameters:
+ *   outfits - wardrobe to copy; row i of each type is position i of its vector.
+ *
+ * Details:
+ *   - The columns are a separate copy and do not follow later edits; build
+ *     them again after the wardrobe changes.
+ */
+ColumnarWardrobe buildColumns(const Wardrobe& outfits) {
+    ColumnarWardrobe columns;
+    for (uint8_t type = JACKET; type <= SHOES; type++) {
+        const vector<ClothingItem>& items = getType(outfits, type);
+        ClothingColumns& typed = columns.types[type];
+        typed.rows = items.size();
+        typed.material.resize(items.size());
+        typed.color.resize(items.size());
+        typed.pattern.resize(items.size());
+        typed.isLong.assign(items.size() / 64 + 1, 0);
+        for (size_t row = 0; row < items.size(); row++) {
+            typed.material[row] = items[row].material;
+            typed.color[row] = items[row].color;
+            typed.pattern[row] = items[row].pattern;
+            typed.isLong[row >> 6] |= uint64_t(items[row].isLong) << (row & 63);
+        }
+    }
+    return columns;
+}
+
+/* filterKernelSupported
+ * Returns true if the given kernel can run on this CPU and build.
+ */
+bool filterKernelSupported(FilterKernel kernel) {
+    switch (kernel) {
+    case KERNEL_AUTO:
+    case KERNEL_SCALAR:
+        return true;
+    case KERNEL_SSE2:
+#ifdef COLUMNS_SSE2
+        return true;
+#else
+        return false;
+#endif
+    case KERNEL_AVX2:
+#if defined(COLUMNS_AVX2) && (defined(__GNUC__) || defined(__clang__))
+        return __builtin_cpu_supports("avx2");
+#elif defined(COLUMNS_AVX2)
+        return true;
+#else
+        return false;
+#endif
+    }
+    return false;
+}
+
+/* resolveKernel
+ * Turns KERNEL_AUTO into the fastest supported kernel.
+ */
+static FilterKernel resolveKernel(FilterKernel kernel) {
+    if (kernel != KERNEL_AUTO) return kernel;
+    static const FilterKernel best = filterKernelSupported(KERNEL_AVX2) ? KERNEL_AVX2 :
+                                     filterKernelSupported(KERNEL_SSE2) ? KERNEL_SSE2 : KERNEL_SCALAR;
+    return best;
+}
+
+/* filterKernelName
+ * Returns a short name for a kernel, resolving KERNEL_AUTO first.
+ */
+const char* filterKernelName(FilterKernel kernel) {
+    switch (resolveKernel(kernel)) {
+    case KERNEL_SSE2: return "sse2";
+    case KERNEL_AVX2: return "avx2";
+    default: return "scalar";
+    }
+}
+
+/* filterColumns
+ * Finds every row of one clothing type that matches a filter.
+ *
+ * Parameters:
+ *   columns    - columns to scan.
+ *   type       - ClothingType to scan.
+ *   filter     - conditions every returned row meets.
+ *   candidates - overwritten with the matching rows in ascending order; its
+ *                capacity is reused between calls.
+ *   kernel     - implementation to use; KERNEL_AUTO picks the fastest one.
+ *
+ * Returns:
+ *   Number of matching rows.
+ *
+ * Throws:
+ *   invalid_argument if the requested kernel is not supported here.
+ */
+size_t filterColumns(const ColumnarWardrobe& columns, uint8_t type, const ClothingFilter& filter,
+                     vector<uint32_t>& candidates, FilterKernel kernel) {
+    kernel = resolveKernel(kernel);
+    if (!filterKernelSupported(kernel))
+        throw invalid_argument(string("Filter kernel not supported: ") + filterKernelName(kernel));
+
+    const ClothingColumns& typed = columns.types[type];
+    CompiledFilter compiled;
+    compiled.length = filter.length;
+    compiled.isLong = typed.isLong.data();
+    auto addCheck = [&](const vector<AttributeId>& column, AttributeId value, bool equal) {
+        if (value != ATTRIBUTE_ANY) compiled.checks[compiled.checkCount++] = {column.data(), value, equal};
+    };
+    addCheck(typed.material, filter.material, true);
+    addCheck(typed.color, filter.color, true);
+    addCheck(typed.pattern, filter.pattern, true);
+    addCheck(typed.material, filter.notMaterial, false);
+    addCheck(typed.color, filter.notColor, false);
+    addCheck(typed.pattern, filter.notPattern, false);
+
+    //Size for the worst case and trim afterwards, so the kernels write without bounds checks
+    candidates.resize(typed.rows);
+    uint32_t* end = candidates.data();
+    switch (kernel) {
+#ifdef COLUMNS_AVX2
+    case KERNEL_AVX2: end = filterAvx2(compiled, typed.rows, end); break;
+#endif
+#ifdef COLUMNS_SSE2
+    case KERNEL_SSE2: end = filterSse2(compiled, typed.rows, end); break;
+#endif
+    default: end = filterScalar(compiled, 0, typed.rows, end); break;
+    }
+    candidates.resize(end - candidates.data());
+    return candidates.size();
+}
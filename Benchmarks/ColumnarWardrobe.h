@@ -0,0 +1,52 @@
+#ifndef COLUMNARWARDROBE_H
+#define COLUMNARWARDROBE_H
+
+#include "../Headers/OutfitPicker.h"
+
+using namespace std;
+
+// Never handed out by internAttribute, so it can stand for "no constraint"
+const AttributeId ATTRIBUTE_ANY = 0xFFFF;
+
+enum FilterKernel : uint8_t {
+    KERNEL_AUTO,        // best kernel the CPU supports
+    KERNEL_SCALAR,
+    KERNEL_SSE2,
+    KERNEL_AVX2
+};
+
+/* ClothingColumns
+ * One clothing type's items stored column by column; row i is the item at
+ * position i of the matching Wardrobe vector when the columns were built.
+ */
+struct ClothingColumns {
+    vector<AttributeId> material;
+    vector<AttributeId> color;
+    vector<AttributeId> pattern;
+    vector<uint64_t> isLong;        // bit i set when row i is long; one spare word past the end
+    size_t rows = 0;
+};
+
+// The type column is implicit: rows are grouped into one ClothingColumns per ClothingType
+struct ColumnarWardrobe {
+    ClothingColumns types[4];
+};
+
+// Predicate over one clothing type, e.g. long-sleeved, wool, not striped
+struct ClothingFilter {
+    uint8_t length = LENGTH_ANY;
+    AttributeId material = ATTRIBUTE_ANY;       // required value, or ATTRIBUTE_ANY
+    AttributeId color = ATTRIBUTE_ANY;
+    AttributeId pattern = ATTRIBUTE_ANY;
+    AttributeId notMaterial = ATTRIBUTE_ANY;    // excluded value, or ATTRIBUTE_ANY
+    AttributeId notColor = ATTRIBUTE_ANY;
+    AttributeId notPattern = ATTRIBUTE_ANY;
+};
+
+ColumnarWardrobe buildColumns(const Wardrobe& outfits);
+bool filterKernelSupported(FilterKernel kernel);
+const char* filterKernelName(FilterKernel kernel);
+size_t filterColumns(const ColumnarWardrobe& columns, uint8_t type, const ClothingFilter& filter,
+                     vector<uint32_t>& candidates, FilterKernel kernel = KERNEL_AUTO);
+
+#endif
@@ -0,0 +1,109 @@
+/* Nolan Pierce - Allocation Count Harness
+ *
+ * Overview:
+ *   Counts heap allocations per operation with the STAT_ALLOCATIONS counter
+ *   (Stats.cpp replaces the global operator new). Each cycle picks one outfit
+ *   with pickOutfit and washes it back with updateWardrobes, once for plain
+ *   random picks, once with weather preferences, once with rotation, and once
+ *   keeping a few items dirty. After
+ *   a warm-up that moves every item to dirty and back (so both wardrobes and
+ *   their indexes have room for everything) each of these should allocate
+ *   nothing; the exit code is 1 if one does. pickOutfits is shown for
+ *   reference, where the returned outfits are the one expected allocation.
+ *
+ * Usage:
+ *   allocBench [items = 10000] [cycles = 100000]
+ */
+#include "../Headers/OutfitPicker.h"
+#include "../Headers/Stats.h"
+#include "BenchUtil.h"
+#include <cstdio>
+#include <functional>
+
+using namespace std;
+
+#ifdef OUTFIT_NO_STATS
+#error "allocBench counts allocations through Stats.h; build it without OUTFIT_NO_STATS"
+#endif
+
+/* allocationsPer
+ * Runs an operation many times and returns the heap allocations per run.
+ */
+static double allocationsPer(size_t cycles, const function<void()>& operation) {
+    uint64_t before = statTotal(STAT_ALLOCATIONS);
+    for (size_t i = 0; i < cycles; i++) operation();
+    return double(statTotal(STAT_ALLOCATIONS) - before) / cycles;
+}
+
+int main(int argc, char** argv) {
+    size_t items = max<size_t>(100, argOr(argc, argv, 1, 10000));
+    size_t cycles = max<size_t>(1, argOr(argc, argv, 2, 100000));
+
+    Wardrobe outfits = randomWardrobe(items);
+    Wardrobe dirty;
+    Wardrobe none;
+    Wardrobe stay;
+    for (uint8_t type = TOP; type <= BOTTOM; type++) {
+        for (size_t i = 0; i < 4; i++) insertClothing(stay, getType(outfits, type)[i]);
+    }
+    vector<ClothingItem> worn;
+    vector<ClothingItem> washed;
+    worn.reserve(items);
+    washed.reserve(items);
+    PickOptions weather;
+    weather.length = LENGTH_LONG;
+    weather.avoidMaterials = {getType(outfits, TOP)[0].material};
+    PickOptions rotation;
+    rotation.rotation = true;
+    groupIndex(outfits);
+    rotationIndex(outfits);
+    seedPicker(1);
+
+    //pickOutfit prints every outfit; send it nowhere
+    FILE* discard = fopen("/dev/null", "w");
+    if (discard == nullptr) discard = fopen("NUL", "w");
+    if (discard != nullptr) standardOutput().setTarget(discard);
+    streambuf* console = cout.rdbuf(nullptr);
+
+    //Warm-up: every item visits dirty once, so every index entry and vector has its final size
+    updateWardrobes(outfits, dirty, none);
+    updateWardrobes(dirty, outfits, none);
+
+    auto cycle = [&](const PickOptions& options, const Wardrobe& keep) {
+        return [&] {
+            worn.clear();
+            washed.clear();
+            pickOutfit(outfits, dirty, options, &worn);
+            updateWardrobes(dirty, outfits, keep, &washed);
+        };
+    };
+    //Run each once before counting, e.g. so the thread's scratch block has grown
+    const char* names[] = {"pick + laundry", "weather pick + laundry", "rotation pick + laundry",
+                           "pick + laundry keeping 8"};
+    function<void()> operations[] = {cycle(PickOptions(), none), cycle(weather, none), cycle(rotation, none),
+                                     cycle(PickOptions(), stay)};
+    double counts[4];
+    for (size_t op = 0; op < 4; op++) {
+        operations[op]();
+        counts[op] = allocationsPer(cycles, operations[op]);
+    }
+    double batch = allocationsPer(cycles / 100 + 1, [&] {
+        PickResult result = pickOutfits(outfits, dirty, 4, PickOptions());
+        updateWardrobes(dirty, outfits, none);
+    });
+
+    cout.rdbuf(console);
+    standardOutput().setTarget(stdout);
+    if (discard != nullptr) fclose(discard);
+
+    bool clean = true;
+    printf("%zu items, %zu cycles each\n", items, cycles);
+    printf("%-28s %16s\n", "operation", "allocations/op");
+    for (size_t op = 0; op < 4; op++) {
+        printf("%-28s %16.3f\n", names[op], counts[op]);
+        clean = clean && counts[op] == 0;
+    }
+    printf("%-28s %16.3f  (the returned outfits)\n", "pickOutfits x4 + laundry", batch);
+    printf("%s\n", clean ? "OK: no allocations in steady state" : "FAIL: steady-state operations allocated");
+    return clean ? 0 : 1;
+}
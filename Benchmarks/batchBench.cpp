@@ -0,0 +1,40 @@
+/* Nolan Pierce - Batch Pick Benchmark
+ *
+ * Overview:
+ *   Measures outfits planned per second by pickOutfits on a single core, including
+ *   the bulk move of worn items into the dirty wardrobe.
+ *
+ * Usage:
+ *   batchBench [outfits = 1000000] [seed = 1]
+ */
+#include "../Headers/OutfitPicker.h"
+#include "../Headers/Random.h"
+#include "BenchUtil.h"
+#include <cstdio>
+
+using namespace std;
+
+int main(int argc, char** argv) {
+    size_t count = argOr(argc, argv, 1, 1000000);
+    Xoshiro256 rng(argOr(argc, argv, 2, 1));
+
+    //Roughly a quarter of the items land in each type, so this leaves spare tops, bottoms and jackets
+    Wardrobe outfits = randomWardrobe(count * 5);
+    Wardrobe dirty;
+
+    for (bool jacket : {false, true}) {
+        PickOptions options;
+        options.jacket = jacket;
+        size_t before = dirty.tops.size();
+
+        Stopwatch timer;
+        PickResult result = pickOutfits(outfits, dirty, count / 2, options, rng);
+        double seconds = timer.seconds();
+
+        printf("jacket=%-3s %10zu outfits %8.3f s %12.0f outfits/s%s\n", jacket ? "yes" : "no",
+               result.outfits.size(), seconds, result.outfits.size() / seconds,
+               result.ranDry ? " (ran dry)" : "");
+        if (dirty.tops.size() - before != result.outfits.size()) return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,224 @@
+/* Nolan Pierce - Benchmark Suite
+ *
+ * Overview:
+ *   Times the core wardrobe functions on generated wardrobes of growing size
+ *   and writes the results as JSON, so runs on different commits can be
+ *   compared by a script to catch regressions:
+ *     - loadDatabase of an outfits.csv, per item.
+ *     - pushDatabase of the loaded wardrobe, per item.
+ *     - pickOutfit, per outfit (console output discarded).
+ *     - removeClothing, per removal, answering its prompts from a script.
+ *     - updateWardrobes washing a dirtyLaundry.csv a quarter the size back in,
+ *       with 8 items kept dirty, per item.
+ *   Each measurement is repeated on a fresh copy of the wardrobe; the JSON has
+ *   the best and mean time of the runs. Files come from the seeded generator
+ *   (see generateWardrobe.cpp), so a seed always measures the same data.
+ *
+ * Usage:
+ *   outfitpicker_bench [maxItems = 1000000] [seed = 42] [json = bench_results.json]
+ *
+ *   Sizes go up by 10x from 1000 to maxItems.
+ */
+#include "../Headers/OutfitPicker.h"
+#include "../Headers/OutputBuffer.h"
+#include "../Headers/Random.h"
+#include "../Headers/Stats.h"
+#include "BenchUtil.h"
+#include <algorithm>
+#include <cstdio>
+#include <functional>
+#include <iostream>
+#include <sstream>
+
+using namespace std;
+
+const size_t SUITE_CARDINALITY = 24;
+
+// One timed function at one wardrobe size
+struct SuiteResult {
+    string name;
+    size_t items = 0;           // wardrobe size
+    size_t operations = 0;      // items or calls per run
+    size_t runs = 0;
+    double bestSeconds = 1e30;
+    double meanSeconds = 0;
+};
+
+/* measure
+ * Runs setup then the timed operation runs times and keeps the best and mean.
+ *
+ * Parameters:
+ *   setup     - untimed preparation before each run, e.g. copying the wardrobe.
+ *   operation - the timed work.
+ */
+static SuiteResult measure(const string& name, size_t items, size_t operations, size_t runs,
+                           const function<void()>& setup, const function<void()>& operation) {
+    SuiteResult result;
+    result.name = name;
+    result.items = items;
+    result.operations = operations;
+    result.runs = runs;
+    for (size_t run = 0; run < runs; run++) {
+        setup();
+        Stopwatch timer;
+        operation();
+        double seconds = timer.seconds();
+        result.bestSeconds = min(result.bestSeconds, seconds);
+        result.meanSeconds += seconds / runs;
+    }
+    printf("%-16s %9zu items %9zu ops %10.1f ns/op (best of %zu)\n", name.c_str(), items, operations,
+           result.bestSeconds / max<size_t>(operations, 1) * 1e9, runs);
+    return result;
+}
+
+/* removalScript
+ * Writes the answers removeClothing prompts for, one item after another.
+ */
+static string removalScript(const vector<ClothingItem>& items) {
+    vector<string_view> names = attributeTable();
+    string script;
+    for (const ClothingItem& item : items) {
+        script += typeName(item.type);
+        script += item.isLong ? "\nyes\n" : "\nno\n";
+        script += names[item.material];
+        script += '\n';
+        script += names[item.color];
+        script += '\n';
+        script += names[item.pattern];
+        script += '\n';
+    }
+    return script;
+}
+
+/* writeJson
+ * Saves the run's settings and results.
+ */
+static bool writeJson(const string& path, uint64_t seed, size_t maxItems, const vector<SuiteResult>& results) {
+    FILE* file = fopen(path.c_str(), "w");
+    if (file == nullptr) return false;
+#ifdef __VERSION__
+    const char* compiler = __VERSION__;
+#else
+    const char* compiler = "unknown";
+#endif
+#ifdef OUTFIT_STATS
+    const char* stats = "true";
+#else
+    const char* stats = "false";
+#endif
+    fprintf(file, "{\n  \"suite\": \"outfitpicker_bench\",\n  \"seed\": %llu,\n  \"cardinality\": %zu,\n"
+                  "  \"maxItems\": %zu,\n  \"compiler\": \"%s\",\n  \"stats\": %s,\n  \"results\": [\n",
+            (unsigned long long)seed, SUITE_CARDINALITY, maxItems, compiler, stats);
+    for (size_t i = 0; i < results.size(); i++) {
+        const SuiteResult& r = results[i];
+        fprintf(file,
+                "    {\"name\": \"%s\", \"items\": %zu, \"operations\": %zu, \"runs\": %zu, "
+                "\"bestSeconds\": %.9f, \"meanSeconds\": %.9f, \"nsPerOperation\": %.3f}%s\n",
+                r.name.c_str(), r.items, r.operations, r.runs, r.bestSeconds, r.meanSeconds,
+                r.bestSeconds / max<size_t>(r.operations, 1) * 1e9, i + 1 < results.size() ? "," : "");
+    }
+    fprintf(file, "  ]\n}\n");
+    return fclose(file) == 0;
+}
+
+int main(int argc, char** argv) {
+    size_t maxItems = max<size_t>(1000, argOr(argc, argv, 1, 1000000));
+    uint64_t seed = argOr(argc, argv, 2, 42);
+    string jsonPath = argc > 3 ? argv[3] : "bench_results.json";
+    string outfitsPath = "bench_suite_outfits.csv";
+    string dirtyPath = "bench_suite_dirty.csv";
+    string savePath = "bench_suite_saved.csv";
+
+    //The functions print as they go, and toLower warns about the digits in generated
+    //attribute names; send all of that nowhere and keep printf for the report
+    FILE* discard = fopen("/dev/null", "w");
+    if (discard == nullptr) discard = fopen("NUL", "w");
+    if (discard != nullptr) standardOutput().setTarget(discard);
+    streambuf* console = cout.rdbuf(nullptr);
+    streambuf* errors = cerr.rdbuf(nullptr);
+    streambuf* keyboard = cin.rdbuf();
+
+    vector<SuiteResult> results;
+    bool ok = true;
+    for (size_t items = 1000; items <= maxItems; items *= 10) {
+        generateWardrobeCsv(outfitsPath, items, SUITE_CARDINALITY, seed);
+        generateWardrobeCsv(dirtyPath, items / 4, SUITE_CARDINALITY, seed + 1);
+        //Small sizes repeat more, so every measurement takes a similar time
+        size_t runs = max<size_t>(3, min<size_t>(50, 1000000 / items));
+
+        Wardrobe base;
+        results.push_back(measure("loadDatabase", items, items, runs, [] {}, [&] { base = loadDatabase(outfitsPath); }));
+        Wardrobe baseDirty = loadDatabase(dirtyPath);
+        ok = ok && wardrobeSize(base) == items && wardrobeSize(baseDirty) == items / 4;
+
+        results.push_back(measure("pushDatabase", items, items, runs, [] {},
+                                  [&] { ok = pushDatabase(base, savePath) && ok; }));
+
+        Wardrobe outfits;
+        Wardrobe dirty;
+        size_t picks = max<size_t>(1, items / 8);
+        auto copyBase = [&] {
+            outfits = base;
+            dirty = baseDirty;
+            seedPicker(seed);
+        };
+        results.push_back(measure("pickOutfit", items, picks, runs, copyBase, [&] {
+            for (size_t i = 0; i < picks; i++) pickOutfit(outfits, dirty, false);
+        }));
+
+        //Removals draw distinct items actually in the wardrobe, so every prompt names a real item;
+        //removing one twice would find it gone and ask a suggestion question the script does not answer
+        vector<ClothingItem> targets;
+        Wardrobe chosen;
+        Xoshiro256 rng(seed);
+        size_t removals = max<size_t>(1, min<size_t>(1000, items / 10));
+        for (size_t i = 0; i < removals; i++) {
+            const vector<ClothingItem>& pool = getType(base, uint8_t(uniformIndex(rng, 4)));
+            if (pool.empty()) continue;
+            const ClothingItem& item = pool[uniformIndex(rng, pool.size())];
+            if (countClothing(chosen, item) > 0) continue;
+            insertClothing(chosen, item);
+            targets.push_back(item);
+        }
+        string script = removalScript(targets);
+        istringstream answers;
+        results.push_back(measure("removeClothing", items, targets.size(), runs,
+                                  [&] {
+                                      copyBase();
+                                      answers.str(script);
+                                      answers.clear();
+                                      cin.rdbuf(answers.rdbuf());
+                                  },
+                                  [&] {
+                                      for (size_t i = 0; i < targets.size(); i++) removeClothing(outfits, nullptr);
+                                  }));
+        cin.rdbuf(keyboard);
+
+        Wardrobe stay;
+        for (uint8_t type = JACKET; type <= SHOES; type++) {
+            const vector<ClothingItem>& pool = getType(baseDirty, type);
+            for (size_t i = 0; i < min<size_t>(2, pool.size()); i++) insertClothing(stay, pool[i]);
+        }
+        results.push_back(measure("updateWardrobes", items, wardrobeSize(baseDirty), runs, copyBase,
+                                  [&] { updateWardrobes(dirty, outfits, stay); }));
+        ok = ok && wardrobeSize(dirty) == wardrobeSize(stay);
+    }
+
+    cout.rdbuf(console);
+    cerr.rdbuf(errors);
+    cout.clear();
+    cerr.clear();
+    standardOutput().setTarget(stdout);
+    if (discard != nullptr) fclose(discard);
+    remove(outfitsPath.c_str());
+    remove(dirtyPath.c_str());
+    remove(savePath.c_str());
+
+    if (!writeJson(jsonPath, seed, maxItems, results)) {
+        fprintf(stderr, "Error: could not write %s\n", jsonPath.c_str());
+        return 1;
+    }
+    printf("results written to %s\n", jsonPath.c_str());
+    if (!ok) fprintf(stderr, "FAIL: a wardrobe did not have the expected number of items\n");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,149 @@
+/* Nolan Pierce - Outfit Cache Benchmark
+ *
+ * Overview:
+ *   Replays a skewed stream of best requests over many wardrobes, as the
+ *   service sees them: a few wardrobes get most requests, and now and then a
+ *   request adds an item to its wardrobe first, which must invalidate its plan.
+ *   The stream runs once through an OutfitCache and once without one, and the
+ *   report has the hit rate, the time of a hit and of a miss, and the speedup
+ *   of the whole stream. A second cached run with a cap of a tenth of the
+ *   plans' size shows the hit rate under evictions. Every cached answer must
+ *   match the uncached one; the exit code is 1 if any does not.
+ *
+ * Usage:
+ *   cacheBench [wardrobes = 200] [items = 500] [requests = 20000] [k = 5] [editPercent = 2] [seed = 42]
+ */
+#include "../Headers/OutfitCache.h"
+#include "../Headers/Random.h"
+#include "BenchUtil.h"
+#include <algorithm>
+#include <cstdio>
+
+using namespace std;
+
+// One request of the stream: an optional edit, then a best query
+struct CacheRequest {
+    size_t wardrobe;
+    bool jacket;
+    bool edit;
+    ClothingItem added;
+};
+
+/* randomRules
+ * Rules between the attr0..attrN values randomWardrobe uses, with mixed signs.
+ */
+static StyleRules randomRules(size_t count, size_t cardinality, Xoshiro256& rng) {
+    static const char* kinds[] = {"color", "pattern", "material"};
+    string text;
+    for (size_t i = 0; i < count; i++) {
+        text += kinds[uniformIndex(rng, 3)];
+        text += ",attr" + to_string(uniformIndex(rng, cardinality));
+        text += i % 7 == 0 ? string(",*") : ",attr" + to_string(uniformIndex(rng, cardinality));
+        text += "," + to_string(int(uniformIndex(rng, 11)) - 5) + "\n";
+    }
+    return parseStyleRules(text);
+}
+
+/* sameOutfits
+ * Compares two answers by score and garments.
+ */
+static bool sameOutfits(const vector<ScoredOutfit>& a, const vector<ScoredOutfit>& b) {
+    if (a.size() != b.size()) return false;
+    for (size_t i = 0; i < a.size(); i++) {
+        if (a[i].score != b[i].score || !(a[i].outfit.top == b[i].outfit.top) ||
+            !(a[i].outfit.bottom == b[i].outfit.bottom) || !(a[i].outfit.shoes == b[i].outfit.shoes) ||
+            a[i].outfit.hasJacket != b[i].outfit.hasJacket || (a[i].outfit.hasJacket && !(a[i].outfit.jacket == b[i].outfit.jacket)))
+            return false;
+    }
+    return true;
+}
+
+/* replay
+ * Runs the stream on fresh copies of the wardrobes, with or without a cache.
+ *
+ * Returns:
+ *   Seconds spent in bestOutfits; answers holds the result of every request.
+ */
+static double replay(const vector<Wardrobe>& base, const vector<CacheRequest>& stream, const StyleRules& rules,
+                     size_t k, OutfitCache* cache, vector<vector<ScoredOutfit>>& answers) {
+    vector<Wardrobe> wardrobes = base;
+    answers.assign(stream.size(), {});
+    double seconds = 0;
+    for (size_t i = 0; i < stream.size(); i++) {
+        const CacheRequest& request = stream[i];
+        Wardrobe& outfits = wardrobes[request.wardrobe];
+        if (request.edit) insertClothing(outfits, request.added);
+        PickOptions options;
+        options.jacket = request.jacket;
+        Stopwatch timer;
+        answers[i] = cache ? bestOutfits(outfits, rules, k, options, *cache) : bestOutfits(outfits, rules, k, options);
+        seconds += timer.seconds();
+    }
+    return seconds;
+}
+
+/* report
+ * Prints one cached run against the uncached one.
+ */
+static void report(const char* name, const OutfitCacheStats& stats, double seconds, double uncached) {
+    uint64_t lookups = max<uint64_t>(1, stats.hits + stats.misses);
+    printf("%-14s %6.1f%% hits %9.0f ns/hit %9.0f ns/miss %8llu evictions %8.1f KiB %7.2fx\n", name,
+           100.0 * stats.hits / lookups, stats.hitSeconds / max<uint64_t>(1, stats.hits) * 1e9,
+           stats.missSeconds / max<uint64_t>(1, stats.misses) * 1e9, (unsigned long long)stats.evictions,
+           stats.bytes / 1024.0, uncached / seconds);
+}
+
+int main(int argc, char** argv) {
+    size_t wardrobeCount = max<size_t>(1, argOr(argc, argv, 1, 200));
+    size_t items = max<size_t>(4, argOr(argc, argv, 2, 500));
+    size_t requests = argOr(argc, argv, 3, 20000);
+    size_t k = max<size_t>(1, argOr(argc, argv, 4, 5));
+    size_t editPercent = argOr(argc, argv, 5, 2);
+    uint64_t seed = argOr(argc, argv, 6, 42);
+    const size_t cardinality = 24;
+
+    Xoshiro256 rng(seed);
+    StyleRules rules = randomRules(60, cardinality, rng);
+    vector<Wardrobe> wardrobes;
+    for (size_t i = 0; i < wardrobeCount; i++) wardrobes.push_back(randomWardrobe(items, cardinality, seed + i));
+
+    //Cubing a uniform draw sends about half the requests to the first eighth of the wardrobes
+    Wardrobe extras = randomWardrobe(requests, cardinality, seed - 1);
+    vector<ClothingItem> pool;
+    for (uint8_t type = JACKET; type <= SHOES; type++) {
+        const vector<ClothingItem>& items = getType(extras, type);
+        pool.insert(pool.end(), items.begin(), items.end());
+    }
+    vector<CacheRequest> stream;
+    for (size_t i = 0; i < requests; i++) {
+        double u = double(uniformIndex(rng, 1 << 20)) / (1 << 20);
+        CacheRequest request{};
+        request.wardrobe = min(wardrobeCount - 1, size_t(u * u * u * wardrobeCount));
+        request.jacket = uniformIndex(rng, 4) == 0;
+        request.edit = uniformIndex(rng, 100) < editPercent;
+        request.added = pool[i % pool.size()];
+        stream.push_back(request);
+    }
+
+    vector<vector<ScoredOutfit>> expected;
+    double uncached = replay(wardrobes, stream, rules, k, nullptr, expected);
+    printf("%zu wardrobes of %zu items, %zu requests, k = %zu, %zu%% edits\n", wardrobeCount, items, requests, k,
+           editPercent);
+    printf("%-14s %9.0f ns/request\n", "uncached", uncached / max<size_t>(1, requests) * 1e9);
+
+    bool same = true;
+    vector<vector<ScoredOutfit>> answers;
+    OutfitCache cache(size_t(1) << 40);
+    double cached = replay(wardrobes, stream, rules, k, &cache, answers);
+    for (size_t i = 0; i < requests; i++) same = same && sameOutfits(answers[i], expected[i]);
+    OutfitCacheStats unlimited = cache.stats();
+    report("cached", unlimited, cached, uncached);
+
+    OutfitCache small(max<size_t>(1, unlimited.bytes / 10));
+    double capped = replay(wardrobes, stream, rules, k, &small, answers);
+    for (size_t i = 0; i < requests; i++) same = same && sameOutfits(answers[i], expected[i]);
+    report("capped (1/10)", small.stats(), capped, uncached);
+
+    printf("%s\n", same ? "cached answers match" : "FAIL: a cached answer differs from bestOutfits");
+    return same ? 0 : 1;
+}
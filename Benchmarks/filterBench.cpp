@@ -0,0 +1,69 @@
+/* Nolan Pierce - Filter Benchmark
+ *
+ * Overview:
+ *   Times filterColumns over a random wardrobe (10M items by default) for each
+ *   kernel the CPU supports, next to a plain loop over the Wardrobe's item
+ *   structs, and checks that every kernel returns the same rows.
+ *   The filter is "long, one material, not one pattern" on tops.
+ *
+ * Usage:
+ *   filterBench [items = 10000000] [rounds = 5]
+ */
+#include "ColumnarWardrobe.h"
+#include "BenchUtil.h"
+#include <cstdio>
+
+using namespace std;
+
+int main(int argc, char** argv) {
+    size_t items = argOr(argc, argv, 1, 10000000);
+    size_t rounds = argOr(argc, argv, 2, 5);
+    Wardrobe outfits = randomWardrobe(items, 8);
+    ColumnarWardrobe columns = buildColumns(outfits);
+
+    ClothingFilter filter;
+    filter.length = LENGTH_LONG;
+    filter.material = internAttribute("attr1");
+    filter.notPattern = internAttribute("attr2");
+    size_t scanned = outfits.tops.size();
+
+    //Baseline: the same predicate over the array of structs
+    vector<uint32_t> expected;
+    double structBest = 1e30;
+    for (size_t round = 0; round < rounds; round++) {
+        Stopwatch timer;
+        expected.clear();
+        for (size_t row = 0; row < outfits.tops.size(); row++) {
+            const ClothingItem& item = outfits.tops[row];
+            if (item.isLong && item.material == filter.material && item.pattern != filter.notPattern)
+                expected.push_back(uint32_t(row));
+        }
+        structBest = min(structBest, timer.seconds());
+    }
+
+    printf("%10s %10s %12s %12s %10s\n", "kernel", "rows", "matches", "Mrows/s", "GB/s");
+    printf("%10s %10zu %12zu %12.1f %10.2f\n", "structs", scanned, expected.size(),
+           scanned / structBest / 1e6, scanned * sizeof(ClothingItem) / structBest / 1e9);
+
+    const FilterKernel kernels[] = {KERNEL_SCALAR, KERNEL_SSE2, KERNEL_AVX2};
+    vector<uint32_t> candidates;
+    for (FilterKernel kernel : kernels) {
+        if (!filterKernelSupported(kernel)) {
+            printf("%10s %10s\n", filterKernelName(kernel), "unsupported");
+            continue;
+        }
+        double best = 1e30;
+        for (size_t round = 0; round < rounds; round++) {
+            Stopwatch timer;
+            filterColumns(columns, TOP, filter, candidates, kernel);
+            best = min(best, timer.seconds());
+        }
+        //Bytes touched: material and pattern columns plus the isLong bits
+        double bytes = scanned * (2 * sizeof(AttributeId) + 1.0 / 8);
+        printf("%10s %10zu %12zu %12.1f %10.2f%s\n", filterKernelName(kernel), scanned, candidates.size(),
+               scanned / best / 1e6, bytes / best / 1e9, candidates == expected ? "" : "  MISMATCH");
+        if (candidates != expected) return 1;
+    }
+
+    return 0;
+}
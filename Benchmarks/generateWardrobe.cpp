@@ -0,0 +1,38 @@
+/* Nolan Pierce - Synthetic Wardrobe Generator
+ *
+ * Overview:
+ *   Writes a synthetic outfits.csv and dirtyLaundry.csv pair of any size and
+ *   attribute cardinality, for benchmarks and for trying the program on a
+ *   large wardrobe. The same arguments always write byte-identical files.
+ *
+ * Usage:
+ *   generateWardrobe [rows = 1000] [dirtyRows = rows / 4] [cardinality = 24] [seed = 42] [dir = .]
+ *
+ *   Point the program at the result with --outfits DIR/outfits.csv --dirty DIR/dirtyLaundry.csv.
+ */
+#include "BenchUtil.h"
+#include <algorithm>
+#include <cstdio>
+
+using namespace std;
+
+int main(int argc, char** argv) {
+    size_t rows = argOr(argc, argv, 1, 1000);
+    size_t dirtyRows = argOr(argc, argv, 2, rows / 4);
+    size_t cardinality = max<size_t>(1, argOr(argc, argv, 3, 24));
+    uint64_t seed = argOr(argc, argv, 4, 42);
+    string dir = argc > 5 ? argv[5] : ".";
+
+    //The dirty file gets the next seed, so the two files do not repeat each other
+    string outfitsPath = dir + "/outfits.csv";
+    string dirtyPath = dir + "/dirtyLaundry.csv";
+    size_t outfitsBytes = generateWardrobeCsv(outfitsPath, rows, cardinality, seed);
+    size_t dirtyBytes = generateWardrobeCsv(dirtyPath, dirtyRows, cardinality, seed + 1);
+    if ((rows > 0 && outfitsBytes == 0) || (dirtyRows > 0 && dirtyBytes == 0)) {
+        fprintf(stderr, "Error: could not write to %s\n", dir.c_str());
+        return 1;
+    }
+    printf("%s: %zu items, %.1f MB\n", outfitsPath.c_str(), rows, outfitsBytes / 1e6);
+    printf("%s: %zu items, %.1f MB\n", dirtyPath.c_str(), dirtyRows, dirtyBytes / 1e6);
+    return 0;
+}
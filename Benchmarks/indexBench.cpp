@@ -0,0 +1,72 @@
+/* Nolan Pierce - Index Benchmark
+ *
+ * Overview:
+ *   Times laundry reconciliation (updateWardrobes) and item lookups from 1k to 10M
+ *   dirty items, with 10% of the pile left unwashed. Time per item should stay flat
+ *   as the wardrobe grows. The original find-based updateVectors is timed alongside
+ *   for sizes where its quadratic cost is still bearable.
+ *
+ * Usage:
+ *   indexBench [maxItems = 10000000] [legacyLimit = 100000]
+ */
+#include "../Headers/OutfitPicker.h"
+#include "BenchUtil.h"
+#include <algorithm>
+#include <cstdio>
+
+using namespace std;
+
+/* legacyUpdateVectors
+ * The original linear-scan reconciliation, kept here as the baseline.
+ */
+static void legacyUpdateVectors(vector<ClothingItem>& src, vector<ClothingItem>& dest, const vector<ClothingItem>& stay) {
+    for (size_t i = 0; i < src.size(); i++) {
+        if (find(stay.begin(), stay.end(), src[i]) == stay.end()) dest.push_back(src[i]);
+    }
+    if (!src.empty()) src = stay;
+}
+
+int main(int argc, char** argv) {
+    size_t maxItems = argOr(argc, argv, 1, 10000000);
+    size_t legacyLimit = argOr(argc, argv, 2, 100000);
+
+    printf("%10s %14s %14s %14s\n", "items", "update ns/item", "lookup ns/item", "legacy ns/item");
+    for (size_t items = 1000; items <= maxItems; items *= 10) {
+        Wardrobe dirty = randomWardrobe(items);
+        Wardrobe clean;
+        Wardrobe unwashed;
+        for (uint8_t type = JACKET; type <= SHOES; type++) {
+            const vector<ClothingItem>& pile = getType(dirty, type);
+            for (size_t i = 0; i < pile.size(); i += 10) insertClothing(unwashed, pile[i]);
+        }
+
+        Stopwatch timer;
+        size_t found = 0;
+        for (uint8_t type = JACKET; type <= SHOES; type++) {
+            for (const ClothingItem& item : getType(dirty, type)) found += countClothing(unwashed, item) > 0;
+        }
+        double lookupSeconds = timer.seconds();
+
+        Wardrobe legacyDirty = dirty;
+        timer.reset();
+        updateWardrobes(dirty, clean, unwashed);
+        double updateSeconds = timer.seconds();
+
+        double legacySeconds = 0;
+        if (items <= legacyLimit) {
+            Wardrobe legacyClean;
+            timer.reset();
+            legacyUpdateVectors(legacyDirty.shoes, legacyClean.shoes, unwashed.shoes);
+            legacyUpdateVectors(legacyDirty.bottoms, legacyClean.bottoms, unwashed.bottoms);
+            legacyUpdateVectors(legacyDirty.tops, legacyClean.tops, unwashed.tops);
+            legacyUpdateVectors(legacyDirty.jackets, legacyClean.jackets, unwashed.jackets);
+            legacySeconds = timer.seconds();
+        }
+
+        printf("%10zu %14.1f %14.1f ", items, updateSeconds * 1e9 / items, lookupSeconds * 1e9 / items);
+        if (legacySeconds > 0) printf("%14.1f\n", legacySeconds * 1e9 / items);
+        else printf("%14s\n", "-");
+        if (found < items / 10) return 1;       //every unwashed item must have been found
+    }
+    return 0;
+}
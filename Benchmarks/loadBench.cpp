@@ -0,0 +1,56 @@
+/* Nolan Pierce - Load Benchmark
+ *
+ * Overview:
+ *   Compares the memory-mapped loadDatabase against the original getline/substr/erase
+ *   loader on a generated outfits.csv.
+ *
+ * Usage:
+ *   loadBench [rows = 10000000] [path = bench_outfits.csv]
+ */
+#include "../Headers/OutfitPicker.h"
+#include "BenchUtil.h"
+#include <cstdio>
+
+using namespace std;
+
+static bool sameItems(const vector<LegacyClothingItem>& legacy, const vector<ClothingItem>& packed) {
+    if (legacy.size() != packed.size()) return false;
+    for (size_t i = 0; i < legacy.size(); i++) {
+        if (legacy[i].type != typeName(packed[i].type) || legacy[i].isLong != packed[i].isLong ||
+            legacy[i].material != attributeName(packed[i].material) ||
+            legacy[i].color != attributeName(packed[i].color) ||
+            legacy[i].pattern != attributeName(packed[i].pattern)) return false;
+    }
+    return true;
+}
+
+static bool sameWardrobe(const LegacyWardrobe& a, const Wardrobe& b) {
+    return sameItems(a.jackets, b.jackets) && sameItems(a.tops, b.tops) &&
+           sameItems(a.bottoms, b.bottoms) && sameItems(a.shoes, b.shoes);
+}
+
+int main(int argc, char** argv) {
+    size_t rows = argOr(argc, argv, 1, 10000000);
+    string path = argc > 2 ? argv[2] : "bench_outfits.csv";
+
+    printf("Generating %zu rows into %s...\n", rows, path.c_str());
+    size_t bytes = generateWardrobeCsv(path, rows);
+
+    Stopwatch timer;
+    LegacyWardrobe legacy = legacyLoadDatabase(path);
+    double legacySeconds = timer.seconds();
+
+    timer.reset();
+    Wardrobe mapped = loadDatabase(path);
+    double mappedSeconds = timer.seconds();
+
+    printf("%-10s %10.3f s %12.0f rows/s %8.1f MB/s\n", "legacy", legacySeconds,
+           rows / legacySeconds, bytes / legacySeconds / 1e6);
+    printf("%-10s %10.3f s %12.0f rows/s %8.1f MB/s\n", "mapped", mappedSeconds,
+           rows / mappedSeconds, bytes / mappedSeconds / 1e6);
+    printf("speedup: %.2fx, identical: %s\n", legacySeconds / mappedSeconds,
+           sameWardrobe(legacy, mapped) ? "yes" : "NO");
+
+    remove(path.c_str());
+    return sameWardrobe(legacy, mapped) ? 0 : 1;
+}
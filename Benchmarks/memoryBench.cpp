@@ -0,0 +1,45 @@
+/* Nolan Pierce - Memory Benchmark
+ *
+ * Overview:
+ *   Measures the resident size of a large wardrobe stored as packed, interned
+ *   ClothingItems against the original layout of one std::string per attribute.
+ *
+ * Usage:
+ *   memoryBench [rows = 10000000] [path = bench_memory.csv]
+ */
+#include "../Headers/OutfitPicker.h"
+#include "BenchUtil.h"
+#include <cstdio>
+
+using namespace std;
+
+int main(int argc, char** argv) {
+    size_t rows = argOr(argc, argv, 1, 10000000);
+    string path = argc > 2 ? argv[2] : "bench_memory.csv";
+
+    printf("Generating %zu rows into %s...\n", rows, path.c_str());
+    generateWardrobeCsv(path, rows);
+
+    //Packed layout is measured first so the legacy run cannot leave freed pages behind for it
+    size_t before = residentBytes();
+    size_t packedBytes = 0;
+    {
+        Wardrobe packed = loadDatabase(path);
+        packedBytes = residentBytes() - before;
+        printf("%-8s %8.1f MB resident, %3zu bytes/item, %zu distinct attributes\n", "packed",
+               packedBytes / 1e6, sizeof(ClothingItem), attributeCount());
+    }
+
+    before = residentBytes();
+    size_t legacyBytes = 0;
+    {
+        LegacyWardrobe legacy = legacyLoadDatabase(path);
+        legacyBytes = residentBytes() - before;
+        printf("%-8s %8.1f MB resident, %3zu bytes/item\n", "legacy", legacyBytes / 1e6,
+               sizeof(LegacyClothingItem));
+    }
+
+    printf("reduction: %.1fx\n", packedBytes ? double(legacyBytes) / packedBytes : 0.0);
+    remove(path.c_str());
+    return 0;
+}
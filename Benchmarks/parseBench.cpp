@@ -0,0 +1,70 @@
+/* Nolan Pierce - Parallel Parse Benchmark
+ *
+ * Overview:
+ *   Parses a generated outfits.csv with parseDatabase on a pool of 1 to N
+ *   threads and reports load throughput in GB/s next to the single-threaded
+ *   parseDatabase. Every run must produce the same items, in the same order
+ *   and with the same AttributeIds, as the single-threaded parse. The time of
+ *   rebuildIndex alone is shown for reference; the parallel parse indexes the
+ *   4 clothing types on up to 4 threads.
+ *
+ * Usage:
+ *   parseBench [rows = 20000000] [maxThreads = hardware threads] [path = bench_parse.csv]
+ */
+#include "../Headers/ParallelParse.h"
+#include "../Headers/MappedFile.h"
+#include "BenchUtil.h"
+#include <cstdio>
+#include <thread>
+
+using namespace std;
+
+static bool sameItems(const Wardrobe& a, const Wardrobe& b) {
+    for (uint8_t type = JACKET; type <= SHOES; type++) {
+        const vector<ClothingItem>& left = getType(a, type);
+        const vector<ClothingItem>& right = getType(b, type);
+        if (left.size() != right.size()) return false;
+        for (size_t i = 0; i < left.size(); i++) {
+            if (!(left[i] == right[i]) || left[i].wearCount != right[i].wearCount ||
+                left[i].lastWorn != right[i].lastWorn) return false;
+        }
+    }
+    return true;
+}
+
+int main(int argc, char** argv) {
+    size_t rows = argOr(argc, argv, 1, 20000000);
+    size_t maxThreads = max<size_t>(1, argOr(argc, argv, 2, thread::hardware_concurrency()));
+    string path = argc > 3 ? argv[3] : "bench_parse.csv";
+
+    printf("Generating %zu rows into %s...\n", rows, path.c_str());
+    size_t bytes = generateWardrobeCsv(path, rows);
+    MappedFile file(path);
+    string_view contents = file.view();
+
+    Stopwatch timer;
+    Wardrobe expected = parseDatabase(contents);
+    double sequential = timer.seconds();
+    timer.reset();
+    rebuildIndex(expected);
+    double indexSeconds = timer.seconds();
+    printf("%.1f MB; rebuildIndex alone %.3f s\n", bytes / 1e6, indexSeconds);
+    printf("%-12s %10s %10s %10s %10s\n", "threads", "seconds", "GB/s", "speedup", "identical");
+    printf("%-12s %10.3f %10.3f %10s %10s\n", "sequential", sequential, bytes / sequential / 1e9, "1.00x", "-");
+
+    bool identical = true;
+    for (size_t threads = 1;; threads = min(threads * 2, maxThreads)) {
+        ThreadPool pool(threads);
+        timer.reset();
+        Wardrobe parsed = parseDatabase(contents, pool);
+        double seconds = timer.seconds();
+        bool same = sameItems(expected, parsed);
+        identical = identical && same;
+        printf("%-12zu %10.3f %10.3f %9.2fx %10s\n", threads, seconds, bytes / seconds / 1e9, sequential / seconds,
+               same ? "yes" : "NO");
+        if (threads == maxThreads) break;
+    }
+
+    remove(path.c_str());
+    return identical ? 0 : 1;
+}
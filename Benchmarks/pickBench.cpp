@@ -0,0 +1,47 @@
+/* Nolan Pierce - Pick Benchmark
+ *
+ * Overview:
+ *   Measures picks per second of pickNremove against wardrobe size, next to the
+ *   original rand() % size plus vector::erase approach. The swap-and-pop path should
+ *   stay flat while the erase path slows down in proportion to the vector length.
+ *
+ * Usage:
+ *   pickBench [maxItems = 10000000] [seed = 1]
+ */
+#include "../Headers/OutfitPicker.h"
+#include "../Headers/Random.h"
+#include "BenchUtil.h"
+#include <cstdio>
+#include <cstdlib>
+
+using namespace std;
+
+int main(int argc, char** argv) {
+    size_t maxItems = argOr(argc, argv, 1, 10000000);
+    seedPicker(argOr(argc, argv, 2, 1));
+
+    printf("%10s %16s %16s\n", "items", "picks/s", "legacy picks/s");
+    for (size_t items = 1000; items <= maxItems; items *= 10) {
+        Wardrobe outfits = randomWardrobe(items);
+        vector<ClothingItem> legacyTops = outfits.tops;
+        size_t picks = outfits.tops.size() / 2;
+
+        Stopwatch timer;
+        uint64_t checksum = 0;
+        for (size_t i = 0; i < picks; i++) checksum += pickNremove(outfits, TOP).color;
+        double pickSeconds = timer.seconds();
+
+        size_t legacyPicks = min<size_t>(picks, 2000);
+        timer.reset();
+        for (size_t i = 0; i < legacyPicks; i++) {
+            int index = rand() % legacyTops.size();
+            checksum += legacyTops[index].color;
+            legacyTops.erase(legacyTops.begin() + index);
+        }
+        double legacySeconds = timer.seconds();
+
+        printf("%10zu %16.0f %16.0f\n", items, picks / pickSeconds, legacyPicks / legacySeconds);
+        if (checksum == 0) printf("(checksum %llu)\n", (unsigned long long)checksum);
+    }
+    return 0;
+}
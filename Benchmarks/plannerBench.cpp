@@ -0,0 +1,65 @@
+/* Nolan Pierce - Planner Benchmark
+ *
+ * Overview:
+ *   Measures accounts planned per second by planOutfits from 1 to N threads, and
+ *   checks every thread count produces exactly the same outfits for the same seed.
+ *
+ * Usage:
+ *   plannerBench [accounts = 100000] [itemsPerAccount = 200] [maxThreads = hardware cores]
+ */
+#include "../Headers/OutfitPlanner.h"
+#include "BenchUtil.h"
+#include <cstdio>
+#include <thread>
+
+using namespace std;
+
+/* fingerprint
+ * Folds every planned outfit into one number to compare runs.
+ */
+static uint64_t fingerprint(const vector<PickResult>& results) {
+    uint64_t hash = 1469598103934665603ULL;
+    for (const auto& result : results) {
+        for (const auto& outfit : result.outfits) {
+            for (const ClothingItem* item : {&outfit.top, &outfit.bottom, &outfit.shoes, &outfit.jacket})
+                hash = (hash ^ clothingKey(*item)) * 1099511628211ULL;
+        }
+    }
+    return hash;
+}
+
+int main(int argc, char** argv) {
+    size_t accountCount = argOr(argc, argv, 1, 100000);
+    size_t itemsPerAccount = argOr(argc, argv, 2, 200);
+    size_t maxThreads = argOr(argc, argv, 3, max(1u, thread::hardware_concurrency()));
+
+    vector<WardrobePair> accounts(accountCount);
+    for (size_t i = 0; i < accountCount; i++) accounts[i].outfits = randomWardrobe(itemsPerAccount, 24, i);
+
+    PickOptions options;
+    options.jacket = true;
+    uint64_t expected = 0;
+    double baseline = 0;
+    printf("%8s %14s %10s %12s\n", "threads", "accounts/s", "speedup", "fingerprint");
+    for (size_t threads = 1; threads <= maxThreads; threads *= 2) {
+        vector<WardrobePair> work = accounts;
+        ThreadPool pool(threads);
+
+        Stopwatch timer;
+        vector<PickResult> results = planOutfits(work, 7, options, 2024, pool);
+        double rate = accountCount / timer.seconds();
+
+        uint64_t print = fingerprint(results);
+        if (threads == 1) {
+            expected = print;
+            baseline = rate;
+        }
+        printf("%8zu %14.0f %9.2fx %12llx\n", threads, rate, rate / baseline, (unsigned long long)print);
+        if (print != expected) {
+            printf("Results differ from the single-threaded run!\n");
+            return 1;
+        }
+        if (threads < maxThreads && threads * 2 > maxThreads) threads = maxThreads / 2;      //always finish on maxThreads
+    }
+    return 0;
+}
@@ -0,0 +1,76 @@
+/* Nolan Pierce - Print Benchmark
+ *
+ * Overview:
+ *   Times printWardrobe against the original cout/endl printer, in items per second.
+ *   Both write to stdout, which is redirected to the null device so only the
+ *   formatting and syscall cost is measured. Results go to stderr.
+ *
+ * Usage:
+ *   printBench [items = 1000000] [rounds = 3]
+ */
+#include "../Headers/OutfitPicker.h"
+#include "BenchUtil.h"
+#include <cstdio>
+
+using namespace std;
+
+/* legacyPrintWardrobe
+ * The original printer: every field through cout, one endl flush per item.
+ */
+static void legacyPrintWardrobe(const Wardrobe& outfits) {
+    static const char* headings[] = {"\nJackets: \n", "\nTops: \n", "\nBottoms: \n", "\nShoes: \n"};
+    vector<string_view> names = attributeTable();
+    for (uint8_t type = JACKET; type <= SHOES; type++) {
+        cout << headings[type];
+        for (const auto& item : getType(outfits, type)) {
+            cout << "       Type: " << typeName(item.type)
+                 << ", Is Long: " << (item.isLong ? "Yes" : "No")
+                 << ", Material: " << names[item.material]
+                 << ", Color: " << names[item.color]
+                 << ", Pattern: " << names[item.pattern] << endl;
+        }
+    }
+}
+
+int main(int argc, char** argv) {
+    size_t items = argOr(argc, argv, 1, 1000000);
+    size_t rounds = argOr(argc, argv, 2, 3);
+    Wardrobe outfits = randomWardrobe(items);
+
+#ifdef _WIN32
+    const char* nullDevice = "NUL";
+#else
+    const char* nullDevice = "/dev/null";
+#endif
+    if (freopen(nullDevice, "w", stdout) == nullptr) {
+        fprintf(stderr, "Could not redirect stdout to %s\n", nullDevice);
+        return 1;
+    }
+
+    //Best of several rounds, so a cold page cache or a busy machine does not skew one side
+    double legacyBest = 1e30, prettyBest = 1e30, compactBest = 1e30, tsvBest = 1e30;
+    for (size_t round = 0; round < rounds; round++) {
+        Stopwatch timer;
+        legacyPrintWardrobe(outfits);
+        legacyBest = min(legacyBest, timer.seconds());
+
+        timer.reset();
+        printWardrobe(outfits);
+        prettyBest = min(prettyBest, timer.seconds());
+
+        timer.reset();
+        printWardrobe(outfits, OUTPUT_COMPACT);
+        compactBest = min(compactBest, timer.seconds());
+
+        timer.reset();
+        printWardrobe(outfits, OUTPUT_TSV);
+        tsvBest = min(tsvBest, timer.seconds());
+    }
+
+    fprintf(stderr, "%10s %16s %16s %16s %16s\n", "items", "legacy items/s", "pretty items/s",
+            "compact items/s", "tsv items/s");
+    fprintf(stderr, "%10zu %16.0f %16.0f %16.0f %16.0f\n", items, items / legacyBest, items / prettyBest,
+            items / compactBest, items / tsvBest);
+    fprintf(stderr, "pretty speedup over legacy: %.1fx\n", legacyBest / prettyBest);
+    return 0;
+}
@@ -0,0 +1,87 @@
+/* Nolan Pierce - Rotation Benchmark
+ *
+ * Overview:
+ *   Measures the cost of a least-recently-worn pick against wardrobe size. Each
+ *   step picks one outfit with PickOptions::rotation and washes it straight back,
+ *   so the wardrobe keeps its size while every item's history keeps changing.
+ *   The time per pick should grow with log2(items), not with items; the original
+ *   approach of sorting the tops by wear history before each pick is shown next
+ *   to it for the smaller sizes.
+ *
+ * Usage:
+ *   rotationBench [maxItems = 10000000] [picks = 200000]
+ */
+#include "../Headers/OutfitPicker.h"
+#include "BenchUtil.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+using namespace std;
+
+/* washBack
+ * Returns every dirty item to the clean wardrobe.
+ */
+static void washBack(Wardrobe& dirty, Wardrobe& outfits) {
+    for (uint8_t type = JACKET; type <= SHOES; type++) {
+        while (!getType(dirty, type).empty()) {
+            insertClothing(outfits, eraseClothingAt(dirty, type, getType(dirty, type).size() - 1));
+        }
+    }
+}
+
+int main(int argc, char** argv) {
+    size_t maxItems = argOr(argc, argv, 1, 10000000);
+    size_t picks = argOr(argc, argv, 2, 200000);
+
+    printf("%10s %12s %12s %14s %16s\n", "items", "build ms", "ns/pick", "ns/pick/log2n", "sorted ns/pick");
+    for (size_t items = 1000; items <= maxItems; items *= 10) {
+        Wardrobe outfits = randomWardrobe(items);
+        Wardrobe dirty;
+        PickOptions options;
+        options.rotation = true;
+        options.day = 0;
+
+        Stopwatch timer;
+        rotationIndex(outfits);
+        double buildSeconds = timer.seconds();
+
+        //Check the first picks against a full scan before timing
+        size_t mismatches = 0;
+        for (size_t i = 0; i < 100; i++, options.day++) {
+            ClothingItem oldest = *min_element(outfits.tops.begin(), outfits.tops.end(), wornBefore);
+            Outfit outfit = pickOutfits(outfits, dirty, 1, options).outfits.front();
+            ClothingItem nextOldest = *min_element(outfits.tops.begin(), outfits.tops.end(), wornBefore);
+            mismatches += oldest.wearCount + 1 != outfit.top.wearCount || wornBefore(nextOldest, oldest);
+            washBack(dirty, outfits);
+        }
+
+        timer.reset();
+        uint64_t checksum = 0;
+        for (size_t i = 0; i < picks; i++, options.day++) {
+            checksum += pickOutfits(outfits, dirty, 1, options).outfits.front().top.color;
+            washBack(dirty, outfits);
+        }
+        double pickNs = timer.seconds() * 1e9 / picks;
+
+        //Baseline: sort the tops by wear history and take the first, on every pick
+        char sorted[32] = "-";
+        if (items <= 100000) {
+            vector<ClothingItem> tops = outfits.tops;
+            size_t sortedPicks = max<size_t>(10, 2000000 / items);
+            timer.reset();
+            for (size_t i = 0; i < sortedPicks; i++) {
+                sort(tops.begin(), tops.end(), wornBefore);
+                tops.front().wearCount++;
+                tops.front().lastWorn = int32_t(options.day + i);
+                checksum += tops.front().color;
+            }
+            snprintf(sorted, sizeof(sorted), "%.0f", timer.seconds() * 1e9 / sortedPicks);
+        }
+
+        printf("%10zu %12.2f %12.0f %14.1f %16s%s\n", items, buildSeconds * 1e3, pickNs,
+               pickNs / log2(double(items)), sorted, mismatches ? "  MISMATCH" : "");
+        if (checksum == 0) printf("(checksum %llu)\n", (unsigned long long)checksum);
+    }
+    return 0;
+}
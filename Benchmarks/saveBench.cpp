@@ -0,0 +1,142 @@
+/* Nolan Pierce - Save Benchmark
+ *
+ * Overview:
+ *   Runs pick + laundry cycles on a generated wardrobe and saves both
+ *   snapshots every few cycles, the way compaction did: written, fsynced and
+ *   renamed in on the same thread ("sync"), or handed to a SnapshotWriter
+ *   ("async"). Reports the p50, p99 and worst cycle time of each next to
+ *   cycles that never save, so the cost saving adds to picking shows directly.
+ *   A burst of back-to-back saves then shows how many are written. The files
+ *   left by the async run are loaded back and must hold the final wardrobes;
+ *   the exit code is 1 if they do not.
+ *
+ * Usage:
+ *   saveBench [items = 100000] [cycles = 2000] [saveEvery = 100] [burst = 1000]
+ */
+#include "../Headers/SnapshotWriter.h"
+#include "../Headers/DurableFile.h"
+#include "BenchUtil.h"
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <functional>
+
+using namespace std;
+
+/* syncSave
+ * Saves both snapshots on the calling thread, as Journal::compact does.
+ */
+static bool syncSave(const Wardrobe& outfits, const Wardrobe& dirty, const string& outfitsPath,
+                     const string& dirtyPath) {
+    string outfitsNew = newSnapshotPath(outfitsPath);
+    string dirtyNew = newSnapshotPath(dirtyPath);
+    return pushDatabase(outfits, outfitsNew) && pushDatabase(dirty, dirtyNew) && syncFile(outfitsNew) &&
+           syncFile(dirtyNew) && replaceFile(outfitsNew, outfitsPath) && replaceFile(dirtyNew, dirtyPath);
+}
+
+/* runCycles
+ * Times pick + laundry cycles on fresh copies of the wardrobes, calling save
+ * after every saveEvery of them (inside the timed cycle).
+ *
+ * Returns:
+ *   Cycle times in microseconds, sorted; outfits and dirty hold the final wardrobes.
+ */
+static vector<double> runCycles(Wardrobe& outfits, Wardrobe& dirty, size_t cycles, size_t saveEvery,
+                                const function<void(const Wardrobe&, const Wardrobe&)>& save) {
+    Wardrobe none;
+    vector<double> micros;
+    seedPicker(1);
+    for (size_t i = 0; i < cycles; i++) {
+        Stopwatch timer;
+        pickOutfit(outfits, dirty, PickOptions());
+        if (i % 3 == 2) updateWardrobes(dirty, outfits, none);
+        if (save && (i + 1) % saveEvery == 0) save(outfits, dirty);
+        micros.push_back(timer.seconds() * 1e6);
+    }
+    sort(micros.begin(), micros.end());
+    return micros;
+}
+
+/* report
+ * Prints one run's cycle times.
+ */
+static void report(const char* name, const vector<double>& micros) {
+    printf("%-10s %10.1f %10.1f %12.1f\n", name, micros[micros.size() / 2], micros[micros.size() * 99 / 100],
+           micros.back());
+}
+
+int main(int argc, char** argv) {
+    size_t items = max<size_t>(100, argOr(argc, argv, 1, 100000));
+    size_t cycles = max<size_t>(1, argOr(argc, argv, 2, 2000));
+    size_t saveEvery = max<size_t>(1, argOr(argc, argv, 3, 100));
+    size_t burst = max<size_t>(1, argOr(argc, argv, 4, 1000));
+    filesystem::create_directories("bench_save");
+    string outfitsPath = "bench_save/outfits.csv";
+    string dirtyPath = "bench_save/dirtyLaundry.csv";
+    Wardrobe base = randomWardrobe(items);
+
+    //pickOutfit prints every outfit; send it nowhere
+    FILE* discard = fopen("/dev/null", "w");
+    if (discard == nullptr) discard = fopen("NUL", "w");
+    if (discard != nullptr) standardOutput().setTarget(discard);
+    streambuf* console = cout.rdbuf(nullptr);
+
+    Wardrobe outfits = base;
+    Wardrobe dirty;
+    vector<double> none = runCycles(outfits, dirty, cycles, saveEvery, nullptr);
+
+    outfits = base;
+    dirty = Wardrobe();
+    vector<double> sync = runCycles(outfits, dirty, cycles, saveEvery, [&](const Wardrobe& a, const Wardrobe& b) {
+        syncSave(a, b, outfitsPath, dirtyPath);
+    });
+
+    outfits = base;
+    dirty = Wardrobe();
+    //Switched in with the same two renames as syncSave, so both runs do the same I/O
+    SnapshotWriter writer(outfitsPath, dirtyPath, [&](bool written) {
+        return written && replaceFile(newSnapshotPath(outfitsPath), outfitsPath) &&
+               replaceFile(newSnapshotPath(dirtyPath), dirtyPath);
+    });
+    vector<double> async = runCycles(outfits, dirty, cycles, saveEvery,
+                                     [&](const Wardrobe& a, const Wardrobe& b) { writer.save(a, b); });
+    Stopwatch barrier;
+    bool durable = writer.flush();
+    double barrierMs = barrier.seconds() * 1e3;
+    SnapshotWriterStats cycleStats = writer.stats();
+
+    cout.rdbuf(console);
+    standardOutput().setTarget(stdout);
+    if (discard != nullptr) fclose(discard);
+
+    //The snapshots on disk are the state at the last save
+    Wardrobe savedOutfits = loadDatabase(outfitsPath);
+    Wardrobe savedDirty = loadDatabase(dirtyPath);
+    bool same = durable && wardrobeSize(savedOutfits) == wardrobeSize(outfits) &&
+                wardrobeSize(savedDirty) == wardrobeSize(dirty);
+    for (uint8_t type = JACKET; type <= SHOES && same; type++) {
+        same = getType(savedOutfits, type) == getType(outfits, type) && getType(savedDirty, type) == getType(dirty, type);
+    }
+
+    //Back-to-back saves: each one waiting replaces the last, so few are written
+    Stopwatch burstTimer;
+    for (size_t i = 0; i < burst; i++) writer.save(outfits, dirty);
+    double burstUs = burstTimer.seconds() / burst * 1e6;
+    writer.flush();
+    SnapshotWriterStats burstStats = writer.stats();
+
+    printf("%zu items, %zu pick + laundry cycles, a save every %zu\n", items, cycles, saveEvery);
+    printf("%-10s %10s %10s %12s\n", "saving", "p50 us", "p99 us", "max us");
+    report("none", none);
+    report("sync", sync);
+    report("async", async);
+    printf("async: %llu saves, %llu written, %.1f ms barrier at the end\n", (unsigned long long)cycleStats.saves,
+           (unsigned long long)cycleStats.writes, barrierMs);
+    printf("burst: %zu saves at %.1f us each, %llu written\n", burst, burstUs,
+           (unsigned long long)(burstStats.writes - cycleStats.writes));
+    printf("%s\n", same ? "saved snapshots match the wardrobes" : "FAIL: saved snapshots differ from the wardrobes");
+
+    error_code error;
+    filesystem::remove_all("bench_save", error);
+    return same ? 0 : 1;
+}
@@ -0,0 +1,143 @@
+/* Nolan Pierce - Score Benchmark
+ *
+ * Overview:
+ *   Times bestOutfits on a wardrobe of 1k tops, 1k bottoms and 200 shoes (and
+ *   200 jackets for the jacket run), using the sample rules from
+ *   Other Files/styleRules.csv. A smaller wardrobe is also scored by brute force
+ *   with scoreOutfit to check that the pruned search finds the same best scores.
+ *
+ * Usage:
+ *   scoreBench [tops = 1000] [bottoms = 1000] [shoes = 200] [k = 10] [cardinality = 24]
+ */
+#include "../Headers/OutfitScorer.h"
+#include "BenchUtil.h"
+#include <algorithm>
+#include <cstdio>
+
+using namespace std;
+
+static const char* SAMPLE_RULES =
+    "color,black,white,3\ncolor,navy,white,3\ncolor,blue,white,2\ncolor,blue,cream,2\n"
+    "color,grey,black,2\ncolor,grey,blue,2\ncolor,brown,cream,2\ncolor,brown,blue,1\n"
+    "color,black,black,1\ncolor,red,green,-4\ncolor,brown,black,-1\npattern,solid,*,1\n"
+    "pattern,striped,striped,-3\npattern,striped,plaid,-5\npattern,plaid,plaid,-4\n"
+    "pattern,floral,striped,-3\nmaterial,denim,denim,-2\nmaterial,leather,cotton,1\n"
+    "material,wool,silk,1\nmaterial,rubber,silk,-2\n";
+
+/* styledWardrobe
+ * Builds a wardrobe whose attributes use the words the sample rules know about,
+ * plus numbered variants of them once cardinality exceeds the word lists.
+ */
+static Wardrobe styledWardrobe(const size_t counts[4], size_t cardinality, uint64_t seed) {
+    static const char* materials[] = {"cotton", "wool", "synthetic", "silk", "denim", "leather", "linen", "rubber"};
+    static const char* colors[] = {"black", "white", "grey", "blue", "navy", "cream", "brown", "green", "red"};
+    static const char* patterns[] = {"solid", "striped", "plaid", "plain", "checked", "floral"};
+    auto makePool = [&](const char* const* words, size_t count) {
+        vector<AttributeId> pool;
+        for (size_t i = 0; i < cardinality; i++)
+            pool.push_back(internAttribute(i < count ? string(words[i]) : words[i % count] + to_string(i / count)));
+        return pool;
+    };
+    vector<AttributeId> materialPool = makePool(materials, 8);
+    vector<AttributeId> colorPool = makePool(colors, 9);
+    vector<AttributeId> patternPool = makePool(patterns, 6);
+
+    Wardrobe outfits;
+    mt19937_64 rng(seed);
+    for (uint8_t type = JACKET; type <= SHOES; type++) {
+        for (size_t i = 0; i < counts[type]; i++) {
+            uint64_t r = rng();
+            ClothingItem item;
+            item.type = type;
+            item.isLong = r & 1;
+            item.material = materialPool[(r >> 8) % cardinality];
+            item.color = colorPool[(r >> 24) % cardinality];
+            item.pattern = patternPool[(r >> 40) % cardinality];
+            insertClothing(outfits, item);
+        }
+    }
+    return outfits;
+}
+
+/* distinctStyles
+ * Keeps the first item of each material/color/pattern combination, as bestOutfits does.
+ */
+static vector<ClothingItem> distinctStyles(const vector<ClothingItem>& items) {
+    vector<ClothingItem> styles;
+    for (const auto& item : items) {
+        bool seen = false;
+        for (const auto& style : styles) {
+            seen |= style.material == item.material && style.color == item.color && style.pattern == item.pattern;
+        }
+        if (!seen) styles.push_back(item);
+    }
+    return styles;
+}
+
+/* bruteForceScores
+ * Scores every combination of distinct styles with scoreOutfit and returns the k best scores.
+ */
+static vector<int> bruteForceScores(const Wardrobe& outfits, const StyleRules& rules, size_t k) {
+    vector<int> scores;
+    Outfit outfit{};
+    for (const auto& top : distinctStyles(outfits.tops)) {
+        outfit.top = top;
+        for (const auto& bottom : distinctStyles(outfits.bottoms)) {
+            outfit.bottom = bottom;
+            for (const auto& shoes : distinctStyles(outfits.shoes)) {
+                outfit.shoes = shoes;
+                scores.push_back(scoreOutfit(rules, outfit));
+            }
+        }
+    }
+    k = min(k, scores.size());
+    partial_sort(scores.begin(), scores.begin() + k, scores.end(), greater<int>());
+    scores.resize(k);
+    return scores;
+}
+
+int main(int argc, char** argv) {
+    size_t counts[4] = {argOr(argc, argv, 3, 200), argOr(argc, argv, 1, 1000), argOr(argc, argv, 2, 1000),
+                        argOr(argc, argv, 3, 200)};
+    size_t k = argOr(argc, argv, 4, 10);
+    size_t cardinality = argOr(argc, argv, 5, 24);
+    StyleRules rules = parseStyleRules(SAMPLE_RULES);
+
+    //Correctness on a wardrobe small enough to enumerate
+    size_t smallCounts[4] = {0, 60, 60, 20};
+    Wardrobe small = styledWardrobe(smallCounts, cardinality, 1);
+    vector<int> expected = bruteForceScores(small, rules, k);
+    vector<int> found;
+    for (const auto& scored : bestOutfits(small, rules, k, PickOptions())) {
+        found.push_back(scored.score);
+        if (scoreOutfit(rules, scored.outfit) != scored.score) {
+            printf("Score mismatch for a returned outfit\n");
+            return 1;
+        }
+    }
+    printf("brute-force check on 60x60x20: %s\n", found == expected ? "ok" : "MISMATCH");
+    if (found != expected) return 1;
+
+    Wardrobe outfits = styledWardrobe(counts, cardinality, 42);
+    printf("%8s %8s %8s %8s %4s %10s %10s\n", "tops", "bottoms", "shoes", "jackets", "k", "best", "ms");
+    for (bool jacket : {false, true}) {
+        PickOptions options;
+        options.jacket = jacket;
+        double best = 1e30;
+        vector<ScoredOutfit> result;
+        for (int round = 0; round < 5; round++) {
+            Stopwatch timer;
+            result = bestOutfits(outfits, rules, k, options);
+            best = min(best, timer.seconds());
+        }
+        for (const auto& scored : result) {
+            if (scoreOutfit(rules, scored.outfit) != scored.score) {
+                printf("Score mismatch for a returned outfit\n");
+                return 1;
+            }
+        }
+        printf("%8zu %8zu %8zu %8zu %4zu %10d %10.2f\n", counts[TOP], counts[BOTTOM], counts[SHOES],
+               jacket ? counts[JACKET] : 0, k, result.empty() ? 0 : result.front().score, best * 1000);
+    }
+    return 0;
+}
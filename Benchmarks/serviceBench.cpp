@@ -0,0 +1,117 @@
+/* Nolan Pierce - Service Load Generator
+ *
+ * Overview:
+ *   Drives the wardrobe service with several concurrent clients, each on its
+ *   own connection sending one request at a time for a random user, and
+ *   reports requests per second and p50/p99/p999 latency. The mix is 60% pick,
+ *   20% laundry, 10% add and 10% list of the dirty clothes.
+ *
+ *   Without a socket path the service runs in this process on a scratch data
+ *   directory (bench_service/), with journal fsyncs per request only when sync is 1.
+ *
+ * Usage:
+ *   serviceBench [clients = 4] [requests = 100000] [users = 64] [sync = 0] [socket]
+ */
+#include "../Headers/WardrobeService.h"
+#include "BenchUtil.h"
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <thread>
+
+using namespace std;
+
+int main(int argc, char** argv) {
+    size_t clients = max<size_t>(1, argOr(argc, argv, 1, 4));
+    size_t requests = argOr(argc, argv, 2, 100000);
+    size_t users = max<size_t>(1, argOr(argc, argv, 3, 64));
+    bool sync = argOr(argc, argv, 4, 0) != 0;
+    string socketPath = argc > 5 ? argv[5] : "bench_service.sock";
+
+    //Run our own service unless pointed at one
+    ServiceOptions options;
+    options.socketPath = socketPath;
+    options.dataDir = "bench_service";
+    options.syncEachRequest = sync;
+    unique_ptr<WardrobeService> service;
+    thread serving;
+    if (argc <= 5) {
+        error_code error;
+        filesystem::remove_all(options.dataDir, error);
+        service = make_unique<WardrobeService>(options);
+        if (!service->listen()) return 1;
+        serving = thread([&] { service->serve(); });
+    }
+
+    //Give every user 100 items of each type, in one add request each
+    {
+        ServiceClient client;
+        if (!client.connect(socketPath)) {
+            fprintf(stderr, "Could not connect to %s\n", socketPath.c_str());
+            return 1;
+        }
+        vector<string> response;
+        for (size_t user = 0; user < users; user++) {
+            string request = "user" + to_string(user) + "\tadd";
+            for (size_t i = 0; i < 100; i++) {
+                for (const char* type : {"jacket", "top", "bottom", "shoes"}) {
+                    request += string("\t") + type + (i % 2 ? ",true," : ",false,") + "cotton,color" +
+                               to_string(i % 9) + ",pattern" + to_string(i % 5);
+                }
+            }
+            client.request(request, response);
+        }
+    }
+
+    vector<vector<double>> latencies(clients);
+    vector<size_t> failures(clients, 0);
+    Stopwatch wall;
+    vector<thread> threads;
+    for (size_t c = 0; c < clients; c++) {
+        threads.emplace_back([&, c] {
+            ServiceClient client;
+            if (!client.connect(socketPath)) {
+                failures[c] = requests / clients;
+                return;
+            }
+            mt19937_64 rng(c + 1);
+            vector<string> response;
+            latencies[c].reserve(requests / clients);
+            for (size_t i = 0; i < requests / clients; i++) {
+                uint64_t r = rng();
+                string request = "user" + to_string(r % users);
+                switch ((r >> 32) % 10) {
+                    case 0: case 1: request += "\tlaundry\tall"; break;
+                    case 2: request += "\tadd\ttop,false,linen,white,solid"; break;
+                    case 3: request += "\tlist\tlaundry"; break;
+                    default: request += "\tpick\tjacket"; break;
+                }
+                Stopwatch timer;
+                bool ok = client.request(request, response) && response.front().compare(0, 3, "OK ") == 0;
+                latencies[c].push_back(timer.seconds());
+                failures[c] += !ok;
+            }
+        });
+    }
+    for (auto& thread : threads) thread.join();
+    double seconds = wall.seconds();
+
+    vector<double> all;
+    size_t failed = 0;
+    for (size_t c = 0; c < clients; c++) {
+        all.insert(all.end(), latencies[c].begin(), latencies[c].end());
+        failed += failures[c];
+    }
+    sort(all.begin(), all.end());
+    auto percentile = [&](double p) { return all.empty() ? 0.0 : all[min(all.size() - 1, size_t(p * all.size()))] * 1e6; };
+    printf("%zu clients, %zu users, sync %s: %zu requests in %.2f s, %.0f requests/s, %zu failed\n", clients, users,
+           sync ? "on" : "off", all.size(), seconds, all.size() / seconds, failed);
+    printf("latency us: p50 %.1f  p99 %.1f  p999 %.1f  max %.1f\n", percentile(0.50), percentile(0.99),
+           percentile(0.999), all.empty() ? 0.0 : all.back() * 1e6);
+
+    if (service) {
+        service->stop();
+        serving.join();
+    }
+    return 0;
+}
@@ -0,0 +1,64 @@
+/* Nolan Pierce - Snapshot Benchmark
+ *
+ * Overview:
+ *   Compares start-up cost of a large wardrobe stored as CSV against the binary
+ *   snapshot format: opening a read-only SnapshotView in place, and loading the
+ *   snapshot into an editable Wardrobe, whose positions index is only built on
+ *   the first lookup by item (timed separately).
+ *
+ * Usage:
+ *   snapshotBench [rows = 10000000] [path = bench_snapshot]
+ */
+#include "../Headers/OutfitPicker.h"
+#include "../Headers/Snapshot.h"
+#include "BenchUtil.h"
+#include <cstdio>
+
+using namespace std;
+
+int main(int argc, char** argv) {
+    size_t rows = argOr(argc, argv, 1, 10000000);
+    string base = argc > 2 ? argv[2] : "bench_snapshot";
+    string csvPath = base + ".csv";
+    string binPath = base + ".bin";
+
+    printf("Generating %zu rows into %s...\n", rows, csvPath.c_str());
+    generateWardrobeCsv(csvPath, rows);
+
+    Stopwatch timer;
+    Wardrobe fromCsv = loadDatabase(csvPath);
+    double csvSeconds = timer.seconds();
+
+    timer.reset();
+    pushDatabase(fromCsv, binPath);
+    double writeSeconds = timer.seconds();
+
+    timer.reset();
+    SnapshotView view;
+    bool opened = view.open(binPath);
+    uint64_t checksum = 0;
+    for (uint8_t type = JACKET; type <= SHOES; type++) checksum += view.count(type);
+    double viewSeconds = timer.seconds();
+
+    timer.reset();
+    Wardrobe fromBin = loadDatabase(binPath);
+    double binSeconds = timer.seconds();
+
+    timer.reset();
+    keyIndex(fromBin);
+    double keySeconds = timer.seconds();
+
+    bool same = opened && checksum == rows;
+    for (uint8_t type = JACKET; type <= SHOES; type++) same = same && getType(fromCsv, type) == getType(fromBin, type);
+
+    printf("%-24s %10.3f ms\n", "CSV load", csvSeconds * 1e3);
+    printf("%-24s %10.3f ms\n", "snapshot write", writeSeconds * 1e3);
+    printf("%-24s %10.3f ms\n", "snapshot view (in place)", viewSeconds * 1e3);
+    printf("%-24s %10.3f ms\n", "snapshot -> Wardrobe", binSeconds * 1e3);
+    printf("%-24s %10.3f ms\n", "first lookup (keyIndex)", keySeconds * 1e3);
+    printf("identical: %s, remapped: %s\n", same ? "yes" : "NO", view.needsRemap() ? "yes" : "no");
+
+    remove(csvPath.c_str());
+    remove(binPath.c_str());
+    return same ? 0 : 1;
+}
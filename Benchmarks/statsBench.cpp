@@ -0,0 +1,95 @@
+/* Nolan Pierce - Instrumentation Overhead Benchmark
+ *
+ * Overview:
+ *   Times the instrumented hot paths: a pick + laundry cycle (one pickOutfit
+ *   and the updateWardrobes that washes it back), parsing a generated CSV, and
+ *   saving it again. Build it twice, as is and with -DOUTFIT_NO_STATS, and
+ *   compare the two runs; the counters should cost well under 2%. With stats
+ *   compiled in, the totals are printed as a check that they count, and then
+ *   the instrumentation one cycle runs is timed on its own.
+ *
+ * Usage:
+ *   statsBench [items = 10000] [cycles = 1000000] [rows = 1000000]
+ */
+#include "../Headers/OutfitPicker.h"
+#include "../Headers/Stats.h"
+#include "BenchUtil.h"
+#include <algorithm>
+#include <cstdio>
+#include <iostream>
+
+using namespace std;
+
+int main(int argc, char** argv) {
+    size_t items = max<size_t>(100, argOr(argc, argv, 1, 10000));
+    size_t cycles = max<size_t>(1, argOr(argc, argv, 2, 1000000));
+    size_t rows = max<size_t>(1, argOr(argc, argv, 3, 1000000));
+#ifdef OUTFIT_STATS
+    printf("stats compiled in\n");
+#else
+    printf("stats compiled out (OUTFIT_NO_STATS)\n");
+#endif
+
+    Wardrobe outfits = randomWardrobe(items);
+    Wardrobe dirty;
+    Wardrobe none;
+    vector<ClothingItem> worn;
+    worn.reserve(items);
+    seedPicker(1);
+
+    //pickOutfit prints every outfit; send it nowhere
+    FILE* discard = fopen("/dev/null", "w");
+    if (discard == nullptr) discard = fopen("NUL", "w");
+    if (discard != nullptr) standardOutput().setTarget(discard);
+    streambuf* console = cout.rdbuf(nullptr);
+    //Best of five rounds, so a scheduler hiccup does not decide the comparison
+    double best = 1e30;
+    for (int round = 0; round < 5; round++) {
+        Stopwatch timer;
+        for (size_t i = 0; i < cycles / 5; i++) {
+            worn.clear();
+            pickOutfit(outfits, dirty, false, &worn);
+            updateWardrobes(dirty, outfits, none);
+        }
+        best = min(best, timer.seconds());
+    }
+    cout.rdbuf(console);
+    standardOutput().setTarget(stdout);
+    if (discard != nullptr) fclose(discard);
+    double cycleNs = best / (cycles / 5) * 1e9;
+    printf("%-22s %10.1f ns/cycle\n", "pick + laundry", cycleNs);
+
+    string path = "bench_stats.csv";
+    size_t bytes = generateWardrobeCsv(path, rows);
+    Stopwatch parseTimer;
+    Wardrobe loaded = loadDatabase(path);
+    double parseSeconds = parseTimer.seconds();
+    printf("%-22s %10.1f MB/s\n", "loadDatabase", bytes / parseSeconds / 1e6);
+    Stopwatch saveTimer;
+    bool saved = pushDatabase(loaded, path);
+    double saveSeconds = saveTimer.seconds();
+    printf("%-22s %10.1f MB/s\n", "pushDatabase", bytes / saveSeconds / 1e6);
+    remove(path.c_str());
+
+#ifdef OUTFIT_STATS
+    writeStats(stdout, false);
+    bool counted = statTotal(STAT_PICKS) >= cycles / 5 * 5 && statTotal(STAT_ITEMS_PARSED) >= rows;
+
+    //Runs far apart are too noisy to show a 1% difference, so price what a cycle adds directly:
+    //two timed scopes (pick, laundry) and five counters (picks, four comparisons)
+    Stopwatch costTimer;
+    for (size_t i = 0; i < cycles; i++) {
+        {
+            STAT_SCOPE(TIMER_PICK);
+            STAT_ADD(STAT_PICKS, 1);
+        }
+        STAT_SCOPE(TIMER_LAUNDRY);
+        for (int t = 0; t < 4; t++) STAT_ADD(STAT_COMPARISONS, 2);
+    }
+    double costNs = costTimer.seconds() / cycles * 1e9;
+    printf("%-22s %10.1f ns/cycle (%.2f%% of a cycle)\n", "instrumentation", costNs, 100 * costNs / cycleNs);
+    return saved && counted ? 0 : 1;
+#else
+    return saved ? 0 : 1;
+#endif
+}
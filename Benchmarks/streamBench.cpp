@@ -0,0 +1,100 @@
+/* Nolan Pierce - Streaming Import Benchmark
+ *
+ * Overview:
+ *   Streams a generated outfits.csv far larger than the read budget through
+ *   streamDatabase, collecting per-type counts, the share of long items and
+ *   a reservoir sample of 8 items per type, and reports throughput and the
+ *   growth of resident memory during the pass. The same pass with the
+ *   smallest budget (a refill every few lines) must see exactly the same
+ *   items and sample, and loadDatabase of the whole file is run afterwards
+ *   for its memory growth and to check the counts.
+ *
+ * Usage:
+ *   streamBench [rows = 10000000] [budget = 65536] [path = bench_stream.csv]
+ */
+#include "../Headers/WardrobeStream.h"
+#include "BenchUtil.h"
+#include <algorithm>
+#include <cstdio>
+
+using namespace std;
+
+// One pass: counts, long items and a sample per type, and the highest resident size seen
+struct PassResult {
+    StreamSummary summary;
+    uint64_t longItems = 0;
+    vector<ClothingItem> sample[4];
+    size_t peakResident = 0;
+    double seconds = 0;
+};
+
+static PassResult streamPass(const string& path, size_t budget) {
+    PassResult pass;
+    ClothingReservoir reservoir(8);
+    Xoshiro256 rng(7);
+    uint64_t seen = 0;
+    ClothingHandlers handlers;
+    for (uint8_t type = JACKET; type <= SHOES; type++) {
+        handlers.byType[type] = [&](const ClothingItem& item) {
+            pass.longItems += item.isLong;
+            reservoir.offer(item, rng);
+            if (++seen % (1 << 20) == 0) pass.peakResident = max(pass.peakResident, residentBytes());
+        };
+    }
+    Stopwatch timer;
+    streamDatabase(path, handlers, budget, &pass.summary);
+    pass.seconds = timer.seconds();
+    pass.peakResident = max(pass.peakResident, residentBytes());
+    for (uint8_t type = JACKET; type <= SHOES; type++) pass.sample[type] = reservoir.sample(type);
+    return pass;
+}
+
+static bool samePass(const PassResult& a, const PassResult& b) {
+    for (uint8_t type = JACKET; type <= SHOES; type++) {
+        if (a.summary.items[type] != b.summary.items[type] || a.sample[type].size() != b.sample[type].size()) return false;
+        if (!equal(a.sample[type].begin(), a.sample[type].end(), b.sample[type].begin())) return false;
+    }
+    return a.longItems == b.longItems && a.summary.skipped == b.summary.skipped;
+}
+
+int main(int argc, char** argv) {
+    size_t rows = argOr(argc, argv, 1, 10000000);
+    size_t budget = argOr(argc, argv, 2, 65536);
+    string path = argc > 3 ? argv[3] : "bench_stream.csv";
+
+    printf("Generating %zu rows into %s...\n", rows, path.c_str());
+    size_t bytes = generateWardrobeCsv(path, rows);
+    printf("file %.1f MB, budget %zu bytes (%.0fx smaller)\n", bytes / 1e6, budget, double(bytes) / budget);
+
+    size_t baseline = residentBytes();
+    PassResult streamed = streamPass(path, budget);
+    uint64_t total = streamed.summary.items[JACKET] + streamed.summary.items[TOP] + streamed.summary.items[BOTTOM] +
+                     streamed.summary.items[SHOES];
+    printf("%-22s %8.3f s %8.1f MB/s  resident +%.2f MB\n", "stream", streamed.seconds, bytes / streamed.seconds / 1e6,
+           (streamed.peakResident - min(baseline, streamed.peakResident)) / 1e6);
+    printf("  %llu items: %llu jackets, %llu tops, %llu bottoms, %llu shoes; %.1f%% long; %llu skipped\n",
+           (unsigned long long)total, (unsigned long long)streamed.summary.items[JACKET],
+           (unsigned long long)streamed.summary.items[TOP], (unsigned long long)streamed.summary.items[BOTTOM],
+           (unsigned long long)streamed.summary.items[SHOES], total ? 100.0 * streamed.longItems / total : 0.0,
+           (unsigned long long)streamed.summary.skipped);
+
+    PassResult tiny = streamPass(path, STREAM_MIN_BUDGET);
+    bool sameTiny = samePass(streamed, tiny);
+    printf("%-22s %8.3f s %8.1f MB/s  identical: %s\n", "stream, 256-byte budget", tiny.seconds,
+           bytes / tiny.seconds / 1e6, sameTiny ? "yes" : "NO");
+
+    baseline = residentBytes();
+    Stopwatch timer;
+    Wardrobe loaded = loadDatabase(path);
+    double loadSeconds = timer.seconds();
+    size_t loadedResident = residentBytes();
+    bool sameCounts = true;
+    for (uint8_t type = JACKET; type <= SHOES; type++)
+        sameCounts = sameCounts && getType(loaded, type).size() == streamed.summary.items[type];
+    printf("%-22s %8.3f s %8.1f MB/s  resident +%.2f MB  same counts: %s\n", "loadDatabase", loadSeconds,
+           bytes / loadSeconds / 1e6, (loadedResident - min(baseline, loadedResident)) / 1e6,
+           sameCounts ? "yes" : "NO");
+
+    remove(path.c_str());
+    return sameTiny && sameCounts && total == rows ? 0 : 1;
+}
@@ -0,0 +1,134 @@
+/* Nolan Pierce - Suggestion Benchmark
+ *
+ * Overview:
+ *   Times suggestClothing on wardrobes from 10k to maxItems items. Each query
+ *   is a real item of the wardrobe with one field mistyped (a letter changed,
+ *   dropped, added or swapped, or the word cut short), as a user would type it
+ *   in removeClothing. Reports the p50, p99 and worst query time, how often
+ *   the intended item is among the 5 suggestions, and the time of one
+ *   insert + erase with the index built. A few queries are also answered by
+ *   scanning every item, as the prompts did before, for comparison.
+ *   Each size is run twice: with cardinality distinct values per field, and
+ *   with HIGH_CARDINALITY, where most kinds have one or two items and the
+ *   search goes through the per-value kind lists.
+ *
+ * Usage:
+ *   suggestBench [maxItems = 1000000] [queries = 2000] [cardinality = 40] [seed = 42]
+ */
+#include "../Headers/ClothingSearch.h"
+#include "../Headers/Random.h"
+#include "BenchUtil.h"
+#include <algorithm>
+#include <cstdio>
+
+using namespace std;
+
+// Distinct values per field of the second run of each size
+static const size_t HIGH_CARDINALITY = 500;
+
+/* mistype
+ * Makes one typing mistake in a word.
+ */
+static string mistype(string word, Xoshiro256& rng) {
+    size_t at = uniformIndex(rng, word.size());
+    switch (uniformIndex(rng, 5)) {
+        case 0: word[at] = char('a' + uniformIndex(rng, 26)); break;
+        case 1: if (word.size() > 1) word.erase(at, 1); break;
+        case 2: word.insert(at, 1, char('a' + uniformIndex(rng, 26))); break;
+        case 3: if (at + 1 < word.size()) swap(word[at], word[at + 1]); break;
+        default: word.resize(max<size_t>(2, at)); break;
+    }
+    return word;
+}
+
+/* scanClosest
+ * The closest item by scanning every item and comparing its strings, for reference.
+ */
+static unsigned scanClosest(const Wardrobe& outfits, const ClothingItem& typed, const vector<string_view>& names) {
+    unsigned best = ~0u;
+    for (uint8_t type = JACKET; type <= SHOES; type++) {
+        for (const auto& item : getType(outfits, type)) {
+            unsigned distance = (item.type == typed.type ? 0 : TYPE_MISMATCH_COST) +
+                                (item.isLong == typed.isLong ? 0 : LENGTH_MISMATCH_COST) +
+                                attributeDistance(names[typed.material], names[item.material], SUGGEST_MAX_DISTANCE) +
+                                attributeDistance(names[typed.color], names[item.color], SUGGEST_MAX_DISTANCE) +
+                                attributeDistance(names[typed.pattern], names[item.pattern], SUGGEST_MAX_DISTANCE);
+            best = min(best, distance);
+        }
+    }
+    return best;
+}
+
+int main(int argc, char** argv) {
+    size_t maxItems = max<size_t>(10000, argOr(argc, argv, 1, 1000000));
+    size_t queries = max<size_t>(1, argOr(argc, argv, 2, 2000));
+    size_t cardinality = max<size_t>(1, argOr(argc, argv, 3, 40));
+    uint64_t seed = argOr(argc, argv, 4, 42);
+    string path = "bench_suggest.csv";
+    bool agree = true;
+
+    printf("%10s %7s %10s %10s %10s %8s %12s %12s\n", "items", "values", "p50 us", "p99 us", "max us", "found",
+           "update ns", "scan ms");
+    for (size_t items = 10000; items <= maxItems; items *= 10) {
+        for (size_t run = 0; run < 2; run++) {
+            size_t values = run == 0 ? cardinality : HIGH_CARDINALITY;
+            if (run == 1 && values == cardinality) continue;
+            generateWardrobeCsv(path, items, values, seed);
+            Wardrobe outfits = loadDatabase(path);
+            remove(path.c_str());
+            vector<string_view> names = attributeTable();
+
+            //Draw the intended items and their typos before timing, so interning is not measured
+            Xoshiro256 rng(seed);
+            vector<ClothingItem> intended;
+            vector<ClothingItem> typed;
+            for (size_t q = 0; q < queries; q++) {
+                const vector<ClothingItem>& pool = getType(outfits, uint8_t(uniformIndex(rng, 4)));
+                if (pool.empty()) continue;
+                ClothingItem item = pool[uniformIndex(rng, pool.size())];
+                ClothingItem wrong = item;
+                AttributeId* fields[3] = {&wrong.material, &wrong.color, &wrong.pattern};
+                AttributeId& field = *fields[uniformIndex(rng, 3)];
+                field = internAttribute(mistype(string(names[field]), rng));
+                intended.push_back(item);
+                typed.push_back(wrong);
+            }
+            names = attributeTable();
+
+            suggestIndex(outfits);
+            vector<double> micros;
+            size_t found = 0;
+            for (size_t q = 0; q < typed.size(); q++) {
+                Stopwatch timer;
+                vector<ClothingMatch> matches = suggestClothing(outfits, typed[q], SUGGESTION_COUNT);
+                micros.push_back(timer.seconds() * 1e6);
+                for (const auto& match : matches) found += match.item == intended[q];
+            }
+            sort(micros.begin(), micros.end());
+
+            //Incremental upkeep: the same item erased and put back
+            size_t updates = 100000;
+            Stopwatch updateTimer;
+            for (size_t i = 0; i < updates; i++) {
+                ClothingItem item = eraseClothingAt(outfits, TOP, 0);
+                insertClothing(outfits, item);
+            }
+            double updateNs = updateTimer.seconds() / updates * 1e9;
+
+            //The scan finds the same closest distance as the first suggestion
+            size_t scans = min<size_t>(5, typed.size());
+            Stopwatch scanTimer;
+            for (size_t q = 0; q < scans; q++) {
+                unsigned closest = scanClosest(outfits, typed[q], names);
+                vector<ClothingMatch> matches = suggestClothing(outfits, typed[q], 1);
+                agree = agree && (matches.empty() ? closest > SUGGEST_MAX_DISTANCE : matches[0].distance == closest);
+            }
+            double scanMs = scanTimer.seconds() / max<size_t>(1, scans) * 1e3;
+
+            printf("%10zu %7zu %10.1f %10.1f %10.1f %7.1f%% %12.0f %12.1f\n", items, values, micros[micros.size() / 2],
+                   micros[micros.size() * 99 / 100], micros.back(), 100.0 * found / typed.size(), updateNs, scanMs);
+        }
+    }
+    printf("%s\n", agree ? "suggestions agree with a full scan" : "FAIL: a suggestion is not the closest item");
+    return agree ? 0 : 1;
+}
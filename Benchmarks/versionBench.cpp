@@ -0,0 +1,105 @@
+/* Nolan Pierce - Versioned Wardrobe Benchmark
+ *
+ * Overview:
+ *   Compares read throughput of a VersionedWardrobe against a Wardrobe behind
+ *   one mutex while a writer keeps changing it. Each read takes the wardrobe,
+ *   sums the sizes of all types and scans the first 256 tops; the writer
+ *   repeatedly adds a top and removes it again. Readers of the versioned
+ *   wardrobe never wait for the writer or each other, so they scale with
+ *   cores; in exchange every write copies the tops it changed.
+ *
+ * Usage:
+ *   versionBench [items = 40000] [maxReaders = 8] [milliseconds = 1000]
+ */
+#include "../Headers/VersionedWardrobe.h"
+#include "BenchUtil.h"
+#include <cstdio>
+#include <thread>
+
+using namespace std;
+
+/* scanTops
+ * The reader's work: a checksum over the first 256 tops.
+ */
+static uint64_t scanTops(const vector<ClothingItem>& tops) {
+    uint64_t sum = 0;
+    for (size_t i = 0; i < tops.size() && i < 256; i++) sum += tops[i].color + tops[i].pattern;
+    return sum;
+}
+
+/* runReaders
+ * Runs one writer and some readers for a while.
+ *
+ * Returns:
+ *   Reads and writes completed, as a pair.
+ */
+template <typename Read, typename Write>
+static pair<size_t, size_t> runReaders(size_t readers, size_t milliseconds, Read read, Write write) {
+    atomic<bool> done{false};
+    atomic<size_t> reads{0};
+    size_t writes = 0;
+    vector<thread> threads;
+    for (size_t r = 0; r < readers; r++) {
+        threads.emplace_back([&] {
+            size_t count = 0;
+            uint64_t sink = 0;
+            while (!done.load(memory_order_relaxed)) {
+                sink += read();
+                count++;
+            }
+            reads += count + (sink == 1);
+        });
+    }
+    thread writer([&] {
+        while (!done.load(memory_order_relaxed)) {
+            write();
+            writes++;
+        }
+    });
+    this_thread::sleep_for(chrono::milliseconds(milliseconds));
+    done = true;
+    for (auto& thread : threads) thread.join();
+    writer.join();
+    return {reads.load(), writes};
+}
+
+int main(int argc, char** argv) {
+    size_t items = argOr(argc, argv, 1, 40000);
+    size_t maxReaders = max<size_t>(1, argOr(argc, argv, 2, 8));
+    size_t milliseconds = argOr(argc, argv, 3, 1000);
+    const ClothingItem extra = {0, 0, 0, TOP, false};
+    double seconds = milliseconds / 1000.0;
+
+    printf("%8s %16s %16s %16s %16s\n", "readers", "mutex reads/s", "mutex writes/s", "version reads/s",
+           "version writes/s");
+    for (size_t readers = 1; readers <= maxReaders; readers *= 2) {
+        Wardrobe locked = randomWardrobe(items);
+        mutex lock;
+        auto baseline = runReaders(readers, milliseconds,
+            [&] {
+                lock_guard<mutex> holding(lock);
+                size_t total = locked.jackets.size() + locked.tops.size() + locked.bottoms.size() + locked.shoes.size();
+                return total + scanTops(locked.tops);
+            },
+            [&] {
+                lock_guard<mutex> holding(lock);
+                insertClothing(locked, extra);
+                eraseAllClothing(locked, extra);
+            });
+
+        VersionedWardrobe versioned(randomWardrobe(items));
+        auto shared = runReaders(readers, milliseconds,
+            [&] {
+                VersionedWardrobe::ReadGuard version = versioned.read();
+                return version->size() + scanTops(version->items(TOP));
+            },
+            [&] {
+                addClothing(versioned, {extra});
+                removeClothing(versioned, extra);
+            });
+
+        printf("%8zu %16.0f %16.0f %16.0f %16.0f\n", readers, baseline.first / seconds, baseline.second / seconds,
+               shared.first / seconds, shared.second / seconds);
+    }
+    return 0;
+}
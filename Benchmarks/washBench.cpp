@@ -0,0 +1,74 @@
+/* Nolan Pierce - Delta Laundry Benchmark
+ *
+ * Overview:
+ *   Washes 5 items out of a dirty pile of 1k up to maxItems items, once with
+ *   moveClothing naming the 5 items and once with updateWardrobes keeping
+ *   every other item dirty, and reports the cost of one wash. moveClothing
+ *   should stay flat as the pile grows while updateWardrobes grows with it.
+ *   Both must move the same items; the exit code is 1 if they do not.
+ *
+ * Usage:
+ *   washBench [maxItems = 1000000] [seed = 42]
+ */
+#include "../Headers/OutfitPicker.h"
+#include "../Headers/Random.h"
+#include "BenchUtil.h"
+#include <algorithm>
+#include <cstdio>
+
+using namespace std;
+
+const size_t WASHED = 5;
+
+int main(int argc, char** argv) {
+    size_t maxItems = max<size_t>(1000, argOr(argc, argv, 1, 1000000));
+    uint64_t seed = argOr(argc, argv, 2, 42);
+    bool same = true;
+
+    printf("%10s %16s %18s %10s\n", "pile", "moveClothing", "updateWardrobes", "speedup");
+    for (size_t items = 1000; items <= maxItems; items *= 10) {
+        Wardrobe dirty = randomWardrobe(items, 24, seed);
+        Wardrobe clean;
+        Xoshiro256 rng(seed);
+        vector<ClothingItem> washing;
+        while (washing.size() < WASHED) {
+            const vector<ClothingItem>& pool = getType(dirty, uint8_t(uniformIndex(rng, 4)));
+            if (!pool.empty()) washing.push_back(pool[uniformIndex(rng, pool.size())]);
+        }
+        //Everything but the washed items stays dirty
+        Wardrobe stay = dirty;
+        for (const auto& item : washing) eraseOneClothing(stay, item);
+
+        //Each wash is undone, untimed, by moving the same items back
+        vector<ClothingItem> washed;
+        washed.reserve(WASHED);
+        size_t deltaRuns = 100000;
+        double deltaSeconds = 0;
+        for (size_t run = 0; run < deltaRuns; run++) {
+            washed.clear();
+            Stopwatch timer;
+            moveClothing(dirty, clean, washing, &washed);
+            deltaSeconds += timer.seconds();
+            moveClothing(clean, dirty, washing);
+        }
+        same = same && washed.size() == WASHED;
+
+        size_t fullRuns = max<size_t>(3, min<size_t>(1000, 10000000 / items));
+        double fullSeconds = 0;
+        vector<ClothingItem> swept;
+        for (size_t run = 0; run < fullRuns; run++) {
+            swept.clear();
+            Stopwatch timer;
+            updateWardrobes(dirty, clean, stay, &swept);
+            fullSeconds += timer.seconds();
+            moveClothing(clean, dirty, swept);
+        }
+        same = same && swept.size() == WASHED && is_permutation(washed.begin(), washed.end(), swept.begin());
+
+        double delta = deltaSeconds / deltaRuns;
+        double full = fullSeconds / fullRuns;
+        printf("%10zu %13.0f ns %15.0f ns %9.0fx\n", items, delta * 1e9, full * 1e9, full / delta);
+    }
+    printf("%s\n", same ? "both washed the same items" : "FAIL: the two washes moved different items");
+    return same ? 0 : 1;
+}
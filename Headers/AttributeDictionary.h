@@ -0,0 +1,27 @@
+#ifndef ATTRIBUTEDICTIONARY_H
+#define ATTRIBUTEDICTIONARY_H
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace std;
+
+// Compact ID standing in for a material, color or pattern string
+typedef uint16_t AttributeId;
+
+/* Attribute dictionary
+ *   Process-wide string interning table shared by every Wardrobe, so items
+ *   from the clean, dirty and unwashed wardrobes compare by ID alone.
+ *   IDs are handed out in first-seen order and never change or get reused.
+ *   All functions are safe to call from multiple threads.
+ */
+AttributeId internAttribute(string_view value);
+bool findAttribute(string_view value, AttributeId& id);
+const string& attributeName(AttributeId id);
+vector<string_view> attributeTable();
+void attributeTable(vector<string_view>& into);
+size_t attributeCount();
+
+#endif
@@ -0,0 +1,27 @@
+#ifndef CLOTHINGSEARCH_H
+#define CLOTHINGSEARCH_H
+
+#include "OutfitPicker.h"
+
+using namespace std;
+
+// Distance a suggestion adds for a different type or length, next to attributeDistance's edits
+const unsigned TYPE_MISMATCH_COST = 3;
+const unsigned LENGTH_MISMATCH_COST = 1;
+// Items further than this from what was typed are not suggested
+const unsigned SUGGEST_MAX_DISTANCE = 4;
+// Suggestions offered after a typo
+const size_t SUGGESTION_COUNT = 5;
+
+// An item kind in a wardrobe close to one the user typed
+struct ClothingMatch {
+    ClothingItem item;      // no wear history; equal (operator==) to the wardrobe's items
+    unsigned distance;      // 0 for an exact match
+    size_t copies;          // items in the wardrobe equal to item
+};
+
+unsigned attributeDistance(string_view typed, string_view value, unsigned limit);
+vector<ClothingMatch> suggestClothing(Wardrobe& outfits, const ClothingItem& typed, size_t limit,
+                                      unsigned maxDistance = SUGGEST_MAX_DISTANCE);
+
+#endif
@@ -0,0 +1,9 @@
+#ifndef COMMANDS_H
+#define COMMANDS_H
+
+using namespace std;
+
+// Non-interactive entry point: outfitpicker <command> [options]
+int runCommand(int argc, char** argv);
+
+#endif
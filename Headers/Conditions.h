@@ -0,0 +1,65 @@
+#ifndef CONDITIONS_H
+#define CONDITIONS_H
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "OutfitPicker.h"
+
+using namespace std;
+
+// Advice thresholds, in degrees Celsius and millimetres of rain per day
+const double JACKET_BELOW_C = 15.0;
+const double LONG_BELOW_C = 18.0;
+const double SHORT_FROM_C = 25.0;
+const double RAIN_FROM_MM = 1.0;
+
+// Weather for one day
+struct Conditions {
+    double temperature = 20.0;      // degrees Celsius
+    double precipitation = 0.0;     // millimetres
+};
+
+/* ConditionsProvider
+ * Source of daily weather. Days are counted from 1970-01-01 (see dayNumber).
+ */
+class ConditionsProvider {
+public:
+    virtual ~ConditionsProvider() = default;
+    virtual bool conditionsFor(int64_t day, Conditions& conditions) = 0;    // false if the day is unknown
+};
+
+/* FileConditionsProvider
+ * Reads a local forecast file, one day per line: date,temperature,precipitation
+ * e.g. 2026-10-17,12.5,0.4. Days not in the file are unknown.
+ */
+class FileConditionsProvider : public ConditionsProvider {
+public:
+    explicit FileConditionsProvider(const string& filename);
+    bool conditionsFor(int64_t day, Conditions& conditions) override;
+    size_t size() const { return days.size(); }
+
+private:
+    unordered_map<int64_t, Conditions> days;
+};
+
+/* StubConditionsProvider
+ * Reports the same conditions for every day, for machines without a forecast.
+ */
+class StubConditionsProvider : public ConditionsProvider {
+public:
+    explicit StubConditionsProvider(Conditions conditions = Conditions()) : fixed(conditions) {}
+    bool conditionsFor(int64_t day, Conditions& conditions) override;
+
+private:
+    Conditions fixed;
+};
+
+PickOptions adviseOutfit(const Conditions& conditions, PickOptions options = PickOptions());
+vector<PickOptions> adviseDays(ConditionsProvider& provider, int64_t firstDay, size_t days,
+                               const PickOptions& fallback, size_t* unknown = nullptr);
+PickResult pickOutfitsForDays(Wardrobe& outfits, Wardrobe& dirty, const vector<PickOptions>& days,
+                              Xoshiro256& rng = pickerRng());
+
+#endif
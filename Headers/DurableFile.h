@@ -0,0 +1,41 @@
+#ifndef DURABLEFILE_H
+#define DURABLEFILE_H
+
+#include <string>
+#include <string_view>
+
+using namespace std;
+
+/* AppendFile
+ * File opened for appending, with an explicit sync to stable storage.
+ *
+ * Details:
+ *   - Writes go straight to the OS with no user-space buffering; callers batch
+ *     data themselves and call sync() once per batch.
+ *   - Move-only; the file is closed when the object is destroyed.
+ */
+class AppendFile {
+public:
+    AppendFile() = default;
+    ~AppendFile();
+    AppendFile(AppendFile&& other) noexcept;
+    AppendFile& operator=(AppendFile&& other) noexcept;
+    AppendFile(const AppendFile&) = delete;
+    AppendFile& operator=(const AppendFile&) = delete;
+
+    bool open(const string& filename);
+    bool append(string_view data);
+    bool sync();
+    void close();
+    bool isOpen() const { return fd >= 0; }
+
+private:
+    int fd = -1;
+};
+
+// Durability helpers for files written by the persistence code
+bool syncFile(const string& filename);
+bool syncDirectoryOf(const string& filename);
+bool replaceFile(const string& from, const string& to);
+
+#endif
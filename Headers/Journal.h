@@ -0,0 +1,73 @@
+#ifndef JOURNAL_H
+#define JOURNAL_H
+
+#include "OutfitPicker.h"
+#include "DurableFile.h"
+#include "SnapshotWriter.h"
+#include <atomic>
+#include <memory>
+
+using namespace std;
+
+enum JournalOp : uint8_t { JOURNAL_ADD, JOURNAL_REMOVE, JOURNAL_WEAR, JOURNAL_WASH, JOURNAL_WORN };
+
+/* Journal
+ * Write-ahead log of wardrobe changes on top of the outfits/dirty CSV snapshots.
+ *
+ * Details:
+ *   - Each change is one text line: op,type,isLong,material,color,pattern[,wearCount,lastWorn]
+ *     where op is add, remove (clean items), wear (clean -> dirty), wash (dirty -> clean)
+ *     or worn (worn but still clean, e.g. shoes). wear and worn records hold the item
+ *     after the wear; the others hold it as it is.
+ *   - Lines are buffered and appended + fsynced once per batch, or on flush().
+ *   - load() reads both snapshots and replays the journal after them. A torn last
+ *     line from a crash is dropped.
+ *   - compact() folds the journal into fresh snapshots. A marker file makes the
+ *     switch to the new snapshots all-or-nothing, so a crash at any point loads
+ *     either the old snapshots plus journal or the new snapshots alone.
+ *   - compactInBackground() seals the journal, starts a fresh one, and has a
+ *     SnapshotWriter write the new snapshots while changes keep being recorded.
+ *     The sealed part is deleted when they are switched in; until then load()
+ *     replays it before the journal. Only one runs at a time, so the changes
+ *     made meanwhile are folded in by the next one.
+ */
+class Journal {
+public:
+    Journal(const string& outfitsPath, const string& dirtyPath, size_t batchSize = 64);
+    ~Journal();
+    Journal(const Journal&) = delete;
+    Journal& operator=(const Journal&) = delete;
+
+    void load(Wardrobe& outfits, Wardrobe& dirty);
+    void record(JournalOp op, const ClothingItem& item);
+    void record(JournalOp op, const vector<ClothingItem>& items);
+    void flush();
+    bool needsCompaction(size_t liveItems) const;
+    bool compact(const Wardrobe& outfits, const Wardrobe& dirty);
+    bool compactInBackground(const Wardrobe& outfits, const Wardrobe& dirty);
+    bool waitForCompaction();
+    size_t records() const { return recordCount; }
+
+private:
+    void recoverCompaction();
+    size_t replay(const string& path, Wardrobe& outfits, Wardrobe& dirty);
+    bool commitSealed(bool written);
+
+    string outfitsPath;
+    string dirtyPath;
+    string journalPath;
+    string markerPath;
+    string sealedPath;
+    size_t batchSize;
+    size_t recordCount = 0;     //records since the last compaction, including pending ones
+    size_t pendingCount = 0;
+    string pending;
+    AppendFile file;
+    atomic<bool> compacting{false};     //a background compaction has not finished
+    uint64_t compactionTicket = 0;
+    unique_ptr<SnapshotWriter> writer;  //last, so it is drained before the paths go
+};
+
+bool applyJournalOp(JournalOp op, const ClothingItem& item, Wardrobe& outfits, Wardrobe& dirty);
+
+#endif
@@ -0,0 +1,45 @@
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+
+#include <string>
+#include <string_view>
+#include <cstddef>
+
+using namespace std;
+
+/* MappedFile
+ * Read-only memory mapping of a whole file.
+ *
+ * Details:
+ *   - Uses mmap on POSIX systems and CreateFileMapping on Windows.
+ *   - A missing or empty file maps to an empty view instead of failing,
+ *     matching how loadDatabase treats a missing CSV as an empty wardrobe.
+ *   - Move-only; the mapping is released when the object is destroyed.
+ */
+class MappedFile {
+public:
+    MappedFile() = default;
+    explicit MappedFile(const string& filename);
+    ~MappedFile();
+
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const char* data() const { return begin; }
+    size_t size() const { return length; }
+    string_view view() const { return string_view(begin, length); }
+
+private:
+    void release();
+
+    const char* begin = nullptr;
+    size_t length = 0;
+#ifdef _WIN32
+    void* fileHandle = nullptr;
+    void* mappingHandle = nullptr;
+#endif
+};
+
+#endif
@@ -0,0 +1,80 @@
+#ifndef OUTFITCACHE_H
+#define OUTFITCACHE_H
+
+#include "OutfitScorer.h"
+#include <list>
+#include <mutex>
+#include <unordered_map>
+
+// Cap used when none is given: enough for thousands of typical wardrobes
+const size_t OUTFIT_CACHE_DEFAULT_BYTES = size_t(64) << 20;
+
+// Counts since the cache was made or cleared, and its current size
+struct OutfitCacheStats {
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    uint64_t evictions = 0;
+    double hitSeconds = 0;      // total time of lookups that found a plan
+    double missSeconds = 0;     // total time of lookups that built one, building included
+    size_t entries = 0;
+    size_t bytes = 0;
+};
+
+/* OutfitCache
+ * Keeps the ScorePlans of recently asked wardrobe versions, so asking again
+ * about a wardrobe that has not changed only runs the search.
+ *
+ * Details:
+ *   - Plans are keyed by the wardrobe's version (see stampVersion), the rules
+ *     and the jacket option. Every edit gives a wardrobe a new version, so a
+ *     stale plan is never found again; it ages out like any unused entry.
+ *   - Least recently used plans are evicted once their total size passes
+ *     maxBytes. A plan larger than maxBytes on its own is returned but not kept.
+ *   - Safe to share between threads. Plans are built outside the lock, so a
+ *     slow build does not hold up lookups of other wardrobes.
+ */
+class OutfitCache {
+public:
+    explicit OutfitCache(size_t maxBytes = OUTFIT_CACHE_DEFAULT_BYTES) : maxBytes(maxBytes) {}
+    OutfitCache(const OutfitCache&) = delete;
+    OutfitCache& operator=(const OutfitCache&) = delete;
+
+    shared_ptr<const ScorePlan> plan(const Wardrobe& outfits, const StyleRules& rules, const PickOptions& options);
+    OutfitCacheStats stats() const;
+    void clear();
+
+private:
+    struct Key {
+        uint64_t version;
+        uint64_t rules;         // rulesFingerprint
+        bool jacket;
+        bool operator==(const Key& other) const {
+            return version == other.version && rules == other.rules && jacket == other.jacket;
+        }
+    };
+    struct KeyHash {
+        size_t operator()(const Key& key) const {
+            return size_t((key.version * 0x9E3779B97F4A7C15ull) ^ key.rules ^ uint64_t(key.jacket));
+        }
+    };
+    struct Entry {
+        Key key;
+        vector<StyleRule> rules;    // compared on a hit, so a fingerprint collision cannot return a wrong plan
+        shared_ptr<const ScorePlan> plan;
+        size_t bytes;
+    };
+
+    void insert(Entry entry);
+
+    size_t maxBytes;
+    mutable mutex lock;
+    list<Entry> recent;         // most recently used first
+    unordered_map<Key, list<Entry>::iterator, KeyHash> entries;
+    OutfitCacheStats counts;
+};
+
+uint64_t rulesFingerprint(const StyleRules& rules);
+vector<ScoredOutfit> bestOutfits(const Wardrobe& outfits, const StyleRules& rules, size_t k,
+                                 const PickOptions& options, OutfitCache& cache);
+
+#endif
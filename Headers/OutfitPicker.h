@@ -4,16 +4,97 @@
 #include <iostream>
 #include <vector>
 #include <string>
+#include <string_view>
 #include <fstream>
+#include <cstdint>
+#include <climits>
+#include <unordered_map>
+#include "AttributeDictionary.h"
+#include "Random.h"
+#include "OutputBuffer.h"
 
 using namespace std;
 
+enum ClothingType : uint8_t { JACKET, TOP, BOTTOM, SHOES };
+enum LengthFilter : uint8_t { LENGTH_ANY, LENGTH_LONG, LENGTH_SHORT };
+
+// lastWorn of an item that has never been worn; sorts before every real day
+const int32_t NEVER_WORN = INT32_MIN;
+// PickOptions::day value that stands for the local date when the pick is made
+const int64_t DAY_TODAY = INT64_MIN;
+
+// Packed into 16 bytes; attribute strings are decoded through attributeName()
 struct ClothingItem {
-    string type;     // e.g., "top", "bottom", "shoes", "jacket"
-    bool isLong;     // true if long-sleeved or long-pants, false otherwise
-    string material; // e.g., "cotton", "wool", "synthetic"
-    string color;
-    string pattern;  // e.g., "solid", "striped", "plaid"
+    AttributeId material; // e.g., "cotton", "wool", "synthetic"
+    AttributeId color;
+    AttributeId pattern;  // e.g., "solid", "striped", "plaid"
+    uint8_t type;         // ClothingType: "jacket", "top", "bottom", "shoes"
+    bool isLong;          // true if long-sleeved or long-pants, false otherwise
+    // Wear history; not part of the item's identity (clothingKey, operator==)
+    uint32_t wearCount = 0;
+    int32_t lastWorn = NEVER_WORN;  // days since 1970-01-01
+};
+
+/* hasWearHistory
+ * Says whether an item has been worn, i.e. whether its files need the history fields.
+ */
+inline bool hasWearHistory(const ClothingItem& item) {
+    return item.wearCount > 0 || item.lastWorn != NEVER_WORN;
+}
+
+/* wornBefore
+ * Orders items for rotation: least recently worn first, then least worn.
+ */
+inline bool wornBefore(const ClothingItem& a, const ClothingItem& b) {
+    return a.lastWorn != b.lastWorn ? a.lastWorn < b.lastWorn : a.wearCount < b.wearCount;
+}
+
+/* clothingKey
+ * Packs every field of a ClothingItem into one integer.
+ *
+ * Returns:
+ *   Key that is equal for two items exactly when operator== is true.
+ */
+inline uint64_t clothingKey(const ClothingItem& item) {
+    return uint64_t(item.material) | uint64_t(item.color) << 16 | uint64_t(item.pattern) << 32 |
+           uint64_t(item.type) << 48 | uint64_t(item.isLong) << 56;
+}
+
+/* kindSlot
+ * Picks the suggestIndex list of one attribute value that holds the kinds of a type and length.
+ */
+inline size_t kindSlot(AttributeId value, uint8_t type, bool isLong) {
+    return size_t(value) * 8 + size_t(type) * 2 + size_t(isLong);
+}
+
+/* attributeGroup
+ * Packs the fields the weather preferences look at: type, isLong and material.
+ */
+inline uint32_t attributeGroup(uint8_t type, bool isLong, AttributeId material) {
+    return uint32_t(material) | uint32_t(isLong) << 16 | uint32_t(type) << 17;
+}
+
+// Hashed multiset over a Wardrobe's items, kept in sync by insertClothing/eraseClothingAt.
+// Entries stay when their last item leaves (an empty positions list), so items that
+// come and go, e.g. between clean and dirty, do not allocate a map node every time.
+struct WardrobeIndex {
+    // Cleared for wardrobes loaded without an index (see SnapshotView::toWardrobe);
+    // keyIndex builds positions and slots on the first lookup by item
+    bool keyed = true;
+    unordered_map<uint64_t, vector<uint32_t>> positions; // clothingKey -> positions in its type's vector
+    vector<uint32_t> slots[4];                            // per type: each item's slot in positions[key]
+    // Built by groupIndex on first use, then kept in sync like positions
+    bool grouped = false;
+    unordered_map<uint32_t, vector<uint32_t>> groups;    // attributeGroup -> positions in its type's vector
+    vector<uint32_t> groupSlots[4];                       // per type: each item's slot in groups[group]
+    // Built by rotationIndex on first use, then kept in sync like positions
+    bool rotating = false;
+    vector<uint32_t> heaps[4];                            // per type: positions as a min-heap by wornBefore
+    vector<uint32_t> heapSlots[4];                        // per type: each item's slot in heaps[type]
+    // Built by suggestIndex on first use, then kept in sync like positions
+    bool suggesting = false;
+    vector<uint32_t> valueUses[3];                        // material, color, pattern: items using each AttributeId
+    vector<vector<uint64_t>> valueKinds[3];               // per field, at kindSlot: clothingKeys of the kinds listed there
 };
 
 struct Wardrobe {
@@ -21,6 +102,31 @@ struct Wardrobe {
     vector<ClothingItem> tops;
     vector<ClothingItem> bottoms;
     vector<ClothingItem> shoes;
+    WardrobeIndex index;
+    uint64_t version = 0;   // renumbered by every edit (see stampVersion); equal versions mean equal contents
+};
+
+// One outfit produced by pickOutfits; jacket is only set when hasJacket is true
+struct Outfit {
+    ClothingItem top;
+    ClothingItem bottom;
+    ClothingItem shoes;
+    ClothingItem jacket;
+    bool hasJacket;
+};
+
+struct PickOptions {
+    bool jacket = false;                // include a jacket in every outfit
+    uint8_t length = LENGTH_ANY;        // preferred LengthFilter for tops and bottoms
+    vector<AttributeId> avoidMaterials; // materials to leave out when anything else is clean
+    bool rotation = false;              // wear the least recently worn items instead of random ones
+    int64_t day = DAY_TODAY;            // day the first outfit is worn; each further outfit is a day later
+};
+
+struct PickResult {
+    vector<Outfit> outfits;
+    bool ranDry = false;    // true if a clothing type ran out before all outfits were made
+    uint8_t dryType = 0;    // ClothingType that ran out, when ranDry is set
 };
 
 // Comparison operator
@@ -35,6 +141,7 @@ struct Wardrobe {
  *   true if all fields match; false otherwise.
  */
 inline bool operator==(const ClothingItem& a, const ClothingItem& b) {
+    // Interned IDs are equal exactly when the strings they stand for are equal
     return a.type == b.type &&
            a.isLong == b.isLong &&
            a.material == b.material &&
@@ -42,22 +149,61 @@ inline bool operator==(const ClothingItem& a, const ClothingItem& b) {
            a.pattern == b.pattern;
 }
 // Utility functions
+const char* typeName(uint8_t type);
+bool parseType(string_view input, uint8_t& type);
 void toLower(string& input);
 void checkBool(string& input);
 void checkType(string& input);
+int64_t dayNumber(int year, unsigned month, unsigned dayOfMonth);
+bool parseDay(string_view text, int64_t& day);
+string formatDay(int64_t day);
+int64_t today();
 //void checkInt(string& input);
-vector<ClothingItem>& getType(Wardrobe& outfits, ClothingItem Item);
+vector<ClothingItem>& getType(Wardrobe& outfits, const ClothingItem& Item);
+vector<ClothingItem>& getType(Wardrobe& outfits, uint8_t type);
+const vector<ClothingItem>& getType(const Wardrobe& outfits, uint8_t type);
+
+// Indexed wardrobe edits; all changes to Wardrobe vectors go through these
+void insertClothing(Wardrobe& outfits, const ClothingItem& item);
+void insertClothing(Wardrobe& outfits, const vector<ClothingItem>& items);
+ClothingItem eraseClothingAt(Wardrobe& outfits, uint8_t type, size_t pos);
+bool eraseOneClothing(Wardrobe& outfits, const ClothingItem& item);
+size_t eraseAllClothing(Wardrobe& outfits, const ClothingItem& item);
+size_t countClothing(const Wardrobe& outfits, const ClothingItem& item);
+void rebuildIndex(Wardrobe& outfits);
+void keyIndex(Wardrobe& outfits);
+void stampVersion(Wardrobe& outfits);
+void groupIndex(Wardrobe& outfits);
+void rotationIndex(Wardrobe& outfits);
+void suggestIndex(Wardrobe& outfits);
+ClothingItem wearClothingAt(Wardrobe& outfits, uint8_t type, size_t pos, int64_t day);
+size_t wardrobeSize(const Wardrobe& outfits);
 
 // Core functionality
 Wardrobe loadDatabase(const string& filename);
+Wardrobe parseDatabase(string_view contents);
+bool parseClothingLine(string_view line, ClothingItem& item);
+bool splitClothingLine(string_view line, ClothingItem& item, string_view attributes[3]);
 ClothingItem getUsersClothing();
-void addClothing(Wardrobe& outfits);
-void printClothing(const vector<ClothingItem>& clothes);
-void printWardrobe(const Wardrobe& outfits);
-void removeClothing(Wardrobe& outfits);
-void updateVectors(vector<ClothingItem>& src, vector<ClothingItem>& dest, const vector<ClothingItem>& stay);
-void updateWardrobes(Wardrobe& src, Wardrobe& dest, const Wardrobe& stay);
-void pushDatabase(const Wardrobe& src, const string& filename);
-void pickOutfit(Wardrobe& outfits, Wardrobe& dirty, bool jacket);
+bool offerSuggestions(Wardrobe& outfits, ClothingItem& item);
+void addClothing(Wardrobe& outfits, vector<ClothingItem>* added = nullptr);
+void formatClothing(OutputBuffer& out, const ClothingItem& item, const vector<string_view>& names,
+                    OutputMode mode);
+void formatOutfit(OutputBuffer& out, const Outfit& outfit, const vector<string_view>& names);
+void printClothing(const vector<ClothingItem>& clothes, OutputMode mode = OUTPUT_PRETTY);
+void printWardrobe(const Wardrobe& outfits, OutputMode mode = OUTPUT_PRETTY);
+void removeClothing(Wardrobe& outfits, vector<ClothingItem>* removed = nullptr);
+void updateVectors(Wardrobe& src, Wardrobe& dest, const Wardrobe& stay, uint8_t type,
+                   vector<ClothingItem>* moved = nullptr);
+void updateWardrobes(Wardrobe& src, Wardrobe& dest, const Wardrobe& stay, vector<ClothingItem>* moved = nullptr);
+size_t moveClothing(Wardrobe& src, Wardrobe& dest, const vector<ClothingItem>& items,
+                    vector<ClothingItem>* moved = nullptr);
+bool pushDatabase(const Wardrobe& src, const string& filename);
+ClothingItem pickNremove(Wardrobe& from, uint8_t type);
+PickResult pickOutfits(Wardrobe& outfits, Wardrobe& dirty, size_t n, const PickOptions& options,
+                       Xoshiro256& rng = pickerRng());
+Outfit pickOutfit(Wardrobe& outfits, Wardrobe& dirty, bool jacket, vector<ClothingItem>* worn = nullptr);
+Outfit pickOutfit(Wardrobe& outfits, Wardrobe& dirty, const PickOptions& options,
+                  vector<ClothingItem>* worn = nullptr);
 
 #endif
@@ -0,0 +1,21 @@
+#ifndef OUTFITPLANNER_H
+#define OUTFITPLANNER_H
+
+#include "OutfitPicker.h"
+#include "ThreadPool.h"
+
+using namespace std;
+
+// One account's clean and dirty wardrobes
+struct WardrobePair {
+    Wardrobe outfits;
+    Wardrobe dirty;
+};
+
+// Planner for many independent accounts at once
+vector<PickResult> planOutfits(vector<WardrobePair>& accounts, size_t n, const PickOptions& options,
+                               uint64_t seed, ThreadPool& pool);
+vector<PickResult> planOutfits(vector<WardrobePair>& accounts, const vector<PickOptions>& days,
+                               uint64_t seed, ThreadPool& pool);
+
+#endif
@@ -0,0 +1,52 @@
+#ifndef OUTFITSCORER_H
+#define OUTFITSCORER_H
+
+#include "OutfitPicker.h"
+#include <memory>
+
+using namespace std;
+
+enum RuleKind : uint8_t { RULE_COLOR, RULE_PATTERN, RULE_MATERIAL };
+
+/* Style rules file (CSV, one rule per line, '#' starts a comment):
+ *   kind,valueA,valueB,score
+ *   kind is color, pattern or material; either value may be '*' to match anything.
+ *   Every rule that matches a pair of garments adds its score, e.g.
+ *     color,navy,white,3
+ *     pattern,striped,plaid,-5
+ *     pattern,solid,*,1
+ */
+struct StyleRule {
+    uint8_t kind;           // RuleKind
+    AttributeId a;          // ignored when anyA is set
+    AttributeId b;
+    bool anyA;
+    bool anyB;
+    int score;
+};
+
+struct StyleRules {
+    vector<StyleRule> rules;
+};
+
+// One outfit from bestOutfits and the sum of its pairwise rule scores
+struct ScoredOutfit {
+    Outfit outfit;
+    int score;
+};
+
+// Each category's distinct styles and the pair tables between them, built by
+// planScoring and searched by bestOutfits; read-only once built
+struct ScorePlan;
+
+StyleRules parseStyleRules(string_view contents, size_t* skipped = nullptr);
+StyleRules loadStyleRules(const string& filename, size_t* skipped = nullptr);
+int scorePair(const StyleRules& rules, const ClothingItem& a, const ClothingItem& b);
+int scoreOutfit(const StyleRules& rules, const Outfit& outfit);
+vector<ScoredOutfit> bestOutfits(const Wardrobe& outfits, const StyleRules& rules, size_t k,
+                                 const PickOptions& options);
+shared_ptr<const ScorePlan> planScoring(const Wardrobe& outfits, const StyleRules& rules, const PickOptions& options);
+vector<ScoredOutfit> bestOutfits(const ScorePlan& plan, size_t k);
+size_t scorePlanBytes(const ScorePlan& plan);
+
+#endif
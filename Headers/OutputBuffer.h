@@ -0,0 +1,48 @@
+#ifndef OUTPUTBUFFER_H
+#define OUTPUTBUFFER_H
+
+#include <cstdio>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+using namespace std;
+
+enum OutputMode : uint8_t {
+    OUTPUT_PRETTY,      // "Type: top, Is Long: No, ..." under per-type headings
+    OUTPUT_COMPACT,     // one CSV line per item, same format as outfits.csv
+    OUTPUT_TSV          // header row, then one tab-separated line per item
+};
+
+/* OutputBuffer
+ * Formats text into a large reusable buffer and hands it to a FILE in chunks.
+ *
+ * Details:
+ *   - Nothing is written until the buffer fills or flush() is called, and then
+ *     with a single fwrite, so printing many items costs a handful of syscalls
+ *     instead of one flush per line.
+ *   - The buffer is allocated once and kept, so steady-state printing does not allocate.
+ *   - Writes through the C stream, so output stays in order with cout.
+ */
+class OutputBuffer {
+public:
+    explicit OutputBuffer(FILE* target = stdout, size_t capacity = 1 << 16);
+    ~OutputBuffer();
+    OutputBuffer(const OutputBuffer&) = delete;
+    OutputBuffer& operator=(const OutputBuffer&) = delete;
+
+    void append(string_view text);
+    void append(char c);
+    void appendNumber(uint64_t value);
+    void flush();
+    void setTarget(FILE* newTarget);
+
+private:
+    FILE* target;
+    vector<char> buffer;
+    size_t used = 0;
+};
+
+OutputBuffer& standardOutput();
+
+#endif
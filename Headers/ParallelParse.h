@@ -0,0 +1,18 @@
+#ifndef PARALLELPARSE_H
+#define PARALLELPARSE_H
+
+#include "OutfitPicker.h"
+#include "ThreadPool.h"
+
+using namespace std;
+
+// Smallest piece of a CSV file given to one task; smaller inputs are parsed on the calling thread
+const size_t PARSE_CHUNK_MIN_BYTES = 1 << 20;
+// CSV files at least this big are parsed on all cores by loadDatabase(filename)
+const size_t PARALLEL_LOAD_MIN_BYTES = 64 << 20;
+
+// Multi-core versions of parseDatabase/loadDatabase; the result is the same as theirs
+Wardrobe parseDatabase(string_view contents, ThreadPool& pool);
+Wardrobe loadDatabase(const string& filename, ThreadPool& pool);
+
+#endif
@@ -0,0 +1,118 @@
+#ifndef RANDOM_H
+#define RANDOM_H
+
+#include <cstdint>
+#include <limits>
+
+using namespace std;
+
+/* Xoshiro256
+ * xoshiro256** pseudo-random generator: small, fast and seedable.
+ *
+ * Details:
+ *   - Satisfies UniformRandomBitGenerator, so it also works with <random> distributions.
+ *   - The 256-bit state is filled from a single 64-bit seed with splitmix64.
+ */
+struct Xoshiro256 {
+    typedef uint64_t result_type;
+    uint64_t state[4];
+
+    explicit Xoshiro256(uint64_t seed = 0) { reseed(seed); }
+
+    void reseed(uint64_t seed) {
+        for (auto& word : state) {
+            uint64_t z = (seed += 0x9e3779b97f4a7c15ULL);
+            z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+            z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+            word = z ^ (z >> 31);
+        }
+    }
+
+    uint64_t operator()() {
+        uint64_t result = rotl(state[1] * 5, 7) * 9;
+        uint64_t shifted = state[1] << 17;
+        state[2] ^= state[0];
+        state[3] ^= state[1];
+        state[1] ^= state[2];
+        state[0] ^= state[3];
+        state[2] ^= shifted;
+        state[3] = rotl(state[3], 45);
+        return result;
+    }
+
+    static constexpr uint64_t min() { return 0; }
+    static constexpr uint64_t max() { return numeric_limits<uint64_t>::max(); }
+
+private:
+    static uint64_t rotl(uint64_t x, int k) { return (x << k) | (x >> (64 - k)); }
+};
+
+/* streamSeed
+ * Derives the seed of one independent random stream from a base seed.
+ *
+ * Parameters:
+ *   seed   - base seed of the whole run.
+ *   stream - stream number, e.g. the index of an account.
+ *
+ * Details:
+ *   - Two rounds of splitmix64 scatter neighbouring stream numbers, so their
+ *     generators do not share state words the way seed + stream would.
+ */
+inline uint64_t streamSeed(uint64_t seed, uint64_t stream) {
+    Xoshiro256 mixer(seed ^ (stream * 0xd1b54a32d192ed03ULL));
+    return mixer.state[0] ^ mixer.state[3];
+}
+
+/* multiplyWide
+ * Multiplies two 64-bit numbers into a 128-bit product.
+ *
+ * Returns:
+ *   The low 64 bits; the high 64 bits are stored in high.
+ *
+ * Details:
+ *   - Uses the compiler's 128-bit integer where there is one (marked with
+ *     __extension__, so -Wpedantic stays quiet), otherwise four 32-bit products.
+ */
+inline uint64_t multiplyWide(uint64_t a, uint64_t b, uint64_t& high) {
+#ifdef __SIZEOF_INT128__
+    __extension__ typedef unsigned __int128 Wide;
+    Wide product = Wide(a) * b;
+    high = uint64_t(product >> 64);
+    return uint64_t(product);
+#else
+    uint64_t aLow = a & 0xFFFFFFFF, aHigh = a >> 32;
+    uint64_t bLow = b & 0xFFFFFFFF, bHigh = b >> 32;
+    uint64_t lowLow = aLow * bLow;
+    uint64_t cross = (lowLow >> 32) + (aHigh * bLow & 0xFFFFFFFF) + aLow * bHigh;
+    high = aHigh * bHigh + (aHigh * bLow >> 32) + (cross >> 32);
+    return (cross << 32) | (lowLow & 0xFFFFFFFF);
+#endif
+}
+
+/* uniformIndex
+ * Draws an unbiased random index in [0, size).
+ *
+ * Parameters:
+ *   rng  - generator to draw from.
+ *   size - number of possible results; must be non-zero.
+ *
+ * Details:
+ *   - Uses Lemire's multiply-and-reject method, which avoids both the modulo bias
+ *     of rand() % size and a division on almost every call.
+ */
+inline uint64_t uniformIndex(Xoshiro256& rng, uint64_t size) {
+    uint64_t high;
+    uint64_t low = multiplyWide(rng(), size, high);
+    if (low < size) {
+        uint64_t threshold = (0 - size) % size;
+        while (low < threshold) low = multiplyWide(rng(), size, high);
+    }
+    return high;
+}
+
+// Per-thread generator used by the outfit picker
+Xoshiro256& pickerRng();
+void seedPicker(uint64_t seed);
+uint64_t pickerSeed();
+
+#endif
@@ -0,0 +1,55 @@
+#ifndef SCRATCHARENA_H
+#define SCRATCHARENA_H
+
+#include <cstddef>
+#include <memory_resource>
+#include <vector>
+
+using namespace std;
+
+/* ScratchArena
+ * Monotonic arena for the temporary containers of one operation, e.g. one
+ * laundry reconciliation. Give its resource() to pmr containers; everything
+ * is released at once when the arena goes out of scope.
+ *
+ * Details:
+ *   - Allocates from a block owned by the thread and kept between operations.
+ *     If an operation outgrows the block the rest comes from the heap, and the
+ *     block is regrown when the arena ends, so repeating an operation of the
+ *     same size stops allocating after the first time.
+ *   - An arena opened while another one is open on the same thread uses the
+ *     heap only, so nested operations never share a block.
+ */
+class ScratchArena {
+public:
+    ScratchArena();
+    ~ScratchArena();
+    ScratchArena(const ScratchArena&) = delete;
+    ScratchArena& operator=(const ScratchArena&) = delete;
+
+    pmr::memory_resource* resource() { return &arena; }
+
+private:
+    // Heap fallback that remembers how much the block was short by
+    class Overflow : public pmr::memory_resource {
+    public:
+        size_t requested = 0;
+
+    private:
+        void* do_allocate(size_t bytes, size_t alignment) override;
+        void do_deallocate(void* pointer, size_t bytes, size_t alignment) override;
+        bool do_is_equal(const pmr::memory_resource& other) const noexcept override;
+    };
+
+    struct Block {
+        vector<byte> bytes;
+        bool open = false;
+    };
+    static Block& threadBlock();
+
+    Block* block;                   // nullptr when nested
+    Overflow overflow;
+    pmr::monotonic_buffer_resource arena;
+};
+
+#endif
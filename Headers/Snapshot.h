@@ -0,0 +1,69 @@
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include "OutfitPicker.h"
+#include "MappedFile.h"
+
+using namespace std;
+
+const uint32_t SNAPSHOT_VERSION = 2;
+// Version 1 records are the first 8 bytes of a ClothingItem, without wear history
+const uint32_t SNAPSHOT_VERSION_V1 = 1;
+const uint32_t RECORD_SIZE_V1 = 8;
+
+/* Binary snapshot layout (native byte order, all offsets 8-byte aligned):
+ *   SnapshotHeader
+ *   dictionary: dictionaryCount x { uint32 length, length bytes }: the attributes the items use
+ *   items:      jackets, tops, bottoms then shoes, as raw ClothingItem records whose
+ *               attribute IDs index the dictionary above
+ * Version 1 files (8-byte records, no wear history) are still read; their items load as never worn.
+ */
+struct SnapshotHeader {
+    char magic[8];              // "OUTFITPK"
+    uint32_t version;           // SNAPSHOT_VERSION
+    uint32_t byteOrder;         // 0x01020304 as written by the saving machine
+    uint32_t recordSize;        // sizeof(ClothingItem)
+    uint32_t reserved;
+    uint64_t counts[4];         // items per ClothingType: jackets, tops, bottoms, shoes
+    uint64_t dictionaryCount;
+    uint64_t dictionaryOffset;
+    uint64_t itemsOffset;
+    uint64_t fileSize;          // detects a truncated file
+};
+
+/* SnapshotView
+ * Read-only view of a binary snapshot, used in place from the memory mapping.
+ *
+ * Details:
+ *   - Opening validates the header, interns the dictionary and checks each
+ *     record's type and attribute IDs in one pass over the mapping; items are
+ *     never parsed or copied.
+ *   - If this process already numbered some attributes differently, items(type)
+ *     still returns the raw records and item(type, i) translates their IDs.
+ *   - items(type) is only available for current-version files (nullptr for
+ *     version 1); item(type, i) reads either.
+ */
+class SnapshotView {
+public:
+    bool open(const string& filename);
+    bool open(MappedFile file);
+
+    size_t count(uint8_t type) const { return header ? header->counts[type] : 0; }
+    const ClothingItem* items(uint8_t type) const;
+    ClothingItem item(uint8_t type, size_t i) const;
+    bool needsRemap() const { return !identity; }
+    bool isCurrent() const { return header && header->version == SNAPSHOT_VERSION; }
+    Wardrobe toWardrobe() const;
+
+private:
+    MappedFile file;
+    const SnapshotHeader* header = nullptr;
+    vector<AttributeId> remap;      //file ID -> process ID
+    bool identity = true;
+};
+
+bool isSnapshot(string_view contents);
+bool isSnapshotPath(const string& filename);
+bool writeSnapshot(const Wardrobe& src, const string& filename);
+
+#endif
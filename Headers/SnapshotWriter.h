@@ -0,0 +1,83 @@
+#ifndef SNAPSHOTWRITER_H
+#define SNAPSHOTWRITER_H
+
+#include "OutfitPicker.h"
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+using namespace std;
+
+// Counts since the writer was made
+struct SnapshotWriterStats {
+    uint64_t saves = 0;         // save() calls
+    uint64_t coalesced = 0;     // saves that replaced one still waiting to be written
+    uint64_t writes = 0;        // snapshot pairs written, successful or not
+    uint64_t failures = 0;
+};
+
+/* SnapshotWriter
+ * Saves a clean/dirty wardrobe pair on a background thread, so the caller
+ * only pays for copying the items.
+ *
+ * Details:
+ *   - Two buffer pairs are kept: one being written and one that save() copies
+ *     into. A save made while another is still waiting replaces it, so a burst
+ *     of saves costs one write of the latest state. The buffers keep their
+ *     capacity, so saving a wardrobe of steady size does not allocate.
+ *   - Each pair is written to the ".new" files next to the snapshots (see
+ *     newSnapshotPath) and fsynced, then commit is called on the writer thread.
+ *     Renaming two files is not atomic, so switching them in is left to the
+ *     owner's commit, e.g. Journal::commitSealed with its marker file.
+ *   - save() returns a ticket; wait(ticket) is the durability barrier, true once
+ *     that save or a later one is on disk. The destructor writes what is waiting.
+ *   - The thread is started by save() and exits when nothing is left to write,
+ *     so an idle writer holds no thread.
+ */
+class SnapshotWriter {
+public:
+    // Called with whether both new files were written and synced; returns whether the save is durable
+    using Commit = function<bool(bool written)>;
+
+    SnapshotWriter(const string& outfitsPath, const string& dirtyPath, Commit commit);
+    ~SnapshotWriter();
+    SnapshotWriter(const SnapshotWriter&) = delete;
+    SnapshotWriter& operator=(const SnapshotWriter&) = delete;
+
+    uint64_t save(const Wardrobe& outfits, const Wardrobe& dirty);
+    bool wait(uint64_t ticket);
+    bool flush();
+    bool busy() const;
+    SnapshotWriterStats stats() const;
+
+private:
+    // One copy of the wardrobes to be written; only the item vectors are filled
+    struct Buffer {
+        Wardrobe outfits;
+        Wardrobe dirty;
+    };
+
+    void run();
+    bool write(const Buffer& buffer);
+
+    string outfitsPath;
+    string dirtyPath;
+    Commit commit;
+    Buffer buffers[2];
+    int waiting = -1;               //buffer holding the next save, -1 if none
+    int writing = -1;               //buffer on the writer thread, -1 if none
+    uint64_t waitingTicket = 0;
+    uint64_t lastTicket = 0;
+    uint64_t finishedTicket = 0;    //latest ticket written or failed
+    uint64_t durableTicket = 0;     //latest ticket on disk
+    bool running = false;
+    SnapshotWriterStats counts;
+    mutable mutex lock;
+    condition_variable finished;
+    thread worker;
+};
+
+string newSnapshotPath(const string& path);
+
+#endif
@@ -0,0 +1,113 @@
+#ifndef STATS_H
+#define STATS_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+
+using namespace std;
+
+/* Profiling counters and timers for the hot paths.
+ *
+ * Build with -DOUTFIT_NO_STATS to compile every STAT_ADD and STAT_SCOPE out
+ * (and stop counting allocations); otherwise they are always collected and
+ * only printed on request (--stats). Allocations are only counted in programs
+ * that link Sources/AllocationCounter.cpp.
+ */
+#ifndef OUTFIT_NO_STATS
+#define OUTFIT_STATS 1
+#endif
+
+enum StatCounter : uint8_t {
+    STAT_ITEMS_PARSED,      // CSV lines turned into items
+    STAT_BYTES_READ,        // wardrobe, journal and other files read
+    STAT_BYTES_WRITTEN,     // wardrobe files, snapshots and journal records written
+    STAT_PICKS,             // outfits picked
+    STAT_COMPARISONS,       // items updateVectors looked up in the stay wardrobe
+    STAT_ALLOCATIONS,       // calls to operator new, in programs linking AllocationCounter.cpp
+    STAT_CACHE_HITS,        // OutfitCache lookups that found a plan
+    STAT_CACHE_MISSES,      // OutfitCache lookups that had to build one
+    STAT_COUNTER_COUNT
+};
+
+enum StatTimer : uint8_t {
+    TIMER_LOAD,             // loadDatabase
+    TIMER_LAUNDRY,          // updateWardrobes
+    TIMER_PICK,             // pickOutfits / pickOutfit
+    TIMER_SAVE,             // pushDatabase
+    STAT_TIMER_COUNT
+};
+
+// Timers time their first STAT_EXACT_CALLS calls on each thread, then one call in STAT_SAMPLE_PERIOD
+const uint64_t STAT_EXACT_CALLS = 32;
+const uint64_t STAT_SAMPLE_PERIOD = 32;
+
+// One thread's counts; only its own thread writes them
+struct StatBlock {
+    atomic<uint64_t> counters[STAT_COUNTER_COUNT] = {};
+    atomic<uint64_t> calls[STAT_TIMER_COUNT] = {};
+    atomic<uint64_t> timedCalls[STAT_TIMER_COUNT] = {};
+    atomic<uint64_t> nanoseconds[STAT_TIMER_COUNT] = {};
+};
+
+StatBlock& threadStats();
+
+/* bumpStat
+ * Adds to a counter of the calling thread's block. A plain load and store, not
+ * a locked read-modify-write, since no other thread writes it.
+ */
+inline void bumpStat(atomic<uint64_t>& value, uint64_t amount) {
+    value.store(value.load(memory_order_relaxed) + amount, memory_order_relaxed);
+}
+
+/* ScopedTimer
+ * Counts a call to a timed function and, for the calls that are sampled,
+ * adds the time until the end of the scope.
+ */
+class ScopedTimer {
+public:
+    explicit ScopedTimer(StatTimer timer) : block(threadStats()), timer(timer) {
+        uint64_t call = block.calls[timer].load(memory_order_relaxed);
+        bumpStat(block.calls[timer], 1);
+        timed = call < STAT_EXACT_CALLS || call % STAT_SAMPLE_PERIOD == 0;
+        if (timed) start = chrono::steady_clock::now();
+    }
+    ~ScopedTimer() {
+        if (!timed) return;
+        bumpStat(block.nanoseconds[timer],
+                 chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start).count());
+        bumpStat(block.timedCalls[timer], 1);
+    }
+    ScopedTimer(const ScopedTimer&) = delete;
+    ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+private:
+    StatBlock& block;
+    StatTimer timer;
+    bool timed;
+    chrono::steady_clock::time_point start;
+};
+
+// Totals over every thread, including threads that have exited
+struct TimerTotals {
+    uint64_t calls = 0;
+    double seconds = 0;     // estimated from the sampled calls when not every call was timed
+};
+
+void countAllocation();
+uint64_t statTotal(StatCounter counter);
+TimerTotals timerTotal(StatTimer timer);
+void writeStats(FILE* out, bool json);
+
+#ifdef OUTFIT_STATS
+#define STAT_ADD(counter, amount) bumpStat(threadStats().counters[counter], (amount))
+#define STAT_SCOPE_NAME(line) statScope##line
+#define STAT_SCOPE_AT(timer, line) ScopedTimer STAT_SCOPE_NAME(line)(timer)
+#define STAT_SCOPE(timer) STAT_SCOPE_AT(timer, __LINE__)
+#else
+#define STAT_ADD(counter, amount) ((void)0)
+#define STAT_SCOPE(timer) ((void)0)
+#endif
+
+#endif
@@ -0,0 +1,59 @@
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+/* ThreadPool
+ * Fixed set of worker threads with work stealing.
+ *
+ * Details:
+ *   - Every worker owns a task deque. Tasks submitted from a worker go to its own
+ *     deque and are run newest first; idle workers steal the oldest task from
+ *     another worker's deque.
+ *   - wait() lets the calling thread help run tasks, and rethrows the first
+ *     exception any task threw.
+ */
+class ThreadPool {
+public:
+    explicit ThreadPool(size_t threadCount = 0);     //0 uses one thread per hardware core
+    ~ThreadPool();
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    void submit(function<void()> task);
+    void wait();
+    size_t size() const { return workers.size(); }
+
+private:
+    struct TaskQueue {
+        mutex lock;
+        deque<function<void()>> tasks;
+    };
+
+    void workerLoop(size_t self);
+    bool runOne(size_t self);
+
+    vector<unique_ptr<TaskQueue>> queues;
+    vector<thread> workers;
+    atomic<size_t> queued{0};         //tasks waiting in a deque
+    atomic<size_t> unfinished{0};     //tasks submitted but not yet completed
+    atomic<size_t> nextQueue{0};
+    mutex sleepLock;
+    condition_variable wake;
+    condition_variable idle;
+    bool stopping = false;
+    exception_ptr failure;
+};
+
+#endif
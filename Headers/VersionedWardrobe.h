@@ -0,0 +1,112 @@
+#ifndef VERSIONEDWARDROBE_H
+#define VERSIONEDWARDROBE_H
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include "OutfitPicker.h"
+
+using namespace std;
+
+// Reader slots; more concurrent readers than this wait for a slot to free up
+const size_t MAX_READERS = 128;
+// typeMask bits for VersionedWardrobe::write, one per ClothingType
+const uint8_t ALL_TYPES = 0xF;
+
+inline uint8_t typeBit(uint8_t type) {
+    return uint8_t(1) << type;
+}
+
+/* WardrobeVersion
+ * Immutable published state of a VersionedWardrobe. Versions share the
+ * vectors of every clothing type that did not change between them.
+ */
+struct WardrobeVersion {
+    uint64_t number = 0;
+    shared_ptr<const vector<ClothingItem>> types[4];
+
+    const vector<ClothingItem>& items(uint8_t type) const { return *types[type]; }
+    size_t size() const;
+};
+
+/* VersionedWardrobe
+ * Wardrobe that many threads can read while others change it.
+ *
+ * Details:
+ *   - Readers take no lock: read() announces the reader in a slot with the
+ *     current epoch and loads the current version pointer; the returned guard
+ *     keeps that version alive until it is destroyed.
+ *   - Writers are serialized by a mutex. They edit a private indexed Wardrobe,
+ *     then publish a new version that copies only the types named in typeMask
+ *     and shares the rest with the previous version.
+ *   - Replaced versions are freed by later writers once every reader that
+ *     could still see them has left (epoch-based reclamation).
+ *   - Must not be destroyed while guards from read() are alive.
+ */
+class VersionedWardrobe {
+public:
+    class ReadGuard {
+    public:
+        ReadGuard(ReadGuard&& other) noexcept;
+        ReadGuard& operator=(ReadGuard&&) = delete;
+        ~ReadGuard();
+
+        const WardrobeVersion& operator*() const { return *version; }
+        const WardrobeVersion* operator->() const { return version; }
+
+    private:
+        friend class VersionedWardrobe;
+        ReadGuard(atomic<uint64_t>* slot, const WardrobeVersion* version) : slot(slot), version(version) {}
+
+        atomic<uint64_t>* slot;
+        const WardrobeVersion* version;
+    };
+
+    explicit VersionedWardrobe(Wardrobe initial = Wardrobe());
+    ~VersionedWardrobe();
+    VersionedWardrobe(const VersionedWardrobe&) = delete;
+    VersionedWardrobe& operator=(const VersionedWardrobe&) = delete;
+
+    ReadGuard read() const;
+    void write(uint8_t typeMask, const function<void(Wardrobe&)>& edit);
+    size_t retiredVersions();
+
+    friend void writeBoth(VersionedWardrobe& first, VersionedWardrobe& second,
+                          const function<void(Wardrobe&, Wardrobe&)>& edit, uint8_t typeMask);
+
+private:
+    // One cache line per slot, so readers announcing themselves do not share lines
+    struct alignas(64) ReaderSlot {
+        atomic<uint64_t> epoch{0};      // epoch the reader started in; 0 when free
+    };
+    struct Retired {
+        const WardrobeVersion* version;
+        uint64_t epoch;                 // epoch in which it was replaced
+    };
+
+    void publish(uint8_t typeMask);
+    void reclaim();
+
+    mutable ReaderSlot slots[MAX_READERS];
+    atomic<uint64_t> epoch{1};
+    atomic<const WardrobeVersion*> current{nullptr};
+    mutex writer;
+    Wardrobe master;                    // writers' indexed copy of the current version
+    vector<Retired> retired;
+};
+
+void writeBoth(VersionedWardrobe& first, VersionedWardrobe& second,
+               const function<void(Wardrobe&, Wardrobe&)>& edit, uint8_t typeMask = ALL_TYPES);
+
+// Writers for versioned wardrobes, matching the Wardrobe functions of the same names
+void addClothing(VersionedWardrobe& outfits, const vector<ClothingItem>& items);
+size_t removeClothing(VersionedWardrobe& outfits, const ClothingItem& item);
+void updateWardrobes(VersionedWardrobe& src, VersionedWardrobe& dest, const Wardrobe& stay,
+                     vector<ClothingItem>* moved = nullptr);
+size_t moveClothing(VersionedWardrobe& src, VersionedWardrobe& dest, const vector<ClothingItem>& items,
+                    vector<ClothingItem>* moved = nullptr);
+PickResult pickOutfits(VersionedWardrobe& outfits, VersionedWardrobe& dirty, size_t n, const PickOptions& options,
+                       Xoshiro256& rng = pickerRng());
+
+#endif
@@ -0,0 +1,135 @@
+#ifndef WARDROBESERVICE_H
+#define WARDROBESERVICE_H
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include "OutfitPicker.h"
+#include "OutfitCache.h"
+#include "Journal.h"
+#include "VersionedWardrobe.h"
+
+using namespace std;
+
+/* Service protocol (one request per line, fields separated by tabs):
+ *   user<TAB>command[<TAB>argument]...
+ *     add ITEM...                  add clean items
+ *     remove ITEM...               remove every matching clean item
+ *     laundry all | ITEM...        wash all dirty items, or all but the ITEMs given
+ *     laundry wash ITEM...         wash only the ITEMs given
+ *     pick [jacket] [rotate] [count=N] [seed=S] [day=YYYY-MM-DD]
+ *                                  wear N outfits (at most 100000)
+ *     best [jacket] [count=K]      the K best-scoring outfits, without wearing them (K at most 10000)
+ *     list [laundry]               clean (or dirty) items
+ *   ITEM is a CSV line as in outfits.csv; user is 1-64 of [A-Za-z0-9_.-], not starting with '.'.
+ *
+ * Every response starts with a status line:
+ *   OK n [dry=TYPE]    n lines follow: the item count for add/remove/laundry, one
+ *                      outfit per line for pick (dry=TYPE if it ran out), "score | outfit" per
+ *                      line for best, one item per line for list
+ *   ERR message        nothing follows
+ * Requests may be pipelined; responses come back in order.
+ */
+
+struct ServiceOptions {
+    string socketPath = "Other Files/outfitpicker.sock";
+    string dataDir = "Other Files/users";  // one directory per user holding its outfits/dirtyLaundry CSVs
+    size_t journalBatch = 64;               // records per journal write when requests are not synced
+    bool syncEachRequest = true;            // flush (fsync) the journal before answering a change
+    string rulesPath = "Other Files/styleRules.csv";    // style rules best scores with, read at start-up
+    size_t cacheBytes = OUTFIT_CACHE_DEFAULT_BYTES;     // cap of the plans kept for best
+    size_t maxAccounts = 1024;              // users kept loaded; the least recently used idle one makes room
+};
+
+/* WardrobeService
+ * Daemon that keeps every user's clean/dirty wardrobes in memory and serves
+ * the protocol above over a Unix domain socket.
+ *
+ * Details:
+ *   - One thread per connection; requests for different users run in parallel,
+ *     changes for one user are serialized by that user's lock.
+ *   - Wardrobes are VersionedWardrobes, so list reads a snapshot without the
+ *     user's lock and is never held up by that user's changes.
+ *   - A user's wardrobes are loaded (snapshots plus journal) on their first
+ *     request; every change is journaled as in command mode. Past maxAccounts
+ *     users, the one idle longest is unloaded, and a user's directory is only
+ *     created by their first add.
+ *   - Items to remove, wash or keep are looked up without interning their
+ *     attributes (see findAttribute), so requests cannot fill the dictionary.
+ *   - best reuses the scoring plan of a wardrobe that has not changed since
+ *     its last best request (see OutfitCache.h), shared by all users.
+ */
+class WardrobeService {
+public:
+    explicit WardrobeService(ServiceOptions options = ServiceOptions());
+    ~WardrobeService();
+    WardrobeService(const WardrobeService&) = delete;
+    WardrobeService& operator=(const WardrobeService&) = delete;
+
+    bool listen();
+    void serve();
+    void stop();
+    void handle(string_view request, OutputBuffer& out);
+    size_t accounts();
+    OutfitCacheStats cacheStats() const { return cache.stats(); }
+
+private:
+    struct Account {
+        mutex lock;                 // serializes changes, loading and the journal
+        atomic<bool> loaded{false};
+        atomic<uint64_t> lastUsed{0};   // useClock at the latest request, for unloading
+        bool stored = false;            // the user's directory exists
+        unique_ptr<Journal> journal;
+        VersionedWardrobe outfits;
+        VersionedWardrobe dirty;
+    };
+
+    void answer(string_view request, OutputBuffer& out);
+    shared_ptr<Account> account(string_view user);
+    bool unloadIdleAccount();
+    bool listWardrobe(Account& user, const vector<string_view>& fields, OutputBuffer& out);
+    void serveConnection(int fd);
+
+    ServiceOptions options;
+    StyleRules rules;
+    OutfitCache cache;
+    shared_mutex accountsLock;
+    unordered_map<string, shared_ptr<Account>> users;
+    atomic<uint64_t> useClock{0};
+    int listenFd = -1;
+    atomic<bool> stopping{false};
+    mutex connectionsLock;
+    condition_variable connectionsDone;
+    unordered_set<int> connections;
+};
+
+/* ServiceClient
+ * Blocking client for the service protocol, used by scripts and the load generator.
+ */
+class ServiceClient {
+public:
+    ServiceClient() = default;
+    ~ServiceClient();
+    ServiceClient(const ServiceClient&) = delete;
+    ServiceClient& operator=(const ServiceClient&) = delete;
+
+    bool connect(const string& socketPath);
+    bool request(string_view line, vector<string>& response);
+    void close();
+
+private:
+    bool readLine(string& line);
+
+    int fd = -1;
+    string received;
+};
+
+int runService(const ServiceOptions& options);
+
+#endif
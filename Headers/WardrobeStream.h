@@ -0,0 +1,96 @@
+#ifndef WARDROBESTREAM_H
+#define WARDROBESTREAM_H
+
+#include <cstdio>
+#include <functional>
+#include <string>
+#include <vector>
+#include "OutfitPicker.h"
+#include "Snapshot.h"
+
+using namespace std;
+
+// Default read buffer of a WardrobeStream, in bytes
+const size_t STREAM_BUDGET = 1 << 20;
+// Smallest buffer a WardrobeStream uses, whatever budget it is given
+const size_t STREAM_MIN_BUDGET = 256;
+
+/* WardrobeStream
+ * Reads a wardrobe file one item at a time without loading it, for files
+ * too large to hold in memory.
+ *
+ * Details:
+ *   - CSV files are read through one buffer of budget bytes, refilled in
+ *     place; that buffer and the attribute dictionary (which grows with the
+ *     distinct attribute strings, not with items) are all the memory used.
+ *   - Lines that do not parse, or are longer than the buffer, are skipped
+ *     and counted in skipped().
+ *   - Binary snapshots are read in place from their mapping, type by type;
+ *     their pages belong to the file, so the kernel can drop them again.
+ *   - A missing file reads as empty, like loadDatabase.
+ */
+class WardrobeStream {
+public:
+    explicit WardrobeStream(const string& filename, size_t budget = STREAM_BUDGET);
+    ~WardrobeStream();
+    WardrobeStream(const WardrobeStream&) = delete;
+    WardrobeStream& operator=(const WardrobeStream&) = delete;
+
+    bool next(ClothingItem& item);
+    uint64_t skipped() const { return skippedLines; }
+    uint64_t bytesRead() const { return bytes; }
+
+private:
+    bool refill();
+
+    FILE* file = nullptr;
+    vector<char> buffer;
+    size_t begin = 0;               // first unread byte in buffer
+    size_t end = 0;                 // one past the last byte read into buffer
+    bool discarding = false;        // inside a line longer than the buffer
+    uint64_t skippedLines = 0;
+    uint64_t parsed = 0;            // CSV items returned, for STAT_ITEMS_PARSED
+    uint64_t bytes = 0;
+    // Snapshot files only
+    bool snapshot = false;
+    SnapshotView view;
+    uint8_t type = JACKET;
+    size_t position = 0;
+};
+
+// Per-type callbacks for streamDatabase; an empty one skips items of its type
+struct ClothingHandlers {
+    function<void(const ClothingItem&)> byType[4];
+};
+
+/* ClothingReservoir
+ * Uniform random sample of up to perType items of each type from a stream
+ * of unknown length, in one pass (reservoir sampling).
+ */
+class ClothingReservoir {
+public:
+    explicit ClothingReservoir(size_t perType = 1) : capacity(perType) {}
+
+    void offer(const ClothingItem& item, Xoshiro256& rng);
+    const vector<ClothingItem>& sample(uint8_t type) const { return samples[type]; }
+    uint64_t seen(uint8_t type) const { return counts[type]; }
+
+private:
+    size_t capacity;
+    vector<ClothingItem> samples[4];
+    uint64_t counts[4] = {0, 0, 0, 0};
+};
+
+// What one pass over a streamed file saw
+struct StreamSummary {
+    uint64_t items[4] = {0, 0, 0, 0};   // items per ClothingType
+    uint64_t skipped = 0;               // lines that were not items
+    uint64_t bytes = 0;                 // bytes read
+};
+
+uint64_t streamDatabase(const string& filename, const ClothingHandlers& handlers, size_t budget = STREAM_BUDGET,
+                        StreamSummary* summary = nullptr);
+PickResult sampleOutfits(const string& filename, size_t n, bool jacket, Xoshiro256& rng = pickerRng(),
+                         size_t budget = STREAM_BUDGET, StreamSummary* summary = nullptr);
+
+#endif
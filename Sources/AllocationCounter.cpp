@@ -0,0 +1,46 @@
+/* Nolan Pierce - Allocation Counter Implementation
+ *
+ * Overview:
+ *   Replaces the global allocation functions so every operator new is
+ *   counted in STAT_ALLOCATIONS (see countAllocation in Stats.cpp).
+ *
+ * Details:
+ *   - Built apart from outfitpicker_core and linked only into the programs
+ *     that report allocations (OutfitPicker and allocBench), so other programs
+ *     using the library keep the standard allocator. Elsewhere the counter
+ *     stays at 0.
+ */
+#include "../Headers/Stats.h"
+#include <cstdlib>
+#include <new>
+
+using namespace std;
+
+#ifdef OUTFIT_STATS
+void* operator new(size_t bytes) {
+    countAllocation();
+    if (void* block = malloc(bytes ? bytes : 1)) return block;
+    throw bad_alloc();
+}
+
+void* operator new(size_t bytes, align_val_t alignment) {
+    countAllocation();
+    size_t align = size_t(alignment);
+#ifdef _WIN32
+    if (void* block = _aligned_malloc(bytes ? bytes : 1, align)) return block;
+#else
+    if (void* block = aligned_alloc(align, (bytes + align - 1) / align * align + (bytes ? 0 : align))) return block;
+#endif
+    throw bad_alloc();
+}
+
+void operator delete(void* block) noexcept { free(block); }
+void operator delete(void* block, size_t) noexcept { free(block); }
+#ifdef _WIN32
+void operator delete(void* block, align_val_t) noexcept { _aligned_free(block); }
+void operator delete(void* block, size_t, align_val_t) noexcept { _aligned_free(block); }
+#else
+void operator delete(void* block, align_val_t) noexcept { free(block); }
+void operator delete(void* block, size_t, align_val_t) noexcept { free(block); }
+#endif
+#endif
@@ -0,0 +1,145 @@
+/* Nolan Pierce - Attribute Dictionary Implementation
+ *
+ * Overview:
+ *   Interns the material, color and pattern strings used by ClothingItem.
+ *   A real wardrobe only has a few dozen distinct values, so every item stores
+ *   small IDs and the strings themselves live here exactly once.
+ */
+#include "../Headers/AttributeDictionary.h"
+#include <deque>
+#include <limits>
+#include <mutex>
+#include <shared_mutex>
+#include <stdexcept>
+#include <unordered_map>
+
+using namespace std;
+
+struct Dictionary {
+    shared_mutex lock;
+    deque<string> names;                        //deque keeps references stable as it grows
+    unordered_map<string_view, AttributeId> ids; //keys view into names
+};
+
+static Dictionary& dictionary() {
+    static Dictionary instance;
+    return instance;
+}
+
+/* internAttribute
+ * Returns the ID for an attribute value, adding it to the dictionary if new.
+ *
+ * Parameters:
+ *   value - attribute text, e.g. "cotton"; need not outlive the call.
+ *
+ * Returns:
+ *   ID that attributeName maps back to the same text.
+ *
+ * Throws:
+ *   runtime_error if the dictionary already holds the maximum number of values
+ *   (65535; the ID 0xFFFF is kept back as a marker, e.g. for "any value").
+ *
+ * Details:
+ *   - Each thread keeps a private cache of IDs it has seen, so bulk loads
+ *     only take the shared lock the first time a value appears.
+ */
+AttributeId internAttribute(string_view value) {
+    thread_local unordered_map<string_view, AttributeId> cache;
+    auto cached = cache.find(value);
+    if (cached != cache.end()) return cached->second;
+
+    Dictionary& dict = dictionary();
+    {
+        shared_lock<shared_mutex> reading(dict.lock);
+        auto found = dict.ids.find(value);
+        if (found != dict.ids.end()) {
+            cache.emplace(found->first, found->second);
+            return found->second;
+        }
+    }
+
+    unique_lock<shared_mutex> writing(dict.lock);
+    auto found = dict.ids.find(value);      //another thread may have added it meanwhile
+    if (found == dict.ids.end()) {
+        //The largest ID is never handed out; filters and snapshots use it as a marker
+        if (dict.names.size() >= numeric_limits<AttributeId>::max())
+            throw runtime_error("Too many distinct clothing attributes to store: " + string(value));
+        dict.names.emplace_back(value);
+        found = dict.ids.emplace(dict.names.back(), AttributeId(dict.names.size() - 1)).first;
+    }
+    cache.emplace(found->first, found->second);
+    return found->second;
+}
+
+/* findAttribute
+ * Looks up the ID of an attribute value without adding it.
+ *
+ * Parameters:
+ *   value - attribute text to look for.
+ *   id    - set to its ID if found.
+ *
+ * Returns:
+ *   false if the value was never interned, so no item can have it.
+ *
+ * Details:
+ *   - For matching text that comes from outside, e.g. a service request to
+ *     remove an item, which must not grow the table for every typo.
+ */
+bool findAttribute(string_view value, AttributeId& id) {
+    Dictionary& dict = dictionary();
+    shared_lock<shared_mutex> reading(dict.lock);
+    auto found = dict.ids.find(value);
+    if (found == dict.ids.end()) return false;
+    id = found->second;
+    return true;
+}
+
+/* attributeName
+ * Decodes an attribute ID back into its text.
+ *
+ * Parameters:
+ *   id - ID previously returned by internAttribute.
+ *
+ * Returns:
+ *   Reference to the interned string, valid for the life of the program.
+ */
+const string& attributeName(AttributeId id) {
+    Dictionary& dict = dictionary();
+    shared_lock<shared_mutex> reading(dict.lock);
+    return dict.names.at(id);
+}
+
+/* attributeTable
+ * Returns every interned value indexed by ID.
+ *
+ * Details:
+ *   - Lets output code decode many items with one lock instead of one per field.
+ *   - Values interned after the call are not included.
+ */
+vector<string_view> attributeTable() {
+    Dictionary& dict = dictionary();
+    shared_lock<shared_mutex> reading(dict.lock);
+    return vector<string_view>(dict.names.begin(), dict.names.end());
+}
+
+/* attributeTable
+ * Fills a caller-owned table with every interned value indexed by ID.
+ *
+ * Parameters:
+ *   into - table to overwrite; its capacity is reused, so repeated calls
+ *          only allocate when new values have been interned.
+ */
+void attributeTable(vector<string_view>& into) {
+    Dictionary& dict = dictionary();
+    shared_lock<shared_mutex> reading(dict.lock);
+    into.assign(dict.names.begin(), dict.names.end());
+}
+
+/* attributeCount
+ * Returns the number of distinct attribute values interned so far.
+ */
+size_t attributeCount() {
+    Dictionary& dict = dictionary();
+    shared_lock<shared_mutex> reading(dict.lock);
+    return dict.names.size();
+}
@@ -0,0 +1,361 @@
+/* Nolan Pierce - Clothing Search Implementation
+ *
+ * Overview:
+ *   Finds the items in a wardrobe closest to one the user typed, so a typo in
+ *   removeClothing or the laundry prompt offers the likely item instead of
+ *   making the user type all five fields again.
+ *
+ * Details:
+ *   - Closeness is the sum of per-field distances: TYPE_MISMATCH_COST and
+ *     LENGTH_MISMATCH_COST for the type and length, and attributeDistance
+ *     (typos, or a prefix of the value) for material, color and pattern.
+ *   - A wardrobe has few distinct attribute values however many items it
+ *     holds, so every value in use (from suggestIndex) is scored against
+ *     what was typed, a few word operations per character (TypedAttribute);
+ *     that is the only part that looks at strings.
+ *   - Item kinds are then visited in order of distance, as sums of one choice
+ *     per field from the sorted value lists, and each is checked in the hash
+ *     index. In a dense wardrobe only the kinds near the answer are looked at.
+ *   - A sparse wardrobe, with many values and few items of each kind, makes
+ *     that walk probe kinds it does not have. After SUGGEST_PROBE_LIMIT probes
+ *     the kinds are found through suggestIndex's per-value kind lists instead,
+ *     closest values first, which only reads the lists of near values.
+ */
+#include "../Headers/ClothingSearch.h"
+#include <algorithm>
+#include <climits>
+#include <queue>
+#include <unordered_set>
+
+using namespace std;
+
+// Kinds checked in distance order before going through the kind lists instead
+static const size_t SUGGEST_PROBE_LIMIT = 64;
+
+/* shortcutDistance
+ * Handles the cases attributeDistance answers without measuring edits.
+ *
+ * Returns:
+ *   The distance for equal text, a prefix, or lengths too far apart; UINT_MAX otherwise.
+ */
+static unsigned shortcutDistance(string_view typed, string_view value, unsigned limit) {
+    if (typed == value) return 0;
+    if (!typed.empty() && value.size() > typed.size() && value.substr(0, typed.size()) == typed)
+        return min(1u, limit + 1);
+    size_t n = typed.size();
+    size_t m = value.size();
+    if ((n > m ? n - m : m - n) > limit) return limit + 1;
+    return UINT_MAX;
+}
+
+// Typed attribute text prepared for measuring against many values at one bit per character
+struct TypedAttribute {
+    string_view text;
+    uint64_t where[256] = {};       // per byte value: bit i set if text[i] is that byte
+
+    explicit TypedAttribute(string_view text) : text(text) {
+        for (size_t i = 0; i < text.size() && i < 64; i++) where[(unsigned char)text[i]] |= uint64_t(1) << i;
+    }
+    unsigned distance(string_view value, unsigned limit) const;
+};
+
+/* distance
+ * attributeDistance from this text to a value; the text must be at most 64 characters.
+ *
+ * Details:
+ *   - Hyyrö's bit-vector form of the optimal string alignment table: one
+ *     column of the table is a pair of 64-bit masks of +1/-1 steps, updated
+ *     in a few word operations per character of value.
+ */
+unsigned TypedAttribute::distance(string_view value, unsigned limit) const {
+    unsigned shortcut = shortcutDistance(text, value, limit);
+    if (shortcut != UINT_MAX) return shortcut;
+    size_t n = text.size();
+    if (n == 0) return min(unsigned(value.size()), limit + 1);
+
+    uint64_t last = uint64_t(1) << (n - 1);
+    uint64_t up = n == 64 ? ~uint64_t(0) : (uint64_t(1) << n) - 1;     //vertical +1 steps
+    uint64_t down = 0;                                                  //vertical -1 steps
+    uint64_t diagonal = 0;
+    uint64_t previousMatch = 0;
+    unsigned score = unsigned(n);
+    for (char c : value) {
+        uint64_t match = where[(unsigned char)c];
+        uint64_t swapped = ((~diagonal & match) << 1) & previousMatch;
+        diagonal = (((match & up) + up) ^ up) | match | down | swapped;
+        uint64_t right = down | ~(diagonal | up);
+        uint64_t left = diagonal & up;
+        if (right & last) score++;
+        if (left & last) score--;
+        right = (right << 1) | 1;
+        left <<= 1;
+        up = left | ~(diagonal | right);
+        down = diagonal & right;
+        previousMatch = match;
+    }
+    return min(score, limit + 1);
+}
+
+/* attributeDistance
+ * Measures how far a typed attribute is from a stored one.
+ *
+ * Parameters:
+ *   typed - what the user entered.
+ *   value - an attribute value of the wardrobe.
+ *   limit - largest distance of interest; the search stops early past it.
+ *
+ * Returns:
+ *   0 if equal, 1 if typed is a shorter prefix of value ("cot" for cotton),
+ *   otherwise the number of single-character insertions, deletions,
+ *   substitutions and adjacent swaps between them; limit + 1 if that is more
+ *   than limit.
+ *
+ * Details:
+ *   - Typed text of up to 64 characters is measured with TypedAttribute;
+ *     suggestClothing prepares one per field and reuses it for every value.
+ */
+unsigned attributeDistance(string_view typed, string_view value, unsigned limit) {
+    if (typed.size() <= 64) return TypedAttribute(typed).distance(value, limit);
+    unsigned shortcut = shortcutDistance(typed, value, limit);
+    if (shortcut != UINT_MAX) return shortcut;
+    size_t n = typed.size();
+    size_t m = value.size();
+
+    //Optimal string alignment over three rolling rows of the distance table
+    thread_local vector<unsigned> rows;
+    rows.assign(3 * (m + 1), 0);
+    unsigned* twoBack = rows.data();
+    unsigned* previous = twoBack + (m + 1);
+    unsigned* current = previous + (m + 1);
+    for (size_t j = 0; j <= m; j++) previous[j] = unsigned(j);
+    for (size_t i = 1; i <= n; i++) {
+        current[0] = unsigned(i);
+        unsigned rowBest = current[0];
+        for (size_t j = 1; j <= m; j++) {
+            unsigned substitution = previous[j - 1] + (typed[i - 1] != value[j - 1]);
+            unsigned distance = min({previous[j] + 1, current[j - 1] + 1, substitution});
+            if (i > 1 && j > 1 && typed[i - 1] == value[j - 2] && typed[i - 2] == value[j - 1])
+                distance = min(distance, twoBack[j - 2] + 1);
+            current[j] = distance;
+            rowBest = min(rowBest, distance);
+        }
+        if (rowBest > limit) return limit + 1;
+        unsigned* oldest = twoBack;
+        twoBack = previous;
+        previous = current;
+        current = oldest;
+    }
+    return min(previous[m], limit + 1);
+}
+
+// One field's possible values, closest first
+struct SearchDimension {
+    vector<pair<unsigned, uint32_t>> choices;   // distance, value
+
+    void sort() { std::sort(choices.begin(), choices.end()); }
+    unsigned distance(size_t at) const { return choices[at].first; }
+    uint32_t value(size_t at) const { return choices[at].second; }
+    size_t size() const { return choices.size(); }
+};
+
+// A combination of one choice per dimension: type, length, material, color, pattern
+struct SearchState {
+    unsigned distance;
+    uint32_t at[5];
+
+    bool operator>(const SearchState& other) const { return distance > other.distance; }
+    uint64_t packed() const {
+        return uint64_t(at[0]) | uint64_t(at[1]) << 2 | uint64_t(at[2]) << 3 | uint64_t(at[3]) << 19 |
+               uint64_t(at[4]) << 35;
+    }
+};
+
+/* kindOf
+ * Unpacks a clothingKey back into the item it was made from, without wear history.
+ */
+static ClothingItem kindOf(uint64_t key) {
+    ClothingItem item;
+    item.material = AttributeId(key);
+    item.color = AttributeId(key >> 16);
+    item.pattern = AttributeId(key >> 32);
+    item.type = uint8_t(key >> 48);
+    item.isLong = (key >> 56) != 0;
+    return item;
+}
+
+/* byCloseness
+ * Orders matches closest first, then by most copies, then by key so ties are stable.
+ */
+static bool byCloseness(const ClothingMatch& a, const ClothingMatch& b) {
+    if (a.distance != b.distance) return a.distance < b.distance;
+    if (a.copies != b.copies) return a.copies > b.copies;
+    return clothingKey(a.item) < clothingKey(b.item);
+}
+
+/* listedKinds
+ * Finds the closest kinds through the suggestIndex kind lists of the near values.
+ *
+ * Parameters:
+ *   values - material, color and pattern dimensions, closest value first.
+ *   costs  - per field, each value's distance from what was typed; UINT_MAX if too far.
+ *
+ * Details:
+ *   - Level r visits the kinds whose closest attribute is r away, through the
+ *     lists of the values at distance r. Each kind is taken from the first field
+ *     at its closest distance only, so none is looked at twice.
+ *   - A kind not reached by level r has every attribute more than r away, so at
+ *     least 3 * (r + 1) in all. Once limit matches are no further than that, the
+ *     rest cannot beat or tie them and the walk stops.
+ *   - Each value's kinds are listed per type and length, so a list whose type
+ *     and length alone put it past the limit-th match is skipped whole.
+ */
+static void listedKinds(const Wardrobe& outfits, const ClothingItem& typed, const SearchDimension values[3],
+                        const vector<unsigned> costs[3], size_t limit, unsigned maxDistance,
+                        vector<ClothingMatch>& matches) {
+    unsigned cutoff = maxDistance;
+    size_t trimAt = 2 * limit;
+    for (unsigned level = 0; 3 * level <= cutoff; level++) {
+        for (int field = 0; field < 3; field++) {
+            const vector<vector<uint64_t>>& lists = outfits.index.valueKinds[field];
+            for (size_t at = 0; at < values[field].size() && values[field].distance(at) <= level; at++) {
+                AttributeId value = AttributeId(values[field].value(at));
+                if (values[field].distance(at) < level || kindSlot(value, SHOES, true) >= lists.size()) continue;
+                for (uint8_t type = JACKET; type <= SHOES; type++) {
+                    for (int isLong = 0; isLong < 2; isLong++) {
+                        unsigned shape = (type == typed.type ? 0 : TYPE_MISMATCH_COST) +
+                                         (bool(isLong) == typed.isLong ? 0 : LENGTH_MISMATCH_COST);
+                        if (3 * level + shape > cutoff) continue;
+                        for (uint64_t key : lists[kindSlot(value, type, isLong)]) {
+                            const AttributeId ids[3] = {AttributeId(key), AttributeId(key >> 16), AttributeId(key >> 32)};
+                            unsigned distance = shape;
+                            bool first = true;
+                            for (int other = 0; other < 3 && first; other++) {
+                                unsigned cost = ids[other] < costs[other].size() ? costs[other][ids[other]] : UINT_MAX;
+                                first = cost != UINT_MAX && cost >= level && (cost > level || other >= field);
+                                distance += first ? cost : 0;
+                            }
+                            if (!first || distance > cutoff) continue;
+                            auto found = outfits.index.positions.find(key);
+                            if (found->second.empty()) continue;
+                            matches.push_back({kindOf(key), distance, found->second.size()});
+                        }
+                    }
+                }
+                //Keep the limit closest, and every match tied with the last of them
+                if (matches.size() < trimAt) continue;
+                nth_element(matches.begin(), matches.begin() + (limit - 1), matches.end(), byCloseness);
+                cutoff = matches[limit - 1].distance;
+                matches.erase(remove_if(matches.begin(), matches.end(),
+                                        [&](const ClothingMatch& match) { return match.distance > cutoff; }),
+                              matches.end());
+                trimAt = max(2 * limit, 2 * matches.size());
+            }
+        }
+        if (matches.size() >= limit) {
+            nth_element(matches.begin(), matches.begin() + (limit - 1), matches.end(), byCloseness);
+            cutoff = min(cutoff, matches[limit - 1].distance);
+        }
+    }
+}
+
+/* suggestClothing
+ * Finds the kinds of item in a wardrobe closest to a typed one.
+ *
+ * Parameters:
+ *   outfits     - wardrobe to search; suggestIndex is built on first use.
+ *   typed       - the item as entered, e.g. by getUsersClothing.
+ *   limit       - most suggestions to return.
+ *   maxDistance - furthest suggestion worth offering.
+ *
+ * Returns:
+ *   Up to limit distinct kinds within maxDistance, closest first, then those
+ *   the wardrobe has most copies of. An exact match comes first with distance 0.
+ */
+vector<ClothingMatch> suggestClothing(Wardrobe& outfits, const ClothingItem& typed, size_t limit,
+                                      unsigned maxDistance) {
+    vector<ClothingMatch> matches;
+    if (limit == 0) return matches;
+    suggestIndex(outfits);
+    thread_local vector<string_view> names;
+    attributeTable(names);
+
+    SearchDimension dimensions[5];
+    for (uint8_t type = JACKET; type <= SHOES; type++)
+        dimensions[0].choices.push_back({type == typed.type ? 0 : TYPE_MISMATCH_COST, type});
+    dimensions[1].choices.push_back({0, typed.isLong});
+    dimensions[1].choices.push_back({LENGTH_MISMATCH_COST, !typed.isLong});
+
+    //Score every value in use once; costs[field][id] serves the kind-list walk
+    const AttributeId typedValues[3] = {typed.material, typed.color, typed.pattern};
+    thread_local vector<unsigned> costs[3];
+    for (int field = 0; field < 3; field++) {
+        const vector<uint32_t>& uses = outfits.index.valueUses[field];
+        string_view text = names[typedValues[field]];
+        TypedAttribute prepared(text);
+        costs[field].assign(uses.size(), UINT_MAX);
+        for (size_t id = 0; id < uses.size(); id++) {
+            if (uses[id] == 0) continue;
+            unsigned distance = text.size() <= 64 ? prepared.distance(names[id], maxDistance)
+                                                  : attributeDistance(text, names[id], maxDistance);
+            if (distance > maxDistance) continue;
+            costs[field][id] = distance;
+            dimensions[2 + field].choices.push_back({distance, uint32_t(id)});
+        }
+    }
+    for (auto& dimension : dimensions) {
+        dimension.sort();
+        if (dimension.size() == 0) return matches;
+    }
+
+    auto itemAt = [&](const uint32_t at[5]) {
+        ClothingItem item;
+        item.type = uint8_t(dimensions[0].value(at[0]));
+        item.isLong = dimensions[1].value(at[1]) != 0;
+        item.material = AttributeId(dimensions[2].value(at[2]));
+        item.color = AttributeId(dimensions[3].value(at[3]));
+        item.pattern = AttributeId(dimensions[4].value(at[4]));
+        return item;
+    };
+
+    //Best-first walk over combinations; once limit are found, finish their distance so ties all count
+    priority_queue<SearchState, vector<SearchState>, greater<SearchState>> frontier;
+    unordered_set<uint64_t> seen;
+    SearchState start{0, {0, 0, 0, 0, 0}};
+    for (size_t d = 0; d < 5; d++) start.distance += dimensions[d].distance(0);
+    frontier.push(start);
+    seen.insert(start.packed());
+    unsigned cutoff = maxDistance;
+    size_t probes = 0;
+    bool scan = false;
+    while (!frontier.empty()) {
+        SearchState state = frontier.top();
+        frontier.pop();
+        if (state.distance > cutoff) break;
+        if (++probes > SUGGEST_PROBE_LIMIT) {
+            scan = true;
+            break;
+        }
+        ClothingItem item = itemAt(state.at);
+        auto found = outfits.index.positions.find(clothingKey(item));
+        if (found != outfits.index.positions.end() && !found->second.empty()) {
+            matches.push_back({item, state.distance, found->second.size()});
+            if (matches.size() == limit) cutoff = state.distance;
+        }
+        for (size_t d = 0; d < 5; d++) {
+            if (state.at[d] + 1 >= dimensions[d].size()) continue;
+            SearchState next = state;
+            next.at[d]++;
+            next.distance += dimensions[d].distance(next.at[d]) - dimensions[d].distance(state.at[d]);
+            if (next.distance <= cutoff && seen.insert(next.packed()).second) frontier.push(next);
+        }
+    }
+
+    if (scan) {
+        matches.clear();
+        listedKinds(outfits, typed, dimensions + 2, costs, limit, maxDistance, matches);
+    }
+
+    sort(matches.begin(), matches.end(), byCloseness);
+    if (matches.size() > limit) matches.resize(limit);
+    return matches;
+}
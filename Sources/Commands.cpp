@@ -0,0 +1,477 @@
+/* Nolan Pierce - Command Mode Implementation
+ *
+ * Overview:
+ *   Lets scripts drive the Outfit Picker without the interactive prompts.
+ *   Each command loads the wardrobes, applies its whole batch of changes at
+ *   once, appends them to the journal, and prints a one-line summary.
+ *
+ * Commands:
+ *   add    [--file FILE]... [ITEM]...   add items from CSV files and/or arguments
+ *   remove [--file FILE]... [ITEM]...   remove every matching clean item; the closest items
+ *                                       to any that is not found are listed on stderr
+ *   laundry (--all | --keep FILE | --wash FILE)
+ *                                       wash all dirty clothes, all but those in FILE,
+ *                                       or only those in FILE
+ *   pick [--jacket] [--count N] [--seed S] [--rotate]
+ *        [--day DATE] [--weather] [--conditions FILE] [--temperature C] [--precipitation MM]
+ *                                       plan N outfits, one CSV line per outfit, one per
+ *                                       day from DATE (default today); --rotate wears the
+ *                                       least recently worn clothes; with weather options,
+ *                                       each is dressed by the forecast file or fixed values
+ *   best [--jacket] [--count K] [--rules FILE]
+ *                                       print the K best-scoring outfits without wearing them
+ *   list [--laundry] [--compact | --tsv]
+ *                                       print the clean or dirty wardrobe, readable or as CSV/TSV
+ *   sample [--file FILE] [--count N] [--jacket] [--seed S] [--budget BYTES]
+ *                                       stream FILE (default the outfits file) once through a
+ *                                       BYTES buffer and print N random outfits from it, without
+ *                                       loading or changing anything, plus per-type counts
+ *   compact                             fold the change journal into the CSV files
+ *   convert IN OUT                      copy a wardrobe file between CSV and binary (".bin")
+ *   serve [--socket PATH] [--data DIR] [--no-sync] [--rules FILE] [--cache-mb MB]
+ *                                       run the multi-user wardrobe service (see WardrobeService.h);
+ *                                       best answers use FILE and keep up to MB of scoring plans
+ *
+ *   ITEM is a CSV line: type,isLong,material,color,pattern[,wearCount,lastWorn]
+ *   --outfits FILE and --dirty FILE override the default database paths; either
+ *   may be a binary snapshot ending in ".bin".
+ *   --stats or --stats=json, with or without a command, prints the profiling
+ *   counters to stderr at exit (handled in main, see Stats.h).
+ */
+#include "../Headers/Commands.h"
+#include "../Headers/OutfitPicker.h"
+#include "../Headers/MappedFile.h"
+#include "../Headers/Journal.h"
+#include "../Headers/OutfitScorer.h"
+#include "../Headers/ClothingSearch.h"
+#include "../Headers/Conditions.h"
+#include "../Headers/WardrobeService.h"
+#include "../Headers/WardrobeStream.h"
+#include <algorithm>
+#include <charconv>
+#include <cstdint>
+#include <cstdlib>
+
+using namespace std;
+
+struct CommandOptions {
+    string command;
+    string outfitsPath = "Other Files/outfits.csv";
+    string dirtyPath = "Other Files/dirtyLaundry.csv";
+    vector<string> files;           //--file / --keep / --wash arguments
+    vector<ClothingItem> items;     //items given directly on the command line
+    bool all = false;
+    bool wash = false;                      //laundry washes the items in files instead of keeping them dirty
+    bool keep = false;                      //a --keep file was given; never mixed with --wash
+    bool jacket = false;
+    bool rotate = false;                    //least recently worn clothes instead of random ones
+    size_t count = 1;
+    bool seeded = false;
+    uint64_t seed = 0;
+    bool laundry = false;                   //list the dirty wardrobe instead of the clean one
+    OutputMode mode = OUTPUT_PRETTY;
+    string rulesPath = "Other Files/styleRules.csv";
+    bool weather = false;                   //dress each picked outfit for its day's weather
+    string conditionsPath = "Other Files/conditions.csv";
+    bool stub = false;                      //fixed --temperature/--precipitation instead of the file
+    Conditions stubConditions;
+    int64_t firstDay = today();
+    size_t budget = STREAM_BUDGET;          //read buffer of sample, in bytes
+    ServiceOptions service;
+};
+
+/* printUsage
+ * Writes the command-line help to stderr.
+ */
+static void printUsage() {
+    cerr << "Usage: OutfitPicker [command] [options]\n"
+            "  (no command)                       interactive mode\n"
+            "  add    [--file FILE]... [ITEM]...  add clothes from CSV files or arguments\n"
+            "  remove [--file FILE]... [ITEM]...  remove matching clean clothes\n"
+            "  laundry --all | --keep FILE | --wash FILE\n"
+            "                                     wash all dirty clothes, all but those in FILE, or those in FILE\n"
+            "  pick [--jacket] [--count N] [--seed S] [--rotate]\n"
+            "                                     plan N outfits and mark them dirty;\n"
+            "                                     --rotate wears the least recently worn clothes\n"
+            "       [--day DATE] [--weather] [--conditions FILE] [--temperature C] [--precipitation MM]\n"
+            "                                     one outfit per day from DATE, dressed for its weather\n"
+            "  best [--jacket] [--count K] [--rules FILE]\n"
+            "                                     print the K best-matching outfits with their scores\n"
+            "  list [--laundry] [--compact|--tsv] print the clean (or dirty) wardrobe\n"
+            "  sample [--file FILE] [--count N] [--jacket] [--seed S] [--budget BYTES]\n"
+            "                                     N random outfits from a file of any size, in one pass\n"
+            "  compact                            fold the change journal into the CSV files\n"
+            "  convert IN OUT                     copy a wardrobe file between CSV and binary (.bin)\n"
+            "  serve [--socket PATH] [--data DIR] [--no-sync] [--rules FILE] [--cache-mb MB]\n"
+            "                                     serve many users' wardrobes over a Unix socket\n"
+            "Options: --outfits FILE, --dirty FILE database paths\n"
+            "         --stats[=json]              print profiling counters to stderr at exit\n"
+            "ITEM format: type,isLong,material,color,pattern[,wearCount,lastWorn]\n";
+}
+
+/* takesValue
+ * Says whether an option reads the argument after it.
+ */
+static bool takesValue(string_view arg) {
+    static const string_view VALUE_OPTIONS[] = {
+        "--file", "--keep", "--wash", "--outfits", "--dirty", "--rules", "--socket", "--data", "--cache-mb",
+        "--conditions", "--temperature", "--precipitation", "--day", "--count", "--budget", "--seed"};
+    return find(begin(VALUE_OPTIONS), end(VALUE_OPTIONS), arg) != end(VALUE_OPTIONS);
+}
+
+/* parseNumber
+ * Reads an unsigned option value.
+ *
+ * Returns:
+ *   false and prints an error unless the whole text is a number.
+ */
+static bool parseNumber(string_view text, uint64_t& value) {
+    auto [end, error] = from_chars(text.data(), text.data() + text.size(), value);
+    if (!text.empty() && error == errc() && end == text.data() + text.size()) return true;
+    cerr << "Error: '" << text << "' is not a number.\n";
+    return false;
+}
+
+/* parseReal
+ * Reads a decimal option value such as a temperature.
+ *
+ * Returns:
+ *   false and prints an error unless the whole text is a number.
+ */
+static bool parseReal(const char* text, double& value) {
+    char* end;
+    value = strtod(text, &end);
+    if (end != text && *end == '\0') return true;
+    cerr << "Error: '" << text << "' is not a number.\n";
+    return false;
+}
+
+/* parseOptions
+ * Reads the command and its options from the argument list.
+ *
+ * Returns:
+ *   false and prints an error if any argument is not understood, an option
+ *   is missing its value, or a number is malformed.
+ */
+static bool parseOptions(int argc, char** argv, CommandOptions& options) {
+    options.command = argv[1];
+    for (int i = 2; i < argc; i++) {
+        string_view arg = argv[i];
+        if (takesValue(arg) && i + 1 >= argc) {
+            cerr << "Error: '" << arg << "' needs a value.\n";
+            return false;
+        }
+        uint64_t number;
+        if (arg == "--file" || arg == "--keep" || arg == "--wash") {
+            options.wash = options.wash || arg == "--wash";
+            options.keep = options.keep || arg == "--keep";
+            options.files.push_back(argv[++i]);
+        }
+        else if (arg == "--outfits") options.outfitsPath = argv[++i];
+        else if (arg == "--dirty") options.dirtyPath = argv[++i];
+        else if (arg == "--rules") options.rulesPath = argv[++i];
+        else if (arg == "--socket") options.service.socketPath = argv[++i];
+        else if (arg == "--data") options.service.dataDir = argv[++i];
+        else if (arg == "--no-sync") options.service.syncEachRequest = false;
+        else if (arg == "--cache-mb") {
+            if (!parseNumber(argv[++i], number)) return false;
+            if (number > (SIZE_MAX >> 20)) {
+                cerr << "Error: '" << argv[i] << "' MB is more than this machine can address.\n";
+                return false;
+            }
+            options.service.cacheBytes = size_t(number) << 20;
+        }
+        else if (arg == "--weather") options.weather = true;
+        else if (arg == "--conditions") {
+            options.conditionsPath = argv[++i];
+            options.weather = true;
+        }
+        else if (arg == "--temperature") {
+            if (!parseReal(argv[++i], options.stubConditions.temperature)) return false;
+            options.weather = options.stub = true;
+        }
+        else if (arg == "--precipitation") {
+            if (!parseReal(argv[++i], options.stubConditions.precipitation)) return false;
+            options.weather = options.stub = true;
+        }
+        else if (arg == "--day") {
+            if (!parseDay(argv[++i], options.firstDay)) {
+                cerr << "Error: '" << argv[i] << "' is not a YYYY-MM-DD date.\n";
+                return false;
+            }
+        }
+        else if (arg == "--count") {
+            if (!parseNumber(argv[++i], number)) return false;
+            options.count = size_t(number);
+        }
+        else if (arg == "--budget") {
+            if (!parseNumber(argv[++i], number)) return false;
+            options.budget = size_t(number);
+        }
+        else if (arg == "--seed") {
+            if (!parseNumber(argv[++i], options.seed)) return false;
+            options.seeded = true;
+        }
+        else if (arg == "--all") options.all = true;
+        else if (arg == "--jacket") options.jacket = true;
+        else if (arg == "--rotate") options.rotate = true;
+        else if (arg == "--laundry") options.laundry = true;
+        else if (arg == "--compact") options.mode = OUTPUT_COMPACT;
+        else if (arg == "--tsv") options.mode = OUTPUT_TSV;
+        else if (options.command == "convert" && arg.substr(0, 2) != "--") options.files.push_back(argv[i]);
+        else {
+            ClothingItem item;
+            if (arg.substr(0, 2) == "--" || !parseClothingLine(arg, item)) {
+                cerr << "Error: Unrecognized argument '" << arg << "'.\n";
+                return false;
+            }
+            options.items.push_back(item);
+        }
+    }
+    return true;
+}
+
+/* reportClosest
+ * Tells the user which items come closest to one that was not found.
+ */
+static void reportClosest(Wardrobe& outfits, const ClothingItem& item) {
+    vector<ClothingMatch> matches = suggestClothing(outfits, item, SUGGESTION_COUNT);
+    if (matches.empty()) return;
+    vector<string_view> names = attributeTable();
+    OutputBuffer out(stderr);
+    out.append("Not found: ");
+    formatClothing(out, item, names, OUTPUT_COMPACT);
+    out.append("; closest:\n");
+    for (const auto& match : matches) {
+        out.append("  ");
+        formatClothing(out, match.item, names, OUTPUT_COMPACT);
+        out.append('\n');
+    }
+    out.flush();
+}
+
+/* collectItems
+ * Gathers every item named by --file arguments and on the command line.
+ */
+static vector<ClothingItem> collectItems(const CommandOptions& options) {
+    vector<ClothingItem> items = options.items;
+    for (const auto& path : options.files) {
+        MappedFile file(path);
+        if (file.size() == 0) cerr << "Warning: '" << path << "' is missing or empty.\n";
+        Wardrobe fromFile = parseDatabase(file.view());
+        for (uint8_t type = JACKET; type <= SHOES; type++) {
+            const vector<ClothingItem>& typed = getType(fromFile, type);
+            items.insert(items.end(), typed.begin(), typed.end());
+        }
+    }
+    return items;
+}
+
+/* runCommand
+ * Runs one non-interactive command against the wardrobe databases.
+ *
+ * Parameters:
+ *   argc, argv - arguments passed to main; argv[1] is the command.
+ *
+ * Returns:
+ *   Process exit code: 0 on success, 1 on bad input or a failed save,
+ *   2 if pick ran out of clothes.
+ */
+int runCommand(int argc, char** argv) {
+    CommandOptions options;
+    if (!parseOptions(argc, argv, options)) {
+        printUsage();
+        return 1;
+    }
+    if (options.command != "add" && options.command != "remove" && options.command != "laundry" &&
+        options.command != "pick" && options.command != "best" && options.command != "list" &&
+        options.command != "compact" && options.command != "convert" && options.command != "serve" &&
+        options.command != "sample") {
+        cerr << "Error: Unknown command '" << options.command << "'.\n";
+        printUsage();
+        return 1;
+    }
+    if (options.command == "laundry" && options.all == !options.files.empty()) {
+        cerr << "Error: laundry needs exactly one of --all, --keep FILE or --wash FILE.\n";
+        return 1;
+    }
+    if (options.command == "laundry" && options.keep && options.wash) {
+        cerr << "Error: laundry takes --keep FILE or --wash FILE, not both.\n";
+        return 1;
+    }
+
+    if (options.command == "serve") {
+        options.service.rulesPath = options.rulesPath;
+        return runService(options.service);
+    }
+
+    if (options.command == "convert") {
+        if (options.files.size() != 2) {
+            cerr << "Error: convert needs an input and an output file.\n";
+            return 1;
+        }
+        //Converts the file as saved; run compact first to include journaled changes
+        try {
+            Wardrobe converted = loadDatabase(options.files[0]);
+            if (!pushDatabase(converted, options.files[1])) return 1;
+            cout << "Converted " << wardrobeSize(converted) << " items.\n";
+        } catch (const runtime_error& error) {
+            cerr << "Error: " << error.what() << "\n";
+            return 1;
+        }
+        return 0;
+    }
+
+    if (options.command == "sample") {
+        //Reads the file as saved, like convert, and never loads it whole
+        if (options.files.size() > 1) {
+            cerr << "Error: sample reads one file.\n";
+            return 1;
+        }
+        if (options.seeded) seedPicker(options.seed);
+        StreamSummary summary;
+        PickResult result;
+        try {
+            result = sampleOutfits(options.files.empty() ? options.outfitsPath : options.files[0], options.count,
+                                   options.jacket, pickerRng(), options.budget, &summary);
+        } catch (const runtime_error& error) {
+            cerr << "Error: " << error.what() << "\n";
+            return 1;
+        }
+
+        vector<string_view> names = attributeTable();
+        OutputBuffer& out = standardOutput();
+        for (const auto& outfit : result.outfits) formatOutfit(out, outfit, names);
+        out.flush();
+
+        cerr << "Read " << summary.items[JACKET] + summary.items[TOP] + summary.items[BOTTOM] + summary.items[SHOES]
+             << " items (" << summary.items[JACKET] << " jackets, " << summary.items[TOP] << " tops, "
+             << summary.items[BOTTOM] << " bottoms, " << summary.items[SHOES] << " shoes) in " << summary.bytes
+             << " bytes; skipped " << summary.skipped << " lines.\n";
+        cerr << "Seed: " << pickerSeed() << "\n";
+        if (result.ranDry) {
+            cerr << "Not enough " << typeName(result.dryType) << " items for more than "
+                 << result.outfits.size() << " outfits.\n";
+            return 2;
+        }
+        return 0;
+    }
+
+    Journal journal(options.outfitsPath, options.dirtyPath);
+    Wardrobe outfits;
+    Wardrobe dirty;
+    journal.load(outfits, dirty);
+    int status = 0;
+
+    if (options.command == "add") {
+        vector<ClothingItem> items = collectItems(options);
+        insertClothing(outfits, items);
+        journal.record(JOURNAL_ADD, items);
+        cout << "Added " << items.size() << " items.\n";
+    }
+    else if (options.command == "remove") {
+        size_t missing = 0;
+        vector<ClothingItem> removed;
+        for (const auto& item : collectItems(options)) {
+            size_t erased = eraseAllClothing(outfits, item);
+            removed.insert(removed.end(), erased, item);
+            missing += erased == 0;
+            if (erased == 0) reportClosest(outfits, item);
+        }
+        journal.record(JOURNAL_REMOVE, removed);
+        cout << "Removed " << removed.size() << " items; " << missing << " not found.\n";
+    }
+    else if (options.command == "laundry" && options.wash) {
+        //Only the named items change, however large the pile is
+        vector<ClothingItem> washed;
+        moveClothing(dirty, outfits, collectItems(options), &washed);
+        journal.record(JOURNAL_WASH, washed);
+        cout << "Washed " << washed.size() << " items.\n";
+    }
+    else if (options.command == "laundry") {
+        //Only items that really are dirty can stay dirty, as in promptLaundry
+        Wardrobe unwashed;
+        keyIndex(dirty);
+        for (const auto& item : collectItems(options)) {
+            if (countClothing(dirty, item) > 0) insertClothing(unwashed, item);
+        }
+        vector<ClothingItem> washed;
+        updateWardrobes(dirty, outfits, unwashed, &washed);
+        journal.record(JOURNAL_WASH, washed);
+        cout << "Washed " << washed.size() << " items.\n";
+    }
+    else if (options.command == "pick") {
+        if (options.seeded) seedPicker(options.seed);
+        PickOptions pick;
+        pick.jacket = options.jacket;
+        pick.rotation = options.rotate;
+        pick.day = options.firstDay;
+        PickResult result;
+        if (options.weather) {
+            //One outfit per day from the first day on, each dressed for that day's weather
+            FileConditionsProvider forecast(options.conditionsPath);
+            StubConditionsProvider fixed(options.stubConditions);
+            ConditionsProvider& provider = options.stub ? static_cast<ConditionsProvider&>(fixed) : forecast;
+            //Past the last top or bottom no day can be dressed; one day more still reports running dry
+            size_t dressable = min(getType(outfits, TOP).size(), getType(outfits, BOTTOM).size()) + 1;
+            size_t unknown = 0;
+            vector<PickOptions> days = adviseDays(provider, options.firstDay, min(options.count, dressable), pick,
+                                                  &unknown);
+            if (unknown > 0) cerr << "Warning: No weather for " << unknown << " of " << days.size() << " days.\n";
+            result = pickOutfitsForDays(outfits, dirty, days);
+        }
+        else result = pickOutfits(outfits, dirty, options.count, pick);
+
+        //Rendered into the shared buffer and written in large chunks, not once per item
+        vector<string_view> names = attributeTable();
+        OutputBuffer& out = standardOutput();
+        for (const auto& outfit : result.outfits) {
+            formatOutfit(out, outfit, names);
+            journal.record(JOURNAL_WORN, outfit.shoes);
+            journal.record(JOURNAL_WEAR, outfit.bottom);
+            journal.record(JOURNAL_WEAR, outfit.top);
+            if (outfit.hasJacket) journal.record(JOURNAL_WEAR, outfit.jacket);
+        }
+        out.flush();
+
+        cerr << "Seed: " << pickerSeed() << "\n";
+        if (result.ranDry) {
+            cerr << "Ran out of clean " << typeName(result.dryType) << " items after "
+                 << result.outfits.size() << " outfits.\n";
+            status = 2;
+        }
+    }
+    else if (options.command == "best") {
+        size_t skipped = 0;
+        StyleRules rules = loadStyleRules(options.rulesPath, &skipped);
+        if (rules.rules.empty())
+            cerr << "Warning: No style rules in '" << options.rulesPath << "'; every outfit scores 0.\n";
+        if (skipped > 0)
+            cerr << "Warning: Skipped " << skipped << " unreadable lines in '" << options.rulesPath << "'.\n";
+
+        PickOptions pick;
+        pick.jacket = options.jacket;
+        vector<string_view> names = attributeTable();
+        OutputBuffer& out = standardOutput();
+        for (const auto& scored : bestOutfits(outfits, rules, options.count, pick)) {
+            if (scored.score < 0) out.append('-');
+            out.appendNumber(uint64_t(scored.score < 0 ? -int64_t(scored.score) : scored.score));
+            out.append(" | ");
+            formatOutfit(out, scored.outfit, names);
+        }
+        out.flush();
+    }
+    else if (options.command == "list") {
+        printWardrobe(options.laundry ? dirty : outfits, options.mode);
+    }
+
+    //Only the changes are appended; the CSV snapshots are rewritten once the journal outgrows them
+    journal.flush();
+    bool compact = options.command == "compact" ||
+                   journal.needsCompaction(wardrobeSize(outfits) + wardrobeSize(dirty));
+    if (compact && !journal.compact(outfits, dirty)) {
+        cerr << "Error: Could not compact the journal into the CSV files.\n";
+        return 1;
+    }
+    return status;
+}
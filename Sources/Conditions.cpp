@@ -0,0 +1,146 @@
+/* Nolan Pierce - Conditions Implementation
+ *
+ * Overview:
+ *   Turns daily weather into outfit preferences: a jacket when it is cold or
+ *   wet, long or short sleeves and legs by temperature, and no rain-shy
+ *   materials on wet days. Weather comes from a ConditionsProvider, which is a
+ *   local forecast file or a fixed stub, as there is no network to call out to.
+ */
+#include "../Headers/Conditions.h"
+#include "../Headers/MappedFile.h"
+#include <cstdlib>
+
+using namespace std;
+
+// Materials that are better left at home in the rain
+static const char* RAIN_SHY_MATERIALS[] = {"suede", "silk", "canvas"};
+
+/* FileConditionsProvider
+ * Loads every day of a forecast file up front; a missing file knows no days.
+ *
+ * Details:
+ *   - Lines that are blank, start with '#' or cannot be read are skipped.
+ */
+FileConditionsProvider::FileConditionsProvider(const string& filename) {
+    MappedFile file(filename);
+    string_view contents = file.view();
+    while (!contents.empty()) {
+        size_t end = contents.find('\n');
+        string_view line = contents.substr(0, end);
+        contents.remove_prefix(end == string_view::npos ? contents.size() : end + 1);
+        if (!line.empty() && line.back() == '\r') line.remove_suffix(1);
+        if (line.empty() || line.front() == '#') continue;
+
+        size_t first = line.find(',');
+        size_t second = first == string_view::npos ? first : line.find(',', first + 1);
+        int64_t day;
+        if (second == string_view::npos || !parseDay(line.substr(0, first), day)) continue;
+
+        //strtod needs terminated text, and the mapped file is not
+        string temperature(line.substr(first + 1, second - first - 1));
+        string precipitation(line.substr(second + 1));
+        char* temperatureEnd;
+        char* precipitationEnd;
+        Conditions conditions;
+        conditions.temperature = strtod(temperature.c_str(), &temperatureEnd);
+        conditions.precipitation = strtod(precipitation.c_str(), &precipitationEnd);
+        if (temperature.empty() || *temperatureEnd != '\0' || precipitation.empty() || *precipitationEnd != '\0')
+            continue;
+        days[day] = conditions;
+    }
+}
+
+bool FileConditionsProvider::conditionsFor(int64_t day, Conditions& conditions) {
+    auto found = days.find(day);
+    if (found == days.end()) return false;
+    conditions = found->second;
+    return true;
+}
+
+bool StubConditionsProvider::conditionsFor(int64_t, Conditions& conditions) {
+    conditions = fixed;
+    return true;
+}
+
+/* adviseOutfit
+ * Adjusts pick options for a day's weather.
+ *
+ * Parameters:
+ *   conditions - the day's weather.
+ *   options    - options to start from; anything the weather says nothing about is kept.
+ *
+ * Returns:
+ *   options with a jacket below JACKET_BELOW_C or from RAIN_FROM_MM of rain,
+ *   long tops and bottoms preferred below LONG_BELOW_C and short ones from
+ *   SHORT_FROM_C, and rain-shy materials avoided on wet days.
+ */
+PickOptions adviseOutfit(const Conditions& conditions, PickOptions options) {
+    bool wet = conditions.precipitation >= RAIN_FROM_MM;
+    options.jacket = options.jacket || conditions.temperature < JACKET_BELOW_C || wet;
+    if (conditions.temperature < LONG_BELOW_C) options.length = LENGTH_LONG;
+    else if (conditions.temperature >= SHORT_FROM_C) options.length = LENGTH_SHORT;
+    if (wet) {
+        for (const char* material : RAIN_SHY_MATERIALS) options.avoidMaterials.push_back(internAttribute(material));
+    }
+    return options;
+}
+
+/* adviseDays
+ * Works out the pick options for a run of consecutive days.
+ *
+ * Parameters:
+ *   provider - where the weather comes from; asked once per day.
+ *   firstDay - first day to plan, as days since 1970-01-01.
+ *   days     - number of days; all of them are asked for and kept, so callers
+ *              bound it, e.g. by the clothes there are to dress them.
+ *   fallback - options for days the provider knows nothing about, and the base
+ *              the weather advice is applied on top of.
+ *   unknown  - optional count of days the provider did not know.
+ *
+ * Returns:
+ *   One PickOptions per day, for pickOutfitsForDays or the planner, each with
+ *   its day set so wear history records when the outfit is worn.
+ */
+vector<PickOptions> adviseDays(ConditionsProvider& provider, int64_t firstDay, size_t days,
+                               const PickOptions& fallback, size_t* unknown) {
+    vector<PickOptions> advice;
+    advice.reserve(days);
+    if (unknown) *unknown = 0;
+    for (size_t i = 0; i < days; i++) {
+        Conditions conditions;
+        if (provider.conditionsFor(firstDay + int64_t(i), conditions)) advice.push_back(adviseOutfit(conditions, fallback));
+        else {
+            advice.push_back(fallback);
+            if (unknown) (*unknown)++;
+        }
+        advice.back().day = firstDay + int64_t(i);
+    }
+    return advice;
+}
+
+/* pickOutfitsForDays
+ * Plans one outfit per day, each following that day's options.
+ *
+ * Parameters:
+ *   outfits - wardrobe to pick from.
+ *   dirty   - wardrobe to move worn clothes into.
+ *   days    - options for each day, e.g. from adviseDays.
+ *   rng     - generator to draw picks from.
+ *
+ * Returns:
+ *   The outfits in day order; stops early, with ranDry set, if a needed type runs out.
+ */
+PickResult pickOutfitsForDays(Wardrobe& outfits, Wardrobe& dirty, const vector<PickOptions>& days, Xoshiro256& rng) {
+    PickResult result;
+    result.outfits.reserve(days.size());
+    for (const auto& options : days) {
+        PickResult day = pickOutfits(outfits, dirty, 1, options, rng);
+        if (day.ranDry) {
+            result.ranDry = true;
+            result.dryType = day.dryType;
+            break;
+        }
+        result.outfits.push_back(day.outfits.front());
+    }
+    return result;
+}
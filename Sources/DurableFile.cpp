@@ -0,0 +1,153 @@
+/* Nolan Pierce - Durable File Implementation
+ *
+ * Overview:
+ *   Small portable layer over the POSIX and Windows calls needed to append to a
+ *   file, force it to disk, and atomically replace one file with another.
+ */
+#include "../Headers/DurableFile.h"
+#include "../Headers/Stats.h"
+#include <algorithm>
+#include <filesystem>
+#include <system_error>
+#include <utility>
+
+#ifdef _WIN32
+#include <io.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+AppendFile::~AppendFile() {
+    close();
+}
+
+AppendFile::AppendFile(AppendFile&& other) noexcept {
+    fd = exchange(other.fd, -1);
+}
+
+AppendFile& AppendFile::operator=(AppendFile&& other) noexcept {
+    if (this != &other) {
+        close();
+        fd = exchange(other.fd, -1);
+    }
+    return *this;
+}
+
+/* open
+ * Opens a file for appending, creating it if needed.
+ *
+ * Parameters:
+ *   filename - path of the file.
+ *
+ * Returns:
+ *   true if the file is open.
+ */
+bool AppendFile::open(const string& filename) {
+    close();
+#ifdef _WIN32
+    fd = _open(filename.c_str(), _O_WRONLY | _O_CREAT | _O_APPEND | _O_BINARY, _S_IREAD | _S_IWRITE);
+#else
+    fd = ::open(filename.c_str(), O_WRONLY | O_CREAT | O_APPEND, 0644);
+#endif
+    return fd >= 0;
+}
+
+/* append
+ * Writes all of data to the end of the file.
+ *
+ * Returns:
+ *   true if every byte was handed to the OS.
+ */
+bool AppendFile::append(string_view data) {
+    while (!data.empty()) {
+#ifdef _WIN32
+        int written = _write(fd, data.data(), unsigned(min<size_t>(data.size(), 1 << 30)));
+#else
+        ssize_t written = ::write(fd, data.data(), data.size());
+#endif
+        if (written <= 0) return false;
+        STAT_ADD(STAT_BYTES_WRITTEN, written);
+        data.remove_prefix(written);
+    }
+    return true;
+}
+
+/* sync
+ * Blocks until everything appended so far is on stable storage.
+ */
+bool AppendFile::sync() {
+#ifdef _WIN32
+    return _commit(fd) == 0;
+#else
+    return fsync(fd) == 0;
+#endif
+}
+
+void AppendFile::close() {
+    if (fd < 0) return;
+#ifdef _WIN32
+    _close(fd);
+#else
+    ::close(fd);
+#endif
+    fd = -1;
+}
+
+/* syncFile
+ * Forces a file that was written through another handle onto stable storage.
+ *
+ * Parameters:
+ *   filename - path of the file.
+ */
+bool syncFile(const string& filename) {
+#ifdef _WIN32
+    int fd = _open(filename.c_str(), _O_RDWR | _O_BINARY);
+    if (fd < 0) return false;
+    bool synced = _commit(fd) == 0;
+    _close(fd);
+#else
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    bool synced = fsync(fd) == 0;
+    ::close(fd);
+#endif
+    return synced;
+}
+
+/* syncDirectoryOf
+ * Makes creations, renames and deletions in a file's directory durable.
+ *
+ * Details:
+ *   - Needed on POSIX after a rename; Windows has no equivalent, so it is a no-op there.
+ */
+bool syncDirectoryOf(const string& filename) {
+#ifdef _WIN32
+    (void)filename;
+    return true;
+#else
+    filesystem::path directory = filesystem::path(filename).parent_path();
+    int fd = ::open(directory.empty() ? "." : directory.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    bool synced = fsync(fd) == 0;
+    ::close(fd);
+    return synced;
+#endif
+}
+
+/* replaceFile
+ * Atomically renames one file over another and makes the rename durable.
+ *
+ * Parameters:
+ *   from - fully written and synced temporary file.
+ *   to   - file to replace.
+ */
+bool replaceFile(const string& from, const string& to) {
+    error_code error;
+    filesystem::rename(from, to, error);
+    return !error && syncDirectoryOf(to);
+}
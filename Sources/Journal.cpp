@@ -0,0 +1,419 @@
+/* Nolan Pierce - Journal Implementation
+ *
+ * Overview:
+ *   Appends wardrobe changes to a journal next to outfits.csv instead of
+ *   rewriting both CSV files on every run, and periodically compacts the
+ *   journal back into the CSV snapshots.
+ *
+ * Files (for outfits.csv):
+ *   outfits.csv.journal             - change log since the last compaction
+ *   outfits.csv.journal.compacting  - present only while new snapshots are being switched in
+ *   outfits.csv.journal.sealed      - changes a background compaction is folding in
+ *   outfits.new.csv, dirtyLaundry.new.csv - new snapshots written during compaction
+ *
+ *   Snapshots may be CSV or binary (".bin"); the new files keep the same extension.
+ */
+#include "../Headers/Journal.h"
+#include "../Headers/MappedFile.h"
+#include <algorithm>
+#include <filesystem>
+#include <system_error>
+
+using namespace std;
+
+static const char* opNames[] = {"add", "remove", "wear", "wash", "worn"};
+// Marker contents of a background compaction, which folds in only the sealed part
+static const string_view SEALED_MARKER = "sealed\n";
+
+/* Journal
+ * Sets up a journal for a pair of wardrobe snapshots.
+ *
+ * Parameters:
+ *   outfitsPath - CSV snapshot of clean clothes; the journal is stored beside it.
+ *   dirtyPath   - CSV snapshot of dirty clothes.
+ *   batchSize   - records buffered before they are appended and fsynced.
+ */
+Journal::Journal(const string& outfitsPath, const string& dirtyPath, size_t batchSize)
+    : outfitsPath(outfitsPath), dirtyPath(dirtyPath), journalPath(outfitsPath + ".journal"),
+      markerPath(journalPath + ".compacting"), sealedPath(journalPath + ".sealed"),
+      batchSize(max<size_t>(1, batchSize)) {}
+
+Journal::~Journal() {
+    flush();
+    waitForCompaction();
+}
+
+/* findRecorded
+ * Finds the item a journal record refers to among the items with its attributes.
+ *
+ * Parameters:
+ *   outfits - wardrobe to search.
+ *   item    - the item as recorded.
+ *   worn    - true if the record holds the item after a wear, so the match has one
+ *             wear fewer; of several such items the least recently worn is taken,
+ *             the one a rotation pick would have worn.
+ *
+ * Returns:
+ *   Position in the item's type vector, or SIZE_MAX if no item has its attributes.
+ *
+ * Details:
+ *   - Falls back to any item with the same attributes, e.g. for journals written
+ *     before wear history. Only equal items are looked at, so this is O(copies).
+ */
+static size_t findRecorded(Wardrobe& outfits, const ClothingItem& item, bool worn) {
+    keyIndex(outfits);
+    auto found = outfits.index.positions.find(clothingKey(item));
+    if (found == outfits.index.positions.end() || found->second.empty()) return SIZE_MAX;
+    const vector<ClothingItem>& items = getType(outfits, item.type);
+    size_t best = SIZE_MAX;
+    for (uint32_t pos : found->second) {
+        const ClothingItem& candidate = items[pos];
+        if (worn && item.wearCount > 0) {
+            if (candidate.wearCount + 1 == item.wearCount && (best == SIZE_MAX || wornBefore(candidate, items[best])))
+                best = pos;
+        }
+        else if (candidate.wearCount == item.wearCount && candidate.lastWorn == item.lastWorn) return pos;
+    }
+    return best != SIZE_MAX ? best : found->second.back();
+}
+
+/* eraseRecorded
+ * Removes the item a journal record refers to (see findRecorded).
+ *
+ * Returns:
+ *   true if an item with its attributes was there to remove.
+ */
+static bool eraseRecorded(Wardrobe& outfits, const ClothingItem& item, bool worn) {
+    size_t pos = findRecorded(outfits, item, worn);
+    if (pos == SIZE_MAX) return false;
+    eraseClothingAt(outfits, item.type, pos);
+    return true;
+}
+
+/* applyJournalOp
+ * Applies one journal record to a clean/dirty wardrobe pair.
+ *
+ * Returns:
+ *   false if the item the record refers to was not where it should be.
+ *
+ * Details:
+ *   - wear and wash still add the item to its destination when it is missing
+ *     from its source, so a replay never loses clothes.
+ *   - Items are matched with their wear history, so a replay leaves the same
+ *     copy of a duplicated item behind as the original run did.
+ */
+bool applyJournalOp(JournalOp op, const ClothingItem& item, Wardrobe& outfits, Wardrobe& dirty) {
+    switch (op) {
+        case JOURNAL_ADD:
+            insertClothing(outfits, item);
+            return true;
+        case JOURNAL_REMOVE:
+            return eraseRecorded(outfits, item, false);
+        case JOURNAL_WEAR: {
+            bool found = eraseRecorded(outfits, item, true);
+            insertClothing(dirty, item);
+            return found;
+        }
+        case JOURNAL_WASH: {
+            bool found = eraseRecorded(dirty, item, false);
+            insertClothing(outfits, item);
+            return found;
+        }
+        case JOURNAL_WORN: {
+            size_t pos = findRecorded(outfits, item, true);
+            if (pos == SIZE_MAX) return false;
+            wearClothingAt(outfits, item.type, pos, item.lastWorn);
+            return true;
+        }
+    }
+    return false;
+}
+
+/* recoverCompaction
+ * Finishes or rolls back a compaction that a crash interrupted.
+ *
+ * Details:
+ *   - With the marker present, both new snapshots were complete before any was
+ *     switched in, so the switch is finished and the folded-in records dropped:
+ *     the sealed part, and for a compaction in the foreground (an empty marker)
+ *     the journal too.
+ *   - Without it, leftover new snapshots are incomplete and are deleted.
+ */
+void Journal::recoverCompaction() {
+    error_code error;
+    if (filesystem::exists(markerPath, error)) {
+        bool sealedOnly = MappedFile(markerPath).view() == SEALED_MARKER;
+        for (const string* path : {&outfitsPath, &dirtyPath}) {
+            if (filesystem::exists(newSnapshotPath(*path), error)) replaceFile(newSnapshotPath(*path), *path);
+        }
+        filesystem::remove(sealedPath, error);
+        if (!sealedOnly) {
+            filesystem::resize_file(journalPath, 0, error);
+            syncFile(journalPath);
+        }
+        filesystem::remove(markerPath, error);
+        syncDirectoryOf(markerPath);
+        return;
+    }
+    filesystem::remove(newSnapshotPath(outfitsPath), error);
+    filesystem::remove(newSnapshotPath(dirtyPath), error);
+}
+
+/* load
+ * Rebuilds the current wardrobes from the snapshots and the journal.
+ *
+ * Parameters:
+ *   outfits - filled with the clean clothes.
+ *   dirty   - filled with the dirty clothes.
+ *
+ * Details:
+ *   - A sealed part left by a background compaction that did not finish is
+ *     replayed first, then folded in with compact() so the next background
+ *     compaction can seal the journal again.
+ */
+void Journal::load(Wardrobe& outfits, Wardrobe& dirty) {
+    waitForCompaction();
+    file.close();
+    pending.clear();
+    pendingCount = 0;
+    recoverCompaction();
+    outfits = loadDatabase(outfitsPath);
+    dirty = loadDatabase(dirtyPath);
+
+    error_code error;
+    bool sealed = filesystem::exists(sealedPath, error);
+    recordCount = sealed ? replay(sealedPath, outfits, dirty) : 0;
+    recordCount += replay(journalPath, outfits, dirty);
+    file.open(journalPath);
+    if (sealed && !compact(outfits, dirty)) cerr << "Error: Could not fold the sealed journal into the snapshots.\n";
+}
+
+/* replay
+ * Applies the records of one journal file and cuts off a torn last line.
+ *
+ * Returns:
+ *   Number of records applied.
+ */
+size_t Journal::replay(const string& path, Wardrobe& outfits, Wardrobe& dirty) {
+    //Replay every complete line; a line without its newline was cut off by a crash
+    size_t validLength = 0;
+    size_t records = 0;
+    size_t journalSize = 0;
+    {
+        MappedFile journal(path);
+        string_view contents = journal.view();
+        journalSize = contents.size();
+        while (true) {
+            size_t lineEnd = contents.find('\n', validLength);
+            if (lineEnd == string_view::npos) break;
+            string_view line = contents.substr(validLength, lineEnd - validLength);
+
+            size_t comma = line.find(',');
+            const char* const* op = find(begin(opNames), end(opNames), line.substr(0, comma));
+            ClothingItem item;
+            if (comma == string_view::npos || op == end(opNames) || !parseClothingLine(line.substr(comma + 1), item)) {
+                cerr << "Warning: Journal is damaged after " << records << " changes; ignoring the rest.\n";
+                break;
+            }
+            applyJournalOp(JournalOp(op - begin(opNames)), item, outfits, dirty);
+            records++;
+            validLength = lineEnd + 1;
+        }
+    }
+    if (journalSize > validLength) {
+        error_code error;
+        filesystem::resize_file(path, validLength, error);
+    }
+    return records;
+}
+
+/* record
+ * Logs one change that has already been applied to the in-memory wardrobes.
+ *
+ * Parameters:
+ *   op   - kind of change.
+ *   item - clothing item it applied to.
+ */
+void Journal::record(JournalOp op, const ClothingItem& item) {
+    pending += opNames[op];
+    pending += ',';
+    pending += typeName(item.type);
+    pending += item.isLong ? ",true," : ",false,";
+    pending += attributeName(item.material);
+    pending += ',';
+    pending += attributeName(item.color);
+    pending += ',';
+    pending += attributeName(item.pattern);
+    if (hasWearHistory(item)) {
+        pending += ',';
+        pending += to_string(item.wearCount);
+        pending += ',';
+        if (item.lastWorn != NEVER_WORN) pending += formatDay(item.lastWorn);
+    }
+    pending += '\n';
+    recordCount++;
+    if (++pendingCount >= batchSize) flush();
+}
+
+void Journal::record(JournalOp op, const vector<ClothingItem>& items) {
+    for (const auto& item : items) record(op, item);
+}
+
+/* flush
+ * Appends all buffered records to the journal and fsyncs it.
+ */
+void Journal::flush() {
+    if (pending.empty()) return;
+    if (!file.isOpen()) file.open(journalPath);
+    if (!file.append(pending) || !file.sync()) cerr << "Error: Could not write to the journal.\n";
+    pending.clear();
+    pendingCount = 0;
+}
+
+/* needsCompaction
+ * Says whether the journal has grown enough to be worth folding into the snapshots.
+ *
+ * Parameters:
+ *   liveItems - number of items currently in both wardrobes.
+ *
+ * Details:
+ *   - Compacts once the journal holds more records than the snapshots hold items
+ *     (and at least a few thousand), so rewrite cost stays proportional to changes.
+ */
+bool Journal::needsCompaction(size_t liveItems) const {
+    return recordCount >= max<size_t>(4096, liveItems);
+}
+
+/* compact
+ * Writes fresh snapshots of the wardrobes and empties the journal.
+ *
+ * Parameters:
+ *   outfits - current clean clothes.
+ *   dirty   - current dirty clothes.
+ *
+ * Returns:
+ *   true if the new snapshots are in place; on failure the old snapshots and
+ *   journal are left as they were.
+ *
+ * Details:
+ *   - Waits for a background compaction first, and folds in a sealed part
+ *     that one left behind.
+ */
+bool Journal::compact(const Wardrobe& outfits, const Wardrobe& dirty) {
+    waitForCompaction();
+    flush();
+    string outfitsNew = newSnapshotPath(outfitsPath);
+    string dirtyNew = newSnapshotPath(dirtyPath);
+    if (!pushDatabase(outfits, outfitsNew) || !pushDatabase(dirty, dirtyNew) ||
+        !syncFile(outfitsNew) || !syncFile(dirtyNew)) {
+        error_code error;
+        filesystem::remove(outfitsNew, error);
+        filesystem::remove(dirtyNew, error);
+        return false;
+    }
+
+    //Commit point: from here on, recovery finishes the switch instead of undoing it
+    AppendFile marker;
+    if (!marker.open(markerPath) || !marker.sync() || !syncDirectoryOf(markerPath)) return false;
+    marker.close();
+
+    replaceFile(outfitsNew, outfitsPath);
+    replaceFile(dirtyNew, dirtyPath);
+    file.close();
+    error_code error;
+    filesystem::remove(sealedPath, error);
+    filesystem::resize_file(journalPath, 0, error);
+    syncFile(journalPath);
+    filesystem::remove(markerPath, error);
+    syncDirectoryOf(markerPath);
+    file.open(journalPath);
+    recordCount = 0;
+    return true;
+}
+
+/* compactInBackground
+ * Starts folding the journal into fresh snapshots without waiting for them.
+ *
+ * Parameters:
+ *   outfits - current clean clothes; copied, so they may change right away.
+ *   dirty   - current dirty clothes.
+ *
+ * Returns:
+ *   false if the journal could not be sealed; nothing changed then.
+ *
+ * Details:
+ *   - Costs a flush, a rename and a copy of the items; the snapshots are
+ *     written and switched in on the SnapshotWriter's thread.
+ *   - Does nothing while an earlier one is still running: the records since
+ *     it started stay in the journal and count toward the next.
+ *   - If an earlier one failed, its sealed part is still there; this then
+ *     falls back to compact().
+ */
+bool Journal::compactInBackground(const Wardrobe& outfits, const Wardrobe& dirty) {
+    if (compacting) return true;
+    error_code error;
+    if (filesystem::exists(sealedPath, error)) return compact(outfits, dirty);
+    flush();
+    if (!file.isOpen() && !file.open(journalPath)) return false;
+    file.close();
+    if (!replaceFile(journalPath, sealedPath)) {
+        file.open(journalPath);
+        return false;
+    }
+    file.open(journalPath);
+    recordCount = 0;
+
+    if (!writer)
+        writer = make_unique<SnapshotWriter>(outfitsPath, dirtyPath, [this](bool written) { return commitSealed(written); });
+    compacting = true;
+    compactionTicket = writer->save(outfits, dirty);
+    return true;
+}
+
+/* commitSealed
+ * Switches in the snapshots of a background compaction; runs on the writer thread.
+ *
+ * Parameters:
+ *   written - whether both new snapshots were written and synced.
+ *
+ * Returns:
+ *   true if they are in place and the sealed part is gone.
+ *
+ * Details:
+ *   - Same commit point as compact(), but the marker says only the sealed part
+ *     was folded in, so recovery keeps the journal written meanwhile.
+ *   - On failure the sealed part stays, and the next compaction folds it in.
+ */
+bool Journal::commitSealed(bool written) {
+    bool committed = false;
+    error_code error;
+    //The marker is renamed into place whole: an empty one would mean the journal was folded in too
+    string markerNew = markerPath + ".new";
+    filesystem::remove(markerNew, error);
+    AppendFile marker;
+    if (written && marker.open(markerNew) && marker.append(SEALED_MARKER) && marker.sync()) {
+        marker.close();
+        if (replaceFile(markerNew, markerPath)) {
+            replaceFile(newSnapshotPath(outfitsPath), outfitsPath);
+            replaceFile(newSnapshotPath(dirtyPath), dirtyPath);
+            filesystem::remove(sealedPath, error);
+            filesystem::remove(markerPath, error);
+            syncDirectoryOf(markerPath);
+            committed = true;
+        }
+    }
+    marker.close();
+    filesystem::remove(markerNew, error);
+    compacting = false;
+    return committed;
+}
+
+/* waitForCompaction
+ * Durability barrier for compactInBackground.
+ *
+ * Returns:
+ *   true if the last background compaction is in place, or none was started.
+ */
+bool Journal::waitForCompaction() {
+    return !writer || writer->wait(compactionTicket);
+}
@@ -0,0 +1,145 @@
+/* Nolan Pierce - Outfit Cache Implementation
+ *
+ * Overview:
+ *   A size-capped LRU cache of ScorePlans, so bestOutfits on a wardrobe that
+ *   has not changed since the last request skips finding its styles and
+ *   building its pair tables, which is most of the work for small k.
+ *
+ * Details:
+ *   - Wardrobe versions are unique across wardrobes and bumped by every edit,
+ *     so there is nothing to invalidate: a changed wardrobe simply asks for a
+ *     new key, and the old plan is evicted once it is least recently used.
+ *   - Two threads missing on the same key at once both build the plan; the
+ *     second insert replaces the first. That wastes a build but never blocks.
+ */
+#include "../Headers/OutfitCache.h"
+#include "../Headers/Stats.h"
+#include <chrono>
+
+using namespace std;
+
+/* rulesFingerprint
+ * Hashes every field of every rule, in order (FNV-1a).
+ */
+uint64_t rulesFingerprint(const StyleRules& rules) {
+    uint64_t hash = 0xCBF29CE484222325ull;
+    auto mix = [&](uint64_t value) {
+        for (int byte = 0; byte < 8; byte++) {
+            hash ^= (value >> (byte * 8)) & 0xFF;
+            hash *= 0x100000001B3ull;
+        }
+    };
+    for (const auto& rule : rules.rules) {
+        mix(uint64_t(rule.kind) | uint64_t(rule.anyA) << 8 | uint64_t(rule.anyB) << 9 | uint64_t(rule.a) << 16 |
+            uint64_t(rule.b) << 32);
+        mix(uint64_t(int64_t(rule.score)));
+    }
+    return hash;
+}
+
+/* sameRules
+ * Compares two rule lists field by field.
+ */
+static bool sameRules(const vector<StyleRule>& a, const vector<StyleRule>& b) {
+    if (a.size() != b.size()) return false;
+    for (size_t i = 0; i < a.size(); i++) {
+        if (a[i].kind != b[i].kind || a[i].anyA != b[i].anyA || a[i].anyB != b[i].anyB || a[i].score != b[i].score ||
+            (!a[i].anyA && a[i].a != b[i].a) || (!a[i].anyB && a[i].b != b[i].b))
+            return false;
+    }
+    return true;
+}
+
+/* OutfitCache::plan
+ * Returns the plan for a wardrobe, rules and jacket option, building and
+ * keeping it if it is not cached.
+ *
+ * Parameters:
+ *   outfits - wardrobe to plan for; its version is the key, so a wardrobe
+ *             filled without insertClothing or rebuildIndex must be stamped
+ *             with stampVersion first.
+ *   rules   - compatibility rules to score with.
+ *   options - whether outfits include a jacket.
+ */
+shared_ptr<const ScorePlan> OutfitCache::plan(const Wardrobe& outfits, const StyleRules& rules,
+                                              const PickOptions& options) {
+    auto start = chrono::steady_clock::now();
+    Key key{outfits.version, rulesFingerprint(rules), options.jacket};
+    {
+        lock_guard<mutex> guard(lock);
+        auto found = entries.find(key);
+        if (found != entries.end() && sameRules(found->second->rules, rules.rules)) {
+            recent.splice(recent.begin(), recent, found->second);
+            counts.hits++;
+            counts.hitSeconds += chrono::duration<double>(chrono::steady_clock::now() - start).count();
+            STAT_ADD(STAT_CACHE_HITS, 1);
+            return found->second->plan;
+        }
+    }
+
+    shared_ptr<const ScorePlan> built = planScoring(outfits, rules, options);
+    Entry entry{key, rules.rules, built, scorePlanBytes(*built) + rules.rules.capacity() * sizeof(StyleRule)};
+    lock_guard<mutex> guard(lock);
+    insert(move(entry));
+    counts.misses++;
+    counts.missSeconds += chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    STAT_ADD(STAT_CACHE_MISSES, 1);
+    return built;
+}
+
+/* OutfitCache::insert
+ * Adds an entry as the most recently used, replacing one with the same key,
+ * then evicts from the old end until the cache fits. Called with lock held.
+ */
+void OutfitCache::insert(Entry entry) {
+    auto found = entries.find(entry.key);
+    if (found != entries.end()) {
+        counts.bytes -= found->second->bytes;
+        recent.erase(found->second);
+        entries.erase(found);
+    }
+    if (entry.bytes > maxBytes) return;
+
+    counts.bytes += entry.bytes;
+    recent.push_front(move(entry));
+    entries[recent.front().key] = recent.begin();
+    while (counts.bytes > maxBytes) {
+        counts.bytes -= recent.back().bytes;
+        entries.erase(recent.back().key);
+        recent.pop_back();
+        counts.evictions++;
+    }
+}
+
+/* OutfitCache::stats
+ * Returns a copy of the counts, with the current number of entries.
+ */
+OutfitCacheStats OutfitCache::stats() const {
+    lock_guard<mutex> guard(lock);
+    OutfitCacheStats copy = counts;
+    copy.entries = entries.size();
+    return copy;
+}
+
+/* OutfitCache::clear
+ * Drops every plan and resets the counts.
+ */
+void OutfitCache::clear() {
+    lock_guard<mutex> guard(lock);
+    recent.clear();
+    entries.clear();
+    counts = OutfitCacheStats();
+}
+
+/* bestOutfits
+ * Finds the highest-scoring outfits in a wardrobe, reusing a cached plan when
+ * the wardrobe has not changed since it was built.
+ *
+ * Returns:
+ *   The same outfits as bestOutfits without a cache.
+ */
+vector<ScoredOutfit> bestOutfits(const Wardrobe& outfits, const StyleRules& rules, size_t k,
+                                 const PickOptions& options, OutfitCache& cache) {
+    if (k == 0) return {};
+    return bestOutfits(*cache.plan(outfits, rules, options), k);
+}
@@ -18,14 +18,56 @@
  *   - Convert to web or mobile interface.
  */
 #include "../Headers/OutfitPicker.h"
+#include "../Headers/MappedFile.h"
+#include "../Headers/Snapshot.h"
+#include "../Headers/Random.h"
+#include "../Headers/ScratchArena.h"
+#include "../Headers/ParallelParse.h"
+#include "../Headers/ClothingSearch.h"
+#include "../Headers/Stats.h"
 #include <iostream>
 #include <fstream>
 #include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <cstdio>
+#include <ctime>
 #include <limits>
 #include <random>
+#include <thread>
 
 using namespace std;
 
+/* typeName
+ * Returns the text used for a clothing type in prompts and CSV files.
+ *
+ * Parameters:
+ *   type - a ClothingType value.
+ */
+const char* typeName(uint8_t type) {
+    static const char* names[] = {"jacket", "top", "bottom", "shoes"};
+    return type <= SHOES ? names[type] : "unknown";
+}
+
+/* parseType
+ * Converts clothing type text into a ClothingType.
+ *
+ * Parameters:
+ *   input - lowercase type text, e.g. "top".
+ *   type  - set to the matching ClothingType on success.
+ *
+ * Returns:
+ *   true if input names one of the 4 clothing types; false otherwise.
+ */
+bool parseType(string_view input, uint8_t& type) {
+    if (input == "top") type = TOP;
+    else if (input == "bottom") type = BOTTOM;
+    else if (input == "shoes") type = SHOES;
+    else if (input == "jacket") type = JACKET;
+    else return false;
+    return true;
+}
+
 /* toLower
  * Converts all characters in a string to lowercase.
  *
@@ -50,10 +92,10 @@ void toLower(string& input) {
  * 
  * Details:
  *   - Changes the string in-place.
- *   - Loops until user enters correct input 
+ *   - Loops until user enters correct input or input ends
  */
 void checkBool(string& input) {
-    while (input != "yes" && input != "no") {
+    while (cin && input != "yes" && input != "no") {
         cerr << "Error: Incorrect Input! Please enter either 'Yes' or 'No': ";
         cin >> input;
         cin.ignore(numeric_limits<streamsize>::max(), '\n');        
@@ -69,10 +111,10 @@ void checkBool(string& input) {
  * 
  * Details:
  *   - Changes the string in-place.
- *   - Loops until user enters correct input 
+ *   - Loops until user enters correct input or input ends
  */
 void checkType(string& input) {
-    while (input != "jacket" && input != "top" && input != "bottom" && input != "shoes") {
+    while (cin && input != "jacket" && input != "top" && input != "bottom" && input != "shoes") {
         cerr << "Error: Incorrect Input! Please enter either 'jacket', 'top', 'bottom', or 'shoes': ";
         cin >> input;
         cin.ignore(numeric_limits<streamsize>::max(), '\n');        
@@ -103,6 +145,220 @@ void checkInt(string& input) {
 }
     */
 
+/* dayNumber
+ * Converts a calendar date to days since 1970-01-01.
+ *
+ * Details:
+ *   - Uses the proleptic Gregorian calendar, so it is exact for any year.
+ */
+int64_t dayNumber(int year, unsigned month, unsigned dayOfMonth) {
+    year -= month <= 2;
+    int64_t era = (year >= 0 ? year : year - 399) / 400;
+    unsigned yearOfEra = unsigned(year - era * 400);
+    unsigned dayOfYear = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + dayOfMonth - 1;
+    unsigned dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+    return era * 146097 + int64_t(dayOfEra) - 719468;
+}
+
+/* parseDay
+ * Reads a YYYY-MM-DD date.
+ *
+ * Returns:
+ *   false if the text is not a valid date.
+ */
+bool parseDay(string_view text, int64_t& day) {
+    int year = 0;
+    unsigned month = 0, dayOfMonth = 0;
+    const char* end = text.data() + text.size();
+    auto [afterYear, yearError] = from_chars(text.data(), end, year);
+    if (yearError != errc() || afterYear == end || *afterYear != '-') return false;
+    auto [afterMonth, monthError] = from_chars(afterYear + 1, end, month);
+    if (monthError != errc() || afterMonth == end || *afterMonth != '-') return false;
+    auto [afterDay, dayError] = from_chars(afterMonth + 1, end, dayOfMonth);
+    if (dayError != errc() || afterDay != end) return false;
+
+    static const unsigned monthDays[] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+    bool leap = (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+    if (month < 1 || month > 12 || dayOfMonth < 1) return false;
+    if (dayOfMonth > monthDays[month - 1] + (month == 2 && leap)) return false;
+    day = dayNumber(year, month, dayOfMonth);
+    return true;
+}
+
+/* formatDay
+ * Writes days since 1970-01-01 as a YYYY-MM-DD date, the inverse of parseDay.
+ */
+string formatDay(int64_t day) {
+    day += 719468;
+    int64_t era = (day >= 0 ? day : day - 146096) / 146097;
+    unsigned dayOfEra = unsigned(day - era * 146097);
+    unsigned yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) / 365;
+    unsigned dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+    unsigned shiftedMonth = (5 * dayOfYear + 2) / 153;
+    unsigned dayOfMonth = dayOfYear - (153 * shiftedMonth + 2) / 5 + 1;
+    unsigned month = shiftedMonth < 10 ? shiftedMonth + 3 : shiftedMonth - 9;
+    int64_t year = int64_t(yearOfEra) + era * 400 + (month <= 2);
+
+    char text[32];
+    snprintf(text, sizeof(text), "%04lld-%02u-%02u", (long long)year, month, dayOfMonth);
+    return text;
+}
+
+/* today
+ * Returns the local date as days since 1970-01-01.
+ */
+int64_t today() {
+    time_t now = time(nullptr);
+    tm local{};
+#ifdef _WIN32
+    localtime_s(&local, &now);
+#else
+    localtime_r(&now, &local);
+#endif
+    return dayNumber(local.tm_year + 1900, local.tm_mon + 1, local.tm_mday);
+}
+
+/* nextField
+ * Splits the next comma-separated field off the front of a CSV line.
+ *
+ * Parameters:
+ *   rest - remaining unparsed part of the line; advanced past the field.
+ *
+ * Returns:
+ *   View of the field, pointing into the same buffer as rest.
+ *
+ * Details:
+ *   - If there is no comma left, the whole remainder is returned and rest is
+ *     left untouched, the same way the original substr/erase parser behaved.
+ */
+static string_view nextField(string_view& rest) {
+    size_t pos = rest.find(',');
+    string_view field = rest.substr(0, pos);
+    if (pos != string_view::npos) rest.remove_prefix(pos + 1);
+    return field;
+}
+
+/* splitWearHistory
+ * Takes the optional wearCount,lastWorn fields off the end of a CSV line.
+ *
+ * Parameters:
+ *   rest - unparsed end of the line, pattern onwards; shortened to the pattern
+ *          when the history fields are there.
+ *   item - gets the wear count and last-worn day.
+ *
+ * Returns:
+ *   false, leaving rest alone, unless the line ends in a count and a
+ *   YYYY-MM-DD date (empty for never worn).
+ *
+ * Details:
+ *   - Checked from the end, so lines written before wear history, whose pattern
+ *     is everything after the color, still load the same.
+ */
+static bool splitWearHistory(string_view& rest, ClothingItem& item) {
+    size_t dayComma = rest.rfind(',');
+    if (dayComma == string_view::npos || dayComma == 0) return false;
+    size_t countComma = rest.rfind(',', dayComma - 1);
+    if (countComma == string_view::npos) return false;
+
+    string_view countText = rest.substr(countComma + 1, dayComma - countComma - 1);
+    string_view dayText = rest.substr(dayComma + 1);
+    uint32_t count = 0;
+    auto [countEnd, countError] = from_chars(countText.data(), countText.data() + countText.size(), count);
+    if (countText.empty() || countError != errc() || countEnd != countText.data() + countText.size()) return false;
+    int64_t day = NEVER_WORN;
+    if (!dayText.empty() && !parseDay(dayText, day)) return false;
+
+    item.wearCount = count;
+    item.lastWorn = int32_t(day);
+    rest = rest.substr(0, countComma);
+    return true;
+}
+
+/* splitClothingLine
+ * Parses one CSV line into a ClothingItem, except for interning its attributes.
+ *
+ * Parameters:
+ *   line       - a single line as for parseClothingLine.
+ *   item       - gets the type, isLong and wear history.
+ *   attributes - gets the material, color and pattern text, pointing into line.
+ *
+ * Returns:
+ *   true if the line names one of the 4 clothing types; false otherwise.
+ *
+ * Details:
+ *   - Lets a parser number attributes on its own, e.g. per chunk in parallel.
+ */
+bool splitClothingLine(string_view line, ClothingItem& item, string_view attributes[3]) {
+    if (!line.empty() && line.back() == '\r') line.remove_suffix(1);
+
+    if (!parseType(nextField(line), item.type)) return false;
+    item.isLong = (nextField(line) == "true");
+    attributes[0] = nextField(line);
+    attributes[1] = nextField(line);
+    if (!splitWearHistory(line, item)) {
+        item.wearCount = 0;
+        item.lastWorn = NEVER_WORN;
+    }
+    attributes[2] = line;       // Remaining part is pattern
+    return true;
+}
+
+/* parseClothingLine
+ * Parses one CSV line into a ClothingItem.
+ *
+ * Parameters:
+ *   line - a single line formatted as: type,isLong,material,color,pattern
+ *          optionally followed by ,wearCount,lastWorn
+ *   item - ClothingItem to fill in.
+ *
+ * Returns:
+ *   true if the line names one of the 4 clothing types; false otherwise.
+ *
+ * Details:
+ *   - A trailing carriage return is ignored so files saved on Windows load the same.
+ *   - Without history fields the item is loaded as never worn.
+ */
+bool parseClothingLine(string_view line, ClothingItem& item) {
+    string_view attributes[3];
+    if (!splitClothingLine(line, item, attributes)) return false;
+    item.material = internAttribute(attributes[0]);
+    item.color = internAttribute(attributes[1]);
+    item.pattern = internAttribute(attributes[2]);
+    return true;
+}
+
+/* parseDatabase
+ * Parses CSV wardrobe data that is already in memory.
+ *
+ * Parameters:
+ *   contents - full text of a wardrobe CSV file.
+ *
+ * Returns:
+ *   Wardrobe populated with clothing items from the text.
+ *
+ * Details:
+ *   - Splits lines and fields in a single pass without copying the buffer;
+ *     attribute text is interned, so no per-item strings are allocated.
+ *   - Items keep the order they appear in within each type.
+ */
+Wardrobe parseDatabase(string_view contents) {
+    Wardrobe clothingDatabase;
+    ClothingItem item;
+
+    while (!contents.empty()) {
+        size_t end = contents.find('\n');
+        string_view line = contents.substr(0, end);
+        contents.remove_prefix(end == string_view::npos ? contents.size() : end + 1);
+
+        if (!parseClothingLine(line, item)) continue;
+        //Add ClothingItem to corresponding vector
+        getType(clothingDatabase, item).push_back(item);
+    }
+    rebuildIndex(clothingDatabase);     //one pass over the finished vectors is cheaper than indexing line by line
+    STAT_ADD(STAT_ITEMS_PARSED, wardrobeSize(clothingDatabase));
+    return clothingDatabase;
+}
+
 /* loadDatabase
  * Loads wardrobe data from a CSV file into a Wardrobe object.
  *
@@ -111,54 +367,28 @@ void checkInt(string& input) {
  *
  * Returns:
  *   Wardrobe populated with clothing items from the file.
+ *
+ * Details:
+ *   - The file is memory-mapped and parsed in place; a missing file loads as
+ *     an empty wardrobe.
+ *   - Binary snapshots (see Snapshot.h) are recognised by their header and
+ *     copied in without a parse step.
+ *   - CSV files of PARALLEL_LOAD_MIN_BYTES or more are parsed on every core
+ *     (see ParallelParse.h), with the same result.
  */
-Wardrobe loadDatabase(const string& filename) {   
-    //Var Initialization
-    Wardrobe clothingDatabase;
-    ifstream file(filename);
-    string line;
-    vector<ClothingItem> jackets;
-    vector<ClothingItem> tops;
-    vector<ClothingItem> bottoms;
-    vector<ClothingItem> shoes;
-
-    while (getline(file, line)) {
-        ClothingItem item;
-        // Line is formatted as: type,isLong,material,color,pattern
-        size_t pos = 0;
-        pos = line.find(',');
-        item.type = line.substr(0, pos);
-        line.erase(0, pos + 1);
-
-        pos = line.find(',');
-        item.isLong = (line.substr(0, pos) == "true");
-        line.erase(0, pos + 1);
-
-        pos = line.find(',');
-        item.material = line.substr(0, pos);
-        line.erase(0, pos + 1);
-
-        pos = line.find(',');
-        item.color = line.substr(0, pos);
-        line.erase(0, pos + 1);
-
-        item.pattern = line; // Remaining part is pattern
-        
-        //Add ClothingItem to corresponding vector
-        if (item.type == "top") tops.push_back(item);
-        else if (item.type == "bottom") bottoms.push_back(item);
-        else if (item.type == "shoes") shoes.push_back(item);
-        else if (item.type == "jacket") jackets.push_back(item);
+Wardrobe loadDatabase(const string& filename) {
+    STAT_SCOPE(TIMER_LOAD);
+    MappedFile file(filename);
+    if (isSnapshot(file.view())) {
+        SnapshotView snapshot;
+        if (!snapshot.open(move(file))) throw runtime_error("Damaged or unsupported wardrobe snapshot: " + filename);
+        return snapshot.toWardrobe();
     }
-
-    //Update overall wardrobe to include corresponding vectors for each type
-    clothingDatabase.shoes = shoes;
-    clothingDatabase.bottoms = bottoms;
-    clothingDatabase.tops = tops;
-    clothingDatabase.jackets = jackets;
-
-    file.close();
-    return clothingDatabase;
+    if (file.size() >= PARALLEL_LOAD_MIN_BYTES && thread::hardware_concurrency() > 1) {
+        ThreadPool pool;
+        return parseDatabase(file.view(), pool);
+    }
+    return parseDatabase(file.view());
 }
 
 /* getUsersClothing
@@ -176,7 +406,7 @@ ClothingItem getUsersClothing() {
     getline(cin, converted);
     toLower(converted);     //ensures formatting in vectors/.csv's are uniform
     checkType(converted);   //ensures user entered one of the 4 clothing types
-    Item.type = converted;
+    parseType(converted, Item.type);
 
 
     cout << "Is it long-sleeved or long-pants? (Yes/No): ";
@@ -188,21 +418,59 @@ ClothingItem getUsersClothing() {
     cout << "Enter clothing material: ";
     getline(cin, converted);
     toLower(converted);
-    Item.material = converted;
+    Item.material = internAttribute(converted);
 
     cout << "Enter clothing color: ";
     getline(cin, converted);
     toLower(converted);
-    Item.color = converted;
+    Item.color = internAttribute(converted);
 
     cout << "Enter clothing pattern: ";
     getline(cin, converted);
     toLower(converted);
-    Item.pattern = converted;
+    Item.pattern = internAttribute(converted);
 
     return Item;
 }
 
+/* offerSuggestions
+ * Lists the items of a wardrobe closest to one the user typed and lets them
+ * choose one instead of typing the whole item again.
+ *
+ * Parameters:
+ *   outfits - wardrobe the item should have been in.
+ *   item    - the item as typed; replaced by the chosen suggestion.
+ *
+ * Returns:
+ *   true if the user chose a suggestion; false if there were none or they declined.
+ */
+bool offerSuggestions(Wardrobe& outfits, ClothingItem& item) {
+    vector<ClothingMatch> matches = suggestClothing(outfits, item, SUGGESTION_COUNT);
+    if (matches.empty()) return false;
+
+    thread_local vector<string_view> names;
+    attributeTable(names);
+    cout << "\nNo exact match. Did you mean:\n" << flush;
+    OutputBuffer& out = standardOutput();
+    for (size_t i = 0; i < matches.size(); i++) {
+        out.append("  ");
+        out.appendNumber(i + 1);
+        out.append(") ");
+        formatClothing(out, matches[i].item, names, OUTPUT_COMPACT);
+        out.append('\n');
+    }
+    out.flush();
+    cout << "Enter its number, or 0 for none of these: ";
+    string choice;
+    getline(cin, choice);
+    size_t picked = 0;
+    auto [rest, error] = from_chars(choice.data(), choice.data() + choice.size(), picked);
+    if (error != errc() || rest != choice.data() + choice.size() || picked == 0 || picked > matches.size())
+        return false;
+    item = matches[picked - 1].item;
+    return true;
+}
+
 /* getType
  * Returns the vector in a Wardrobe corresponding to a clothing item’s type.
  *
@@ -216,13 +484,450 @@ ClothingItem getUsersClothing() {
  * Throws:
  *   runtime_error if the clothing type is unknown.
  */
-vector<ClothingItem>& getType(Wardrobe& outfits, ClothingItem Item) {
-    if (Item.type == "jacket") return outfits.jackets;
-    else if (Item.type == "top") return outfits.tops;
-    else if (Item.type == "bottom") return outfits.bottoms;
-    else if (Item.type == "shoes") return outfits.shoes;
-    
-    throw runtime_error("Unknown clothing type: " + Item.type);
+vector<ClothingItem>& getType(Wardrobe& outfits, const ClothingItem& Item) {
+    return getType(outfits, Item.type);
+}
+
+/* getType
+ * Returns the vector in a Wardrobe holding the given clothing type.
+ *
+ * Parameters:
+ *   outfits - wardrobe to search.
+ *   type    - a ClothingType value.
+ *
+ * Throws:
+ *   runtime_error if the clothing type is unknown.
+ */
+vector<ClothingItem>& getType(Wardrobe& outfits, uint8_t type) {
+    switch (type) {
+        case JACKET: return outfits.jackets;
+        case TOP: return outfits.tops;
+        case BOTTOM: return outfits.bottoms;
+        case SHOES: return outfits.shoes;
+    }
+    throw runtime_error("Unknown clothing type: " + to_string(type));
+}
+
+const vector<ClothingItem>& getType(const Wardrobe& outfits, uint8_t type) {
+    return getType(const_cast<Wardrobe&>(outfits), type);
+}
+
+/* siftHeap
+ * Moves one entry of a type's rotation heap up or down until the heap is in order again.
+ *
+ * Parameters:
+ *   outfits - wardrobe with rotationIndex built.
+ *   type    - ClothingType of the heap.
+ *   slot    - heap slot whose item was just placed or changed.
+ *
+ * Details:
+ *   - O(log n); the heap holds positions, so only 4-byte entries move.
+ */
+static void siftHeap(Wardrobe& outfits, uint8_t type, size_t slot) {
+    const vector<ClothingItem>& items = getType(outfits, type);
+    vector<uint32_t>& heap = outfits.index.heaps[type];
+    vector<uint32_t>& heapSlots = outfits.index.heapSlots[type];
+    uint32_t moving = heap[slot];
+
+    //Up while worn before its parent; otherwise down while a child was worn before it
+    while (slot > 0 && wornBefore(items[moving], items[heap[(slot - 1) / 2]])) {
+        heap[slot] = heap[(slot - 1) / 2];
+        heapSlots[heap[slot]] = slot;
+        slot = (slot - 1) / 2;
+    }
+    while (2 * slot + 1 < heap.size()) {
+        size_t child = 2 * slot + 1;
+        if (child + 1 < heap.size() && wornBefore(items[heap[child + 1]], items[heap[child]])) child++;
+        if (!wornBefore(items[heap[child]], items[moving])) break;
+        heap[slot] = heap[child];
+        heapSlots[heap[slot]] = slot;
+        slot = child;
+    }
+    heap[slot] = moving;
+    heapSlots[moving] = slot;
+}
+
+/* countValues
+ * Adds delta to the suggestIndex use counts of an item's material, color and pattern.
+ */
+static void countValues(WardrobeIndex& index, const ClothingItem& item, int delta) {
+    const AttributeId values[3] = {item.material, item.color, item.pattern};
+    for (int field = 0; field < 3; field++) {
+        vector<uint32_t>& uses = index.valueUses[field];
+        if (uses.size() <= values[field]) uses.resize(size_t(values[field]) + 1, 0);
+        uses[values[field]] += delta;
+    }
+}
+
+/* listKind
+ * Adds a new key of the positions index to the suggestIndex kind lists of its three values.
+ */
+static void listKind(WardrobeIndex& index, uint64_t key) {
+    const AttributeId values[3] = {AttributeId(key), AttributeId(key >> 16), AttributeId(key >> 32)};
+    for (int field = 0; field < 3; field++) {
+        vector<vector<uint64_t>>& kinds = index.valueKinds[field];
+        size_t slot = kindSlot(values[field], uint8_t(key >> 48), (key >> 56) != 0);
+        if (kinds.size() <= slot) kinds.resize(kindSlot(values[field] + 1, 0, false));
+        kinds[slot].push_back(key);
+    }
+}
+
+/* insertClothing
+ * Appends a clothing item to the matching vector and records it in the index.
+ *
+ * Parameters:
+ *   outfits - wardrobe to update.
+ *   item    - clothing item to add.
+ */
+void insertClothing(Wardrobe& outfits, const ClothingItem& item) {
+    vector<ClothingItem>& items = getType(outfits, item);
+    if (outfits.index.keyed) {
+        auto [entry, newKind] = outfits.index.positions.try_emplace(clothingKey(item));
+        vector<uint32_t>& positions = entry->second;
+        outfits.index.slots[item.type].push_back(positions.size());
+        positions.push_back(items.size());
+        if (outfits.index.suggesting && newKind) listKind(outfits.index, entry->first);
+    }
+    if (outfits.index.grouped) {
+        vector<uint32_t>& group = outfits.index.groups[attributeGroup(item.type, item.isLong, item.material)];
+        outfits.index.groupSlots[item.type].push_back(group.size());
+        group.push_back(items.size());
+    }
+    items.push_back(item);
+    stampVersion(outfits);
+    if (outfits.index.suggesting) countValues(outfits.index, item, 1);
+    if (outfits.index.rotating) {
+        vector<uint32_t>& heap = outfits.index.heaps[item.type];
+        outfits.index.heapSlots[item.type].push_back(heap.size());
+        heap.push_back(items.size() - 1);
+        siftHeap(outfits, item.type, heap.size() - 1);
+    }
+}
+
+/* insertRange
+ * Adds count items starting at items, growing each vector and index only once.
+ */
+static void insertRange(Wardrobe& outfits, const ClothingItem* items, size_t count) {
+    size_t counts[4] = {0, 0, 0, 0};
+    for (size_t i = 0; i < count; i++) counts[items[i].type]++;
+    for (uint8_t type = JACKET; type <= SHOES; type++) {
+        vector<ClothingItem>& existing = getType(outfits, type);
+        existing.reserve(existing.size() + counts[type]);
+        if (outfits.index.keyed) outfits.index.slots[type].reserve(existing.size() + counts[type]);
+        if (outfits.index.grouped) outfits.index.groupSlots[type].reserve(existing.size() + counts[type]);
+        if (outfits.index.rotating) {
+            outfits.index.heaps[type].reserve(existing.size() + counts[type]);
+            outfits.index.heapSlots[type].reserve(existing.size() + counts[type]);
+        }
+    }
+    for (size_t i = 0; i < count; i++) insertClothing(outfits, items[i]);
+}
+
+/* insertClothing
+ * Adds many clothing items at once, growing each vector and index only once.
+ *
+ * Parameters:
+ *   outfits - wardrobe to update.
+ *   items   - clothing items to add, of any mix of types.
+ */
+void insertClothing(Wardrobe& outfits, const vector<ClothingItem>& items) {
+    insertRange(outfits, items.data(), items.size());
+}
+
+/* rebuildIndex
+ * Recomputes a wardrobe's index from its vectors.
+ *
+ * Parameters:
+ *   outfits - wardrobe whose vectors were filled directly, e.g. by a bulk copy.
+ */
+void rebuildIndex(Wardrobe& outfits) {
+    outfits.index = WardrobeIndex();
+    outfits.index.keyed = false;
+    stampVersion(outfits);
+    keyIndex(outfits);
+}
+
+/* keyIndex
+ * Builds the positions index (clothingKey -> positions) if it is not there yet.
+ *
+ * Parameters:
+ *   outfits - wardrobe to index.
+ *
+ * Details:
+ *   - Wardrobes loaded from a snapshot start without it, so opening one and
+ *     picking from it never hashes every item; the first lookup by item, e.g.
+ *     a remove or a wash, builds it in O(n), like groupIndex.
+ *   - Does not change the contents, so the version stays.
+ */
+void keyIndex(Wardrobe& outfits) {
+    if (outfits.index.keyed) return;
+    outfits.index.keyed = true;
+    for (uint8_t type = JACKET; type <= SHOES; type++) {
+        const vector<ClothingItem>& items = getType(outfits, type);
+        vector<uint32_t>& slots = outfits.index.slots[type];
+        slots.reserve(items.size());
+        for (size_t pos = 0; pos < items.size(); pos++) {
+            vector<uint32_t>& positions = outfits.index.positions[clothingKey(items[pos])];
+            slots.push_back(positions.size());
+            positions.push_back(pos);
+        }
+    }
+}
+
+// Version numbers a thread takes from the shared counter at a time
+static const uint64_t VERSION_BLOCK = uint64_t(1) << 20;
+
+/* stampVersion
+ * Gives a wardrobe a version number no wardrobe has had before; called by
+ * every edit.
+ *
+ * Details:
+ *   - Numbers are unique across all wardrobes, so a version alone identifies
+ *     the contents, e.g. as a cache key (see OutfitCache.h). A copy keeps its
+ *     original's number until either of them is edited.
+ *   - Each thread hands out numbers from a block of VERSION_BLOCK of its own,
+ *     so edits only touch the shared counter once per block.
+ */
+void stampVersion(Wardrobe& outfits) {
+    static atomic<uint64_t> blocks{0};
+    thread_local uint64_t next = 0;
+    thread_local uint64_t end = 0;
+    if (next == end) {
+        next = (blocks.fetch_add(1, memory_order_relaxed) + 1) * VERSION_BLOCK;
+        end = next + VERSION_BLOCK;
+    }
+    outfits.version = next++;
+}
+
+/* groupIndex
+ * Builds the attribute-group index (type, isLong, material) if it is not there yet.
+ *
+ * Parameters:
+ *   outfits - wardrobe to index.
+ *
+ * Details:
+ *   - Only wardrobes picked with weather preferences need the groups, so they are
+ *     built on first use; from then on insertClothing and eraseClothingAt keep them
+ *     current, and plain picks never pay for them.
+ */
+void groupIndex(Wardrobe& outfits) {
+    if (outfits.index.grouped) return;
+    outfits.index.grouped = true;
+    for (uint8_t type = JACKET; type <= SHOES; type++) {
+        const vector<ClothingItem>& items = getType(outfits, type);
+        vector<uint32_t>& groupSlots = outfits.index.groupSlots[type];
+        groupSlots.reserve(items.size());
+        for (size_t pos = 0; pos < items.size(); pos++) {
+            vector<uint32_t>& group = outfits.index.groups[attributeGroup(type, items[pos].isLong, items[pos].material)];
+            groupSlots.push_back(group.size());
+            group.push_back(pos);
+        }
+    }
+}
+
+/* rotationIndex
+ * Builds the per-type rotation heaps (least recently worn on top) if they are not there yet.
+ *
+ * Parameters:
+ *   outfits - wardrobe to index.
+ *
+ * Details:
+ *   - Built on the first rotation pick in O(n), then kept current by insertClothing,
+ *     eraseClothingAt and wearClothingAt in O(log n) each, like groupIndex.
+ */
+void rotationIndex(Wardrobe& outfits) {
+    if (outfits.index.rotating) return;
+    outfits.index.rotating = true;
+    for (uint8_t type = JACKET; type <= SHOES; type++) {
+        size_t count = getType(outfits, type).size();
+        vector<uint32_t>& heap = outfits.index.heaps[type];
+        vector<uint32_t>& heapSlots = outfits.index.heapSlots[type];
+        heap.resize(count);
+        heapSlots.resize(count);
+        for (size_t pos = 0; pos < count; pos++) heap[pos] = heapSlots[pos] = pos;
+        for (size_t slot = count / 2; slot-- > 0;) siftHeap(outfits, type, slot);
+    }
+}
+
+/* suggestIndex
+ * Builds the per-attribute use counts and kind lists suggestClothing searches with,
+ * if they are not there yet.
+ *
+ * Parameters:
+ *   outfits - wardrobe to index.
+ *
+ * Details:
+ *   - Built in O(n) on the first suggestion, e.g. after a typo, then kept
+ *     current by insertClothing and eraseClothingAt in O(1), like groupIndex.
+ *   - A kind stays listed under its values once its last item leaves, as its
+ *     positions entry does, so the lists only grow when a new kind appears.
+ */
+void suggestIndex(Wardrobe& outfits) {
+    if (outfits.index.suggesting) return;
+    keyIndex(outfits);
+    outfits.index.suggesting = true;
+    for (auto& uses : outfits.index.valueUses) uses.assign(attributeCount(), 0);
+    for (auto& kinds : outfits.index.valueKinds) kinds.assign(kindSlot(AttributeId(attributeCount()), 0, false), {});
+    for (uint8_t type = JACKET; type <= SHOES; type++) {
+        for (const auto& item : getType(outfits, type)) countValues(outfits.index, item, 1);
+    }
+    for (const auto& entry : outfits.index.positions) listKind(outfits.index, entry.first);
+}
+
+/* wearClothingAt
+ * Records a wear of an item that stays where it is, e.g. shoes, which are not washed after each wear.
+ *
+ * Parameters:
+ *   outfits - wardrobe holding the item.
+ *   type    - ClothingType of the vector it is in.
+ *   pos     - position of the item within that vector.
+ *   day     - day it was worn, as days since 1970-01-01.
+ *
+ * Returns:
+ *   The item with its updated history.
+ */
+ClothingItem wearClothingAt(Wardrobe& outfits, uint8_t type, size_t pos, int64_t day) {
+    ClothingItem& item = getType(outfits, type)[pos];
+    item.wearCount++;
+    item.lastWorn = int32_t(day);
+    stampVersion(outfits);
+    if (outfits.index.rotating) siftHeap(outfits, type, outfits.index.heapSlots[type][pos]);
+    return item;
+}
+
+/* eraseClothingAt
+ * Removes one clothing item in O(1) by moving the last item of its type into its place.
+ *
+ * Parameters:
+ *   outfits - wardrobe to update.
+ *   type    - ClothingType of the vector to erase from.
+ *   pos     - position of the item within that vector.
+ *
+ * Returns:
+ *   The removed clothing item.
+ *
+ * Details:
+ *   - Does not keep the order of the remaining items.
+ *   - With rotationIndex built, the heap update makes this O(log n).
+ */
+ClothingItem eraseClothingAt(Wardrobe& outfits, uint8_t type, size_t pos) {
+    vector<ClothingItem>& items = getType(outfits, type);
+    ClothingItem removed = items[pos];
+    size_t last = items.size() - 1;
+
+    //Both indexes store positions the same way: unlink pos, then repoint the item moved into it
+    auto relink = [&](auto& map, vector<uint32_t>& slots, auto keyOf) {
+        auto entry = map.find(keyOf(removed));
+        vector<uint32_t>& positions = entry->second;
+        uint32_t slot = slots[pos];
+        positions[slot] = positions.back();
+        slots[positions[slot]] = slot;
+        positions.pop_back();
+
+        if (pos != last) {
+            slots[pos] = slots[last];
+            map.find(keyOf(items[last]))->second[slots[pos]] = pos;
+        }
+        slots.pop_back();
+    };
+    if (outfits.index.keyed) relink(outfits.index.positions, outfits.index.slots[type], clothingKey);
+    if (outfits.index.grouped) {
+        relink(outfits.index.groups, outfits.index.groupSlots[type],
+               [](const ClothingItem& item) { return attributeGroup(item.type, item.isLong, item.material); });
+    }
+
+    if (outfits.index.rotating) {
+        //Fill the removed item's heap slot with the last heap entry, then repoint the item moved into pos
+        vector<uint32_t>& heap = outfits.index.heaps[type];
+        vector<uint32_t>& heapSlots = outfits.index.heapSlots[type];
+        size_t slot = heapSlots[pos];
+        heap[slot] = heap.back();
+        heapSlots[heap[slot]] = slot;
+        heap.pop_back();
+        if (slot < heap.size()) siftHeap(outfits, type, slot);
+        if (pos != last) {
+            heapSlots[pos] = heapSlots[last];
+            heap[heapSlots[pos]] = pos;
+        }
+        heapSlots.pop_back();
+    }
+
+    if (outfits.index.suggesting) countValues(outfits.index, removed, -1);
+
+    //Fill the hole with the last item
+    items[pos] = items[last];
+    items.pop_back();
+    stampVersion(outfits);
+    return removed;
+}
+
+/* eraseOneClothing
+ * Removes a single item equal to the given one, if there is one.
+ *
+ * Parameters:
+ *   outfits - wardrobe to update.
+ *   item    - clothing item to match.
+ *
+ * Returns:
+ *   true if an item was removed.
+ */
+bool eraseOneClothing(Wardrobe& outfits, const ClothingItem& item) {
+    keyIndex(outfits);
+    auto found = outfits.index.positions.find(clothingKey(item));
+    if (found == outfits.index.positions.end() || found->second.empty()) return false;
+    eraseClothingAt(outfits, item.type, found->second.back());
+    return true;
+}
+
+/* eraseAllClothing
+ * Removes every item equal to the given one.
+ *
+ * Parameters:
+ *   outfits - wardrobe to update.
+ *   item    - clothing item to match.
+ *
+ * Returns:
+ *   Number of items removed.
+ */
+size_t eraseAllClothing(Wardrobe& outfits, const ClothingItem& item) {
+    keyIndex(outfits);
+    auto found = outfits.index.positions.find(clothingKey(item));
+    if (found == outfits.index.positions.end()) return 0;
+    //Erasing never removes index entries, so the copies list stays valid while it empties
+    const vector<uint32_t>& copies = found->second;
+    size_t removed = 0;
+    while (!copies.empty()) {
+        eraseClothingAt(outfits, item.type, copies.back());
+        removed++;
+    }
+    return removed;
+}
+
+/* countClothing
+ * Counts how many items in a wardrobe equal the given one, in O(1).
+ *
+ * Parameters:
+ *   outfits - wardrobe to search.
+ *   item    - clothing item to match.
+ *
+ * Details:
+ *   - A wardrobe without its positions index (see keyIndex) is scanned
+ *     instead, in O(items of the type); callers counting many items key it first.
+ */
+size_t countClothing(const Wardrobe& outfits, const ClothingItem& item) {
+    if (!outfits.index.keyed) {
+        const vector<ClothingItem>& items = getType(outfits, item.type);
+        return count(items.begin(), items.end(), item);
+    }
+    auto found = outfits.index.positions.find(clothingKey(item));
+    return found == outfits.index.positions.end() ? 0 : found->second.size();
+}
+
+/* wardrobeSize
+ * Returns the total number of items across all 4 clothing types.
+ */
+size_t wardrobeSize(const Wardrobe& outfits) {
+    return outfits.jackets.size() + outfits.tops.size() + outfits.bottoms.size() + outfits.shoes.size();
 }
 
 /* addClothing
@@ -230,26 +935,120 @@ vector<ClothingItem>& getType(Wardrobe& outfits, ClothingItem Item) {
  *
  * Parameters:
  *   outfits - wardrobe to update.
+ *   added   - optional list the new item is appended to, e.g. for the journal.
  */
-void addClothing(Wardrobe& outfits) {
+void addClothing(Wardrobe& outfits, vector<ClothingItem>* added) {
     ClothingItem newItem = getUsersClothing();
-    getType(outfits, newItem).push_back(newItem);
+    insertClothing(outfits, newItem);
+    if (added) added->push_back(newItem);
+}
+
+/* formatClothing
+ * Renders one clothing item into an output buffer.
+ *
+ * Parameters:
+ *   out   - buffer to append to.
+ *   item  - item to render.
+ *   names - attribute table from attributeTable(), used to decode IDs.
+ *   mode  - OUTPUT_PRETTY for the readable listing, OUTPUT_COMPACT for a
+ *           CSV line as stored in outfits.csv, OUTPUT_TSV for tab-separated fields.
+ *
+ * Details:
+ *   - Wear history is shown once an item has been worn; TSV rows always carry
+ *     the wearCount and lastWorn columns, lastWorn empty for never.
+ */
+void formatClothing(OutputBuffer& out, const ClothingItem& item, const vector<string_view>& names,
+                    OutputMode mode) {
+    if (mode == OUTPUT_PRETTY) {
+        out.append("       Type: ");
+        out.append(typeName(item.type));
+        out.append(item.isLong ? ", Is Long: Yes, Material: " : ", Is Long: No, Material: ");
+        out.append(names[item.material]);
+        out.append(", Color: ");
+        out.append(names[item.color]);
+        out.append(", Pattern: ");
+        out.append(names[item.pattern]);
+        if (item.wearCount > 0) {
+            out.append(", Worn: ");
+            out.appendNumber(item.wearCount);
+        }
+        if (item.lastWorn != NEVER_WORN) {
+            out.append(", Last Worn: ");
+            out.append(formatDay(item.lastWorn));
+        }
+        return;
+    }
+    char separator = mode == OUTPUT_TSV ? '\t' : ',';
+    out.append(typeName(item.type));
+    out.append(separator);
+    out.append(item.isLong ? "true" : "false");
+    out.append(separator);
+    out.append(names[item.material]);
+    out.append(separator);
+    out.append(names[item.color]);
+    out.append(separator);
+    out.append(names[item.pattern]);
+    //TSV always has the history columns; CSV lines only once the item has been worn
+    if (mode == OUTPUT_TSV || hasWearHistory(item)) {
+        out.append(separator);
+        out.appendNumber(item.wearCount);
+        out.append(separator);
+        if (item.lastWorn != NEVER_WORN) out.append(formatDay(item.lastWorn));
+    }
+}
+
+/* formatOutfit
+ * Renders one outfit as its garments' CSV lines joined by " | ", ending the line.
+ *
+ * Parameters:
+ *   out     - buffer to append to.
+ *   outfit  - outfit to render: top, bottom, shoes, then the jacket if it has one.
+ *   names   - attribute table from attributeTable().
+ */
+void formatOutfit(OutputBuffer& out, const Outfit& outfit, const vector<string_view>& names) {
+    formatClothing(out, outfit.top, names, OUTPUT_COMPACT);
+    out.append(" | ");
+    formatClothing(out, outfit.bottom, names, OUTPUT_COMPACT);
+    out.append(" | ");
+    formatClothing(out, outfit.shoes, names, OUTPUT_COMPACT);
+    if (outfit.hasJacket) {
+        out.append(" | ");
+        formatClothing(out, outfit.jacket, names, OUTPUT_COMPACT);
+    }
+    out.append('\n');
+}
+
+/* writeClothing
+ * Renders a list of items, one per line, without flushing.
+ */
+static void writeClothing(OutputBuffer& out, const vector<ClothingItem>& clothes,
+                          const vector<string_view>& names, OutputMode mode) {
+    for (const auto& item : clothes) {
+        formatClothing(out, item, names, mode);
+        out.append('\n');
+    }
 }
 
+// Headings of the pretty wardrobe listing, by ClothingType
+static const char* TYPE_HEADINGS[] = {"\nJackets: \n", "\nTops: \n", "\nBottoms: \n", "\nShoes: \n"};
+
 /* printClothing
  * Displays a list of clothing items in a readable format.
  *
  * Parameters:
  *   clothes - vector of ClothingItem objects to display.
+ *   mode    - output format; see formatClothing.
+ *
+ * Details:
+ *   - Renders into the shared stdout buffer and writes it in large chunks,
+ *     instead of flushing after every item.
  */
-void printClothing(const vector<ClothingItem>& clothes) {
-    for (const auto& item : clothes) {
-        cout << "       Type: " << item.type 
-             << ", Is Long: " << (item.isLong ? "Yes" : "No")
-             << ", Material: " << item.material 
-             << ", Color: " << item.color 
-             << ", Pattern: " << item.pattern << endl;
-    }
+void printClothing(const vector<ClothingItem>& clothes, OutputMode mode) {
+    thread_local vector<string_view> names;
+    attributeTable(names);      //decode IDs only here, at the output boundary
+    OutputBuffer& out = standardOutput();
+    writeClothing(out, clothes, names, mode);
+    out.flush();
 }
 
 /* printWardrobe
@@ -257,19 +1056,20 @@ void printClothing(const vector<ClothingItem>& clothes) {
  *
  * Parameters:
  *   outfits - wardrobe to display.
+ *   mode    - OUTPUT_PRETTY lists items under per-type headings; OUTPUT_COMPACT
+ *             prints bare CSV lines; OUTPUT_TSV prints a header row first.
  */
-void printWardrobe(const Wardrobe& outfits) {
-    cout << "\nJackets: \n";
-    printClothing(outfits.jackets);
+void printWardrobe(const Wardrobe& outfits, OutputMode mode) {
+    thread_local vector<string_view> names;
+    attributeTable(names);
+    OutputBuffer& out = standardOutput();
 
-    cout<< "\nTops: \n";
-    printClothing(outfits.tops);
-
-    cout << "\nBottoms: \n";
-    printClothing(outfits.bottoms);
-
-    cout << "\nShoes: \n";
-    printClothing(outfits.shoes);
+    if (mode == OUTPUT_TSV) out.append("type\tisLong\tmaterial\tcolor\tpattern\twearCount\tlastWorn\n");
+    for (uint8_t type = JACKET; type <= SHOES; type++) {
+        if (mode == OUTPUT_PRETTY) out.append(TYPE_HEADINGS[type]);
+        writeClothing(out, getType(outfits, type), names, mode);
+    }
+    out.flush();
 }
 
 /* removeClothing
@@ -277,52 +1077,115 @@ void printWardrobe(const Wardrobe& outfits) {
  *
  * Parameters:
  *   outfits - wardrobe to update.
+ *   removed - optional list each removed item is appended to.
+ *
+ * Details:
+ *   - If nothing matches, the closest items are offered (see offerSuggestions).
  */
-void removeClothing(Wardrobe& outfits) {
+void removeClothing(Wardrobe& outfits, vector<ClothingItem>* removed) {
     ClothingItem itemToRemove = getUsersClothing();
-    vector<ClothingItem>& type = getType(outfits, itemToRemove);
-    int og_sz = type.size();
-    type.erase(remove_if(type.begin(), type.end(),
-                  [&itemToRemove](const ClothingItem& item) {
-                      return item == itemToRemove;}), type.end());
-    
-    if (type.size() == og_sz) cout << "Error: No matching item found. Please check your input and try again.";
+    if (countClothing(outfits, itemToRemove) == 0) offerSuggestions(outfits, itemToRemove);
+    size_t count = eraseAllClothing(outfits, itemToRemove);
+    if (removed) removed->insert(removed->end(), count, itemToRemove);
+    if (count == 0) cout << "Error: No matching item found. Please check your input and try again.";
     else cout << "Item removed successfully!";
 }
 
 /* updateVectors
- * Moves items from one vector to another, excluding those that should stay.
+ * Moves items of one type from one wardrobe to another, excluding those that should stay.
  *
  * Parameters:
- *   src  - source vector.
- *   dest - destination vector.
- *   stay - items to remain in source.
+ *   src   - source wardrobe.
+ *   dest  - destination wardrobe.
+ *   stay  - items to remain in source.
+ *   type  - ClothingType of the vectors to update.
+ *   moved - optional list each moved item is appended to.
+ *
+ * Details:
+ *   - stay is treated as a multiset: each entry keeps one matching item in src,
+ *     and any further copies of that item are moved like the rest.
+ *   - Runs in time linear in the size of src, using the hash indexes; types
+ *     with nothing in stay skip the lookups. To move a few named items out of
+ *     a large src, moveClothing costs only the items moved.
+ *   - Allocates nothing once dest and moved have room for the items: the
+ *     bookkeeping lives in a ScratchArena.
  */
-void updateVectors(vector<ClothingItem>& src, vector<ClothingItem>& dest, const vector<ClothingItem>& stay) {
-    for (int i = 0; i < src.size(); i++) {
-        //Add elements from src to dest, unless they are in 'stay'
-        if (find(stay.begin(), stay.end(), src[i]) == stay.end()) {
-            dest.push_back(src[i]);
-        } 
+void updateVectors(Wardrobe& src, Wardrobe& dest, const Wardrobe& stay, uint8_t type,
+                   vector<ClothingItem>* moved) {
+    vector<ClothingItem>& items = getType(src, type);
+    [[maybe_unused]] size_t initial = items.size();     //only read by STAT_ADD
+    ScratchArena scratch;
+    pmr::unordered_map<uint64_t, size_t> kept(scratch.resource());     //copies of each stay item already kept in src
+
+    bool keepAny = !getType(stay, type).empty();
+
+    //Walk backwards so eraseClothingAt only swaps in items that were already checked
+    for (size_t i = items.size(); i-- > 0;) {
+        size_t wanted = keepAny ? countClothing(stay, items[i]) : 0;
+        if (wanted > 0) {
+            size_t& keptCount = kept[clothingKey(items[i])];
+            if (keptCount < wanted) {
+                keptCount++;
+                continue;
+            }
+        }
+        ClothingItem item = eraseClothingAt(src, type, i);
+        insertClothing(dest, item);
+        if (moved) moved->push_back(item);
     }
-    //As long as src wasn't an empty vector (i.e. dirtyLaundry.csv was empty),
-    //src vector becomes the stay vector, ensuring items meant to stay, remain
-    if (!src.empty()) src = stay;
+    //Without stay items of this type nothing was looked up
+    if (keepAny) STAT_ADD(STAT_COMPARISONS, initial);
 }
 
 /* updateWardrobes
  * Moves items between two wardrobes, excluding items that should stay.
  *
  * Parameters:
- *   src  - source wardrobe.
- *   dest - destination wardrobe.
- *   stay - items to remain in source.
+ *   src   - source wardrobe.
+ *   dest  - destination wardrobe.
+ *   stay  - items to remain in source.
+ *   moved - optional list each moved item is appended to.
+ */
+void updateWardrobes(Wardrobe& src, Wardrobe& dest, const Wardrobe& stay, vector<ClothingItem>* moved) {
+    STAT_SCOPE(TIMER_LAUNDRY);
+    updateVectors(src, dest, stay, SHOES, moved);
+    updateVectors(src, dest, stay, BOTTOM, moved);
+    updateVectors(src, dest, stay, TOP, moved);
+    updateVectors(src, dest, stay, JACKET, moved);
+}
+
+/* moveClothing
+ * Moves the given items from one wardrobe to another, e.g. washing a few
+ * dirty clothes, without looking at the rest of either wardrobe.
+ *
+ * Parameters:
+ *   src   - wardrobe the items are in.
+ *   dest  - wardrobe to move them into.
+ *   items - items to move; an item listed k times moves up to k copies.
+ *   moved - optional list each moved item is appended to.
+ *
+ * Returns:
+ *   Number of items moved; items with no copy left in src are skipped.
+ *
+ * Details:
+ *   - Each item is found through the hash index and swapped out in O(1)
+ *     (O(log n) with the rotation heaps built), so a wash costs O(items
+ *     changed) however large the pile is, where updateWardrobes looks at
+ *     every item of src.
+ *   - The copies in src are what move, so they keep their wear history.
  */
-void updateWardrobes(Wardrobe& src, Wardrobe& dest, const Wardrobe& stay) {
-    updateVectors(src.shoes, dest.shoes, stay.shoes);
-    updateVectors(src.bottoms, dest.bottoms, stay.bottoms);
-    updateVectors(src.tops, dest.tops, stay.tops);
-    updateVectors(src.jackets, dest.jackets, stay.jackets);
+size_t moveClothing(Wardrobe& src, Wardrobe& dest, const vector<ClothingItem>& items, vector<ClothingItem>* moved) {
+    keyIndex(src);
+    size_t count = 0;
+    for (const ClothingItem& item : items) {
+        auto found = src.index.positions.find(clothingKey(item));
+        if (found == src.index.positions.end() || found->second.empty()) continue;
+        ClothingItem taken = eraseClothingAt(src, item.type, found->second.back());
+        insertClothing(dest, taken);
+        if (moved) moved->push_back(taken);
+        count++;
+    }
+    return count;
 }
 
 /* pushDatabase
@@ -331,22 +1194,38 @@ void updateWardrobes(Wardrobe& src, Wardrobe& dest, const Wardrobe& stay) {
  * Parameters:
  *   src      - wardrobe to save.
  *   filename - path to CSV file.
+ *
+ * Returns:
+ *   true if the whole wardrobe was written.
+ *
+ * Details:
+ *   - A filename ending in ".bin" is saved as a binary snapshot instead.
+ *   - Worn items get two more fields, wearCount and lastWorn (YYYY-MM-DD);
+ *     items never worn are written in the original five-field format.
  */
-void pushDatabase(const Wardrobe& src, const string& filename) {
+bool pushDatabase(const Wardrobe& src, const string& filename) {
+    STAT_SCOPE(TIMER_SAVE);
+    if (isSnapshotPath(filename)) return writeSnapshot(src, filename);
     ofstream file(filename);
     if (!file.is_open()) {
         cerr << "Error: Could not open file for writing.";
-        return;
+        return false;
     }
 
+    vector<string_view> names = attributeTable();
     //Lambda to write all ClothingItems of a certain type into file
     auto writeVector = [&](const vector<ClothingItem>& items) {
         for (const auto& item : items) {
-            file << item.type << ","
+            file << typeName(item.type) << ","
                     << (item.isLong ? "true" : "false") << ","
-                    << item.material << ","
-                    << item.color << ","
-                    << item.pattern << "\n";
+                    << names[item.material] << ","
+                    << names[item.color] << ","
+                    << names[item.pattern];
+            if (hasWearHistory(item)) {
+                file << "," << item.wearCount << ","
+                     << (item.lastWorn != NEVER_WORN ? formatDay(item.lastWorn) : string());
+            }
+            file << "\n";
         }
     };
     //Write all 4 vectors from wardrobe into the file
@@ -355,7 +1234,244 @@ void pushDatabase(const Wardrobe& src, const string& filename) {
     writeVector(src.bottoms);
     writeVector(src.shoes);
 
+    STAT_ADD(STAT_BYTES_WRITTEN, max<streamoff>(file.tellp(), 0));
     file.close();
+    return !file.fail();
+}
+
+/* pickNremove
+ * Randomly picks a clothing item of a type and removes it from the wardrobe.
+ *
+ * Parameters:
+ *   from - wardrobe to pick from.
+ *   type - ClothingType to pick.
+ *
+ * Returns:
+ *   The chosen clothing item.
+ *
+ * Throws:
+ *   runtime_error if there are no items of that type.
+ *
+ * Details:
+ *   - O(1): draws an unbiased index from pickerRng() and swap-and-pops it out.
+ */
+ClothingItem pickNremove(Wardrobe& from, uint8_t type) {
+    size_t count = getType(from, type).size();
+    if (count == 0) throw runtime_error("You have no items of this clothing type to choose from.");
+    return eraseClothingAt(from, type, uniformIndex(pickerRng(), count));
+}
+
+/* suitablePosition
+ * Draws a random position among the items of a type that meet the given preferences.
+ *
+ * Parameters:
+ *   outfits - wardrobe to draw from, with groupIndex built; the type must have at least one item.
+ *   type    - ClothingType to draw.
+ *   length  - preferred LengthFilter.
+ *   avoid   - materials to leave out.
+ *   rng     - generator to draw from.
+ *
+ * Details:
+ *   - Walks the attribute groups (one per type, length and material) instead of
+ *     the items, so unsuitable items are skipped without being looked at.
+ *   - Preferences are soft: if nothing clean meets them, the length preference is
+ *     dropped first, then the materials, so an outfit is still picked.
+ */
+static size_t suitablePosition(const Wardrobe& outfits, uint8_t type, uint8_t length,
+                               const vector<AttributeId>& avoid, Xoshiro256& rng) {
+    thread_local vector<const vector<uint32_t>*> suitable;
+    for (int relax = 0; relax < 2; relax++) {
+        suitable.clear();
+        size_t total = 0;
+        for (const auto& [group, positions] : outfits.index.groups) {
+            if (group >> 17 != type) continue;
+            bool isLong = (group >> 16) & 1;
+            if (length != LENGTH_ANY && isLong != (length == LENGTH_LONG)) continue;
+            if (find(avoid.begin(), avoid.end(), AttributeId(group & 0xFFFF)) != avoid.end()) continue;
+            suitable.push_back(&positions);
+            total += positions.size();
+        }
+        if (total > 0) {
+            size_t pick = uniformIndex(rng, total);
+            for (const vector<uint32_t>* positions : suitable) {
+                if (pick < positions->size()) return (*positions)[pick];
+                pick -= positions->size();
+            }
+        }
+        if (length == LENGTH_ANY) break;
+        length = LENGTH_ANY;
+    }
+    return uniformIndex(rng, getType(outfits, type).size());
+}
+
+// Heap entries rotationPosition looks at before giving up on a preference
+static const size_t ROTATION_SEARCH_LIMIT = 64;
+
+/* rotationPosition
+ * Finds the least recently worn item of a type that meets the given preferences.
+ *
+ * Parameters:
+ *   outfits - wardrobe to draw from, with rotationIndex built; the type must have at least one item.
+ *   type    - ClothingType to draw.
+ *   length  - preferred LengthFilter.
+ *   avoid   - materials to leave out.
+ *
+ * Details:
+ *   - Without preferences this is the top of the heap, O(1).
+ *   - With them, heap entries are visited in worn order (best first, through a
+ *     small frontier heap) until one fits, up to ROTATION_SEARCH_LIMIT entries,
+ *     so a pick costs O(log n) whatever the wardrobe size. As in suitablePosition,
+ *     the length preference is dropped first, then the materials.
+ */
+static size_t rotationPosition(const Wardrobe& outfits, uint8_t type, uint8_t length,
+                               const vector<AttributeId>& avoid) {
+    const vector<ClothingItem>& items = getType(outfits, type);
+    const vector<uint32_t>& heap = outfits.index.heaps[type];
+    if (length == LENGTH_ANY && avoid.empty()) return heap.front();
+
+    auto suits = [&](const ClothingItem& item) {
+        if (length != LENGTH_ANY && item.isLong != (length == LENGTH_LONG)) return false;
+        return find(avoid.begin(), avoid.end(), item.material) == avoid.end();
+    };
+    //std heaps keep the largest on top, so order the frontier by "worn later"
+    auto later = [&](uint32_t a, uint32_t b) { return wornBefore(items[heap[b]], items[heap[a]]); };
+    thread_local vector<uint32_t> frontier;
+    for (int relax = 0; relax < 2; relax++) {
+        frontier.assign(1, 0);
+        for (size_t visited = 0; !frontier.empty() && visited < ROTATION_SEARCH_LIMIT; visited++) {
+            pop_heap(frontier.begin(), frontier.end(), later);
+            uint32_t slot = frontier.back();
+            frontier.pop_back();
+            if (suits(items[heap[slot]])) return heap[slot];
+            for (size_t child = 2 * size_t(slot) + 1; child <= 2 * size_t(slot) + 2 && child < heap.size(); child++) {
+                frontier.push_back(child);
+                push_heap(frontier.begin(), frontier.end(), later);
+            }
+        }
+        if (length == LENGTH_ANY) break;
+        length = LENGTH_ANY;
+    }
+    return heap.front();
+}
+
+/* pickInto
+ * Plans n outfits into result, reusing the capacity it already has
+ * (see pickOutfits).
+ */
+static void pickInto(Wardrobe& outfits, Wardrobe& dirty, size_t n, const PickOptions& options, Xoshiro256& rng,
+                     PickResult& result) {
+    STAT_SCOPE(TIMER_PICK);
+    result.outfits.clear();
+    result.ranDry = false;
+    result.dryType = 0;
+    //No more outfits can be planned than there are tops, bottoms (and jackets) to wear
+    size_t possible = min({n, outfits.tops.size(), outfits.bottoms.size()});
+    if (options.jacket) possible = min(possible, outfits.jackets.size());
+    result.outfits.reserve(possible);
+    ScratchArena scratch;
+    pmr::vector<ClothingItem> worn(scratch.resource());
+    worn.reserve(possible * (options.jacket ? 3 : 2));
+
+    //Lambdas to draw a position of a type, following any preferences, and to remove and wear it
+    bool preferring = options.length != LENGTH_ANY || !options.avoidMaterials.empty();
+    if (options.rotation) rotationIndex(outfits);
+    else if (preferring) groupIndex(outfits);
+    auto draw = [&](uint8_t type) {
+        uint8_t length = type == TOP || type == BOTTOM ? options.length : uint8_t(LENGTH_ANY);
+        if (options.rotation) return rotationPosition(outfits, type, length, options.avoidMaterials);
+        if (!preferring) return size_t(uniformIndex(rng, getType(outfits, type).size()));
+        return suitablePosition(outfits, type, length, options.avoidMaterials, rng);
+    };
+    int64_t day = options.day == DAY_TODAY ? today() : options.day;
+    auto take = [&](uint8_t type) {
+        ClothingItem item = eraseClothingAt(outfits, type, draw(type));
+        item.wearCount++;
+        item.lastWorn = int32_t(day);
+        return item;
+    };
+
+    const uint8_t needed[] = {SHOES, BOTTOM, TOP, JACKET};
+    size_t neededCount = options.jacket ? 4 : 3;
+    for (size_t i = 0; i < n; i++) {
+        for (size_t t = 0; t < neededCount && !result.ranDry; t++) {
+            if (getType(outfits, needed[t]).empty()) {
+                result.ranDry = true;
+                result.dryType = needed[t];
+            }
+        }
+        if (result.ranDry) break;
+
+        Outfit outfit{};
+        outfit.shoes = wearClothingAt(outfits, SHOES, draw(SHOES), day);
+        outfit.bottom = take(BOTTOM);
+        outfit.top = take(TOP);
+        outfit.hasJacket = options.jacket;
+        if (options.jacket) outfit.jacket = take(JACKET);
+
+        worn.push_back(outfit.bottom);
+        worn.push_back(outfit.top);
+        if (options.jacket) worn.push_back(outfit.jacket);
+        result.outfits.push_back(outfit);
+        day++;
+    }
+
+    // Move to dirty wardrobe
+    insertRange(dirty, worn.data(), worn.size());
+    STAT_ADD(STAT_PICKS, result.outfits.size());
+}
+
+/* pickOutfits
+ * Plans several outfits at once without any console output.
+ *
+ * Parameters:
+ *   outfits - wardrobe to pick from.
+ *   dirty   - wardrobe to move worn clothes into.
+ *   n       - number of outfits to plan.
+ *   options - what each outfit should include.
+ *   rng     - generator to draw picks from; defaults to this thread's picker.
+ *
+ * Returns:
+ *   The outfits in the order they were picked. If a clothing type runs out
+ *   first, the result holds fewer than n outfits and ranDry/dryType say why.
+ *
+ * Details:
+ *   - Tops, bottoms and jackets are sampled without replacement across all n
+ *     outfits; shoes are shared between outfits, as they are not washed after a wear.
+ *   - An outfit is only started once every type it needs is available, so a
+ *     dry wardrobe never loses half-picked items.
+ *   - Worn items reach dirty in one bulk insert at the end; until then they are
+ *     kept in a ScratchArena, so the returned outfits are the only allocation
+ *     once the wardrobes have room.
+ *   - options.length and options.avoidMaterials steer the draws through the
+ *     attribute groups (see suitablePosition); without them picks draw straight
+ *     from the vectors, so seeded results are unchanged.
+ *   - Outfit i is worn on options.day + i: every item in it, shoes included, has
+ *     its wear count and last-worn day updated, and the outfit holds the updated items.
+ *   - options.rotation replaces the random draws with the least recently worn
+ *     items from the rotation heaps (see rotationPosition); the rng is not used.
+ */
+PickResult pickOutfits(Wardrobe& outfits, Wardrobe& dirty, size_t n, const PickOptions& options, Xoshiro256& rng) {
+    PickResult result;
+    pickInto(outfits, dirty, n, options, rng, result);
+    return result;
+}
+
+/* printOutfit
+ * Displays one outfit under the same per-type headings as printWardrobe.
+ */
+static void printOutfit(const Outfit& outfit) {
+    thread_local vector<string_view> names;
+    attributeTable(names);
+    OutputBuffer& out = standardOutput();
+    const ClothingItem* pieces[] = {outfit.hasJacket ? &outfit.jacket : nullptr, &outfit.top, &outfit.bottom,
+                                    &outfit.shoes};
+    for (uint8_t type = JACKET; type <= SHOES; type++) {
+        out.append(TYPE_HEADINGS[type]);
+        if (!pieces[type]) continue;
+        formatClothing(out, *pieces[type], names, OUTPUT_PRETTY);
+        out.append('\n');
+    }
+    out.flush();
 }
 
 /* pickOutfit
@@ -365,33 +1481,41 @@ void pushDatabase(const Wardrobe& src, const string& filename) {
  *   outfits - wardrobe to pick from.
  *   dirty   - wardrobe to move worn clothes into.
  *   jacket  - whether to include a jacket in the outfit.
+ *   worn    - optional list the items moved to dirty are appended to.
+ *
+ * Throws:
+ *   runtime_error if a clothing type the outfit needs has no clean items.
+ *
+ * Returns:
+ *   The outfit, with every item's wear history already updated.
+ *
+ * Details:
+ *   - Picks are drawn from pickerRng(); call seedPicker first for a reproducible outfit.
  */
-void pickOutfit(Wardrobe& outfits, Wardrobe& dirty, bool jacket) {
-    Wardrobe picked;
-
-    //Lambda to randomly pick a clothing item from vector parameter
-    //      removes chosen item from the outfits database
-    auto pickNremove = [&](vector<ClothingItem>& from) -> ClothingItem {
-        if (from.empty()) throw runtime_error("You have no items of this clothing type to choose from.");
-        int index = rand() % from.size();
-        ClothingItem chosen = from[index];
-        from.erase(from.begin() + index);
-        return chosen;
-    };
-    
-    //manually choose shoes, as shoes don't need washed after 1 wear
-    int index = rand() % outfits.shoes.size();
-    ClothingItem chosenShoe = outfits.shoes[index];
-    picked.shoes.push_back(chosenShoe);
-    picked.bottoms.push_back(pickNremove(outfits.bottoms));
-    picked.tops.push_back(pickNremove(outfits.tops));
-    if (jacket) picked.jackets.push_back(pickNremove(outfits.jackets)); //only choose jacket if user said so
+Outfit pickOutfit(Wardrobe& outfits, Wardrobe& dirty, bool jacket, vector<ClothingItem>* worn) {
+    PickOptions options;
+    options.jacket = jacket;
+    return pickOutfit(outfits, dirty, options, worn);
+}
 
-    // Move to dirty wardrobe
-    dirty.bottoms.insert(dirty.bottoms.end(), picked.bottoms.begin(), picked.bottoms.end());
-    dirty.tops.insert(dirty.tops.end(), picked.tops.begin(), picked.tops.end());
-    dirty.jackets.insert(dirty.jackets.end(), picked.jackets.begin(), picked.jackets.end());
+/* pickOutfit
+ * Generates and displays a random outfit following the given options,
+ * e.g. the advice for today's weather.
+ */
+Outfit pickOutfit(Wardrobe& outfits, Wardrobe& dirty, const PickOptions& options, vector<ClothingItem>* worn) {
+    //Reused between calls, so a pick allocates nothing once the wardrobes have room
+    thread_local PickResult result;
+    pickInto(outfits, dirty, 1, options, pickerRng(), result);
+    if (result.ranDry) throw runtime_error("You have no items of this clothing type to choose from.");
+
+    Outfit outfit = result.outfits.front();
+    if (worn) {
+        worn->push_back(outfit.bottom);
+        worn->push_back(outfit.top);
+        if (outfit.hasJacket) worn->push_back(outfit.jacket);
+    }
 
     cout << "\n\nToday's Outfit: ";
-    printWardrobe(picked);
+    printOutfit(outfit);
+    return outfit;
 }
\ No newline at end of file
@@ -0,0 +1,78 @@
+/* Nolan Pierce - Outfit Planner Implementation
+ *
+ * Overview:
+ *   Runs pickOutfits for many accounts in parallel on a work-stealing pool,
+ *   for jobs such as planning tomorrow's outfit for every account overnight.
+ */
+#include "../Headers/OutfitPlanner.h"
+#include "../Headers/Conditions.h"
+#include <algorithm>
+
+using namespace std;
+
+/* planOutfits
+ * Plans n outfits for every account, spreading the accounts across the pool.
+ *
+ * Parameters:
+ *   accounts - clean/dirty wardrobe pairs; each is updated like pickOutfits does.
+ *   n        - number of outfits to plan per account.
+ *   options  - what each outfit should include.
+ *   seed     - base seed for the whole run.
+ *   pool     - threads to run on.
+ *
+ * Returns:
+ *   One PickResult per account, in the same order as accounts.
+ *
+ * Details:
+ *   - Every account draws from its own generator, seeded from (seed, account index),
+ *     so no RNG state is shared and results do not depend on how many threads run
+ *     or which worker handles which account.
+ */
+vector<PickResult> planOutfits(vector<WardrobePair>& accounts, size_t n, const PickOptions& options,
+                               uint64_t seed, ThreadPool& pool) {
+    vector<PickResult> results(accounts.size());
+
+    //Several tasks per worker leaves room for stealing when wardrobe sizes are uneven
+    size_t chunk = max<size_t>(1, accounts.size() / (pool.size() * 8));
+    for (size_t begin = 0; begin < accounts.size(); begin += chunk) {
+        size_t end = min(accounts.size(), begin + chunk);
+        pool.submit([&, begin, end] {
+            for (size_t i = begin; i < end; i++) {
+                Xoshiro256 rng(streamSeed(seed, i));
+                results[i] = pickOutfits(accounts[i].outfits, accounts[i].dirty, n, options, rng);
+            }
+        });
+    }
+    pool.wait();
+    return results;
+}
+
+/* planOutfits
+ * Plans one outfit per day for every account, each day following its own options.
+ *
+ * Parameters:
+ *   accounts - clean/dirty wardrobe pairs.
+ *   days     - options for each day, e.g. from adviseDays; worked out once and
+ *              shared by every account, so the weather is not looked up per outfit.
+ *   seed     - base seed for the whole run.
+ *   pool     - threads to run on.
+ *
+ * Returns:
+ *   One PickResult per account, in the same order as accounts.
+ */
+vector<PickResult> planOutfits(vector<WardrobePair>& accounts, const vector<PickOptions>& days,
+                               uint64_t seed, ThreadPool& pool) {
+    vector<PickResult> results(accounts.size());
+    size_t chunk = max<size_t>(1, accounts.size() / (pool.size() * 8));
+    for (size_t begin = 0; begin < accounts.size(); begin += chunk) {
+        size_t end = min(accounts.size(), begin + chunk);
+        pool.submit([&, begin, end] {
+            for (size_t i = begin; i < end; i++) {
+                Xoshiro256 rng(streamSeed(seed, i));
+                results[i] = pickOutfitsForDays(accounts[i].outfits, accounts[i].dirty, days, rng);
+            }
+        });
+    }
+    pool.wait();
+    return results;
+}
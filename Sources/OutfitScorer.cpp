@@ -0,0 +1,469 @@
+/* Nolan Pierce - Outfit Scorer Implementation
+ *
+ * Overview:
+ *   Rates outfits by how well their garments go together, using color, pattern
+ *   and material rules read from a config file, and finds the best-scoring
+ *   outfits in a wardrobe without trying every combination.
+ *
+ * Details:
+ *   - Garments that share a material, color and pattern always score the same,
+ *     so each category is reduced to its distinct styles first.
+ *   - Rules are folded into one small score matrix per RuleKind, and then into
+ *     a table per pair of categories (top x bottom, top x shoes, ...), so
+ *     scoring a combination is a handful of table lookups.
+ *   - The search is a depth-first branch-and-bound over top, bottom, shoes and
+ *     jacket: a branch is dropped once the best score it could still reach,
+ *     from per-row maxima of the tables, cannot beat the k-th best found so far.
+ *   - Styles, tables and bounds form a ScorePlan that is built once and can be
+ *     searched for any k, so a cache can skip everything but the search.
+ */
+#include "../Headers/OutfitScorer.h"
+#include "../Headers/MappedFile.h"
+#include <algorithm>
+#include <charconv>
+
+using namespace std;
+
+// Search order; jackets come last so the three-garment case is a prefix
+static const uint8_t LEVEL_TYPES[] = {TOP, BOTTOM, SHOES, JACKET};
+static const uint32_t NO_VALUE = 0xFFFFFFFF;
+
+/* attributeOf
+ * Returns the attribute of an item that a rule kind looks at.
+ */
+static AttributeId attributeOf(const ClothingItem& item, uint8_t kind) {
+    if (kind == RULE_COLOR) return item.color;
+    if (kind == RULE_PATTERN) return item.pattern;
+    return item.material;
+}
+
+/* parseRuleKind
+ * Converts "color", "pattern" or "material" to a RuleKind.
+ */
+static bool parseRuleKind(string_view text, uint8_t& kind) {
+    if (text == "color") kind = RULE_COLOR;
+    else if (text == "pattern") kind = RULE_PATTERN;
+    else if (text == "material") kind = RULE_MATERIAL;
+    else return false;
+    return true;
+}
+
+/* parseStyleRules
+ * Parses style rules that are already in memory.
+ *
+ * Parameters:
+ *   contents - full text of a rules file; see OutfitScorer.h for the format.
+ *   skipped  - optional count of lines that were not blank or comments but
+ *              could not be read as a rule.
+ *
+ * Returns:
+ *   The rules in file order.
+ */
+StyleRules parseStyleRules(string_view contents, size_t* skipped) {
+    StyleRules parsed;
+    if (skipped) *skipped = 0;
+
+    while (!contents.empty()) {
+        size_t end = contents.find('\n');
+        string_view line = contents.substr(0, end);
+        contents.remove_prefix(end == string_view::npos ? contents.size() : end + 1);
+        if (!line.empty() && line.back() == '\r') line.remove_suffix(1);
+        if (line.empty() || line.front() == '#') continue;
+
+        //kind,valueA,valueB,score
+        string_view fields[4];
+        size_t count = 0;
+        while (count < 4) {
+            size_t comma = line.find(',');
+            fields[count++] = line.substr(0, comma);
+            if (comma == string_view::npos) break;
+            line.remove_prefix(comma + 1);
+        }
+
+        StyleRule rule{};
+        string_view scoreText = count == 4 ? fields[3] : string_view();
+        auto [rest, error] = from_chars(scoreText.data(), scoreText.data() + scoreText.size(), rule.score);
+        if (count != 4 || line.find(',') != string_view::npos || !parseRuleKind(fields[0], rule.kind) ||
+            error != errc() || rest != scoreText.data() + scoreText.size()) {
+            if (skipped) (*skipped)++;
+            continue;
+        }
+        rule.anyA = fields[1] == "*";
+        rule.anyB = fields[2] == "*";
+        rule.a = rule.anyA ? 0 : internAttribute(fields[1]);
+        rule.b = rule.anyB ? 0 : internAttribute(fields[2]);
+        parsed.rules.push_back(rule);
+    }
+    return parsed;
+}
+
+/* loadStyleRules
+ * Reads style rules from a file; a missing file gives no rules.
+ */
+StyleRules loadStyleRules(const string& filename, size_t* skipped) {
+    MappedFile file(filename);
+    return parseStyleRules(file.view(), skipped);
+}
+
+/* scorePair
+ * Scores two garments against every rule directly.
+ *
+ * Returns:
+ *   Sum of the scores of all rules matching either way round, each counted once.
+ */
+int scorePair(const StyleRules& rules, const ClothingItem& a, const ClothingItem& b) {
+    int score = 0;
+    for (const auto& rule : rules.rules) {
+        AttributeId x = attributeOf(a, rule.kind);
+        AttributeId y = attributeOf(b, rule.kind);
+        bool forward = (rule.anyA || rule.a == x) && (rule.anyB || rule.b == y);
+        bool backward = (rule.anyA || rule.a == y) && (rule.anyB || rule.b == x);
+        if (forward || backward) score += rule.score;
+    }
+    return score;
+}
+
+/* scoreOutfit
+ * Scores a whole outfit as the sum of scorePair over every pair of its garments.
+ */
+int scoreOutfit(const StyleRules& rules, const Outfit& outfit) {
+    int score = scorePair(rules, outfit.top, outfit.bottom) + scorePair(rules, outfit.top, outfit.shoes) +
+                scorePair(rules, outfit.bottom, outfit.shoes);
+    if (outfit.hasJacket) {
+        score += scorePair(rules, outfit.jacket, outfit.top) + scorePair(rules, outfit.jacket, outfit.bottom) +
+                 scorePair(rules, outfit.jacket, outfit.shoes);
+    }
+    return score;
+}
+
+// Rule scores for one RuleKind between the attribute values a wardrobe uses
+struct AttributeMatrix {
+    vector<uint32_t> localOf;       // AttributeId -> row, or NO_VALUE if unused
+    vector<int> scores;             // size x size, symmetric
+    size_t size = 0;
+};
+
+// The distinct styles of one category and their rows in each AttributeMatrix
+struct StyleLevel {
+    vector<ClothingItem> styles;
+    vector<uint32_t> rows[3];       // indexed by RuleKind
+};
+
+// Pairwise table between two levels and its maxima, used for the bounds
+struct PairTable {
+    vector<int> scores;             // first level's style x second level's style
+    vector<int> rowMax;             // best score for each style of the first level
+    vector<int> colMax;             // best score for each style of the second level
+    int max = 0;
+};
+
+/* buildMatrix
+ * Folds the rules of one kind into a score matrix over the given values.
+ *
+ * Details:
+ *   - A rule with two fixed values touches at most two cells, one with a
+ *     wildcard touches a row and a column, so building is O(rules x values).
+ */
+static AttributeMatrix buildMatrix(const StyleRules& rules, uint8_t kind, const vector<AttributeId>& values) {
+    AttributeMatrix matrix;
+    matrix.localOf.assign(attributeCount(), NO_VALUE);
+    for (AttributeId value : values) {
+        if (matrix.localOf[value] == NO_VALUE) matrix.localOf[value] = matrix.size++;
+    }
+    size_t n = matrix.size;
+    matrix.scores.assign(n * n, 0);
+
+    for (const auto& rule : rules.rules) {
+        if (rule.kind != kind) continue;
+        uint32_t a = rule.anyA ? NO_VALUE : matrix.localOf[rule.a];
+        uint32_t b = rule.anyB ? NO_VALUE : matrix.localOf[rule.b];
+        if ((!rule.anyA && a == NO_VALUE) || (!rule.anyB && b == NO_VALUE)) continue;   //value not in this wardrobe
+
+        if (rule.anyA && rule.anyB) {
+            for (int& cell : matrix.scores) cell += rule.score;
+        }
+        else if (rule.anyA || rule.anyB) {
+            //Every pair containing the fixed value, with its own cell counted once
+            uint32_t fixed = rule.anyA ? b : a;
+            for (size_t other = 0; other < n; other++) {
+                matrix.scores[fixed * n + other] += rule.score;
+                if (other != fixed) matrix.scores[other * n + fixed] += rule.score;
+            }
+        }
+        else {
+            matrix.scores[a * n + b] += rule.score;
+            if (a != b) matrix.scores[b * n + a] += rule.score;
+        }
+    }
+    return matrix;
+}
+
+/* buildPairTable
+ * Scores every style of one level against every style of another.
+ */
+static PairTable buildPairTable(const StyleLevel& first, const StyleLevel& second, const AttributeMatrix matrices[3]) {
+    size_t rows = first.styles.size();
+    size_t cols = second.styles.size();
+    PairTable table;
+    table.scores.resize(rows * cols);
+    table.rowMax.assign(rows, 0);
+    table.colMax.assign(cols, 0);
+
+    for (size_t x = 0; x < rows; x++) {
+        const int* color = &matrices[RULE_COLOR].scores[first.rows[RULE_COLOR][x] * matrices[RULE_COLOR].size];
+        const int* pattern = &matrices[RULE_PATTERN].scores[first.rows[RULE_PATTERN][x] * matrices[RULE_PATTERN].size];
+        const int* material = &matrices[RULE_MATERIAL].scores[first.rows[RULE_MATERIAL][x] * matrices[RULE_MATERIAL].size];
+        int* out = &table.scores[x * cols];
+        for (size_t y = 0; y < cols; y++) {
+            out[y] = color[second.rows[RULE_COLOR][y]] + pattern[second.rows[RULE_PATTERN][y]] +
+                     material[second.rows[RULE_MATERIAL][y]];
+        }
+        table.rowMax[x] = *max_element(out, out + cols);
+    }
+    for (size_t y = 0; y < cols; y++) table.colMax[y] = table.scores[y];
+    for (size_t x = 1; x < rows; x++) {
+        const int* row = &table.scores[x * cols];
+        for (size_t y = 0; y < cols; y++) table.colMax[y] = max(table.colMax[y], row[y]);
+    }
+    table.max = *max_element(table.rowMax.begin(), table.rowMax.end());
+    return table;
+}
+
+// Levels an outfit is chosen over: top, bottom, shoes and an optional jacket
+static constexpr size_t MAX_LEVELS = 4;
+
+// Everything bestOutfits works out from a wardrobe and rules before it searches
+struct ScorePlan {
+    size_t levelCount = 0;          // at most MAX_LEVELS
+    bool complete = false;          // every level has at least one style
+    bool jacket = false;
+    StyleLevel levels[MAX_LEVELS];
+    PairTable tables[MAX_LEVELS][MAX_LEVELS];   // tables[i][j] for i < j
+    int pendingMax[MAX_LEVELS] = {0, 0, 0, 0};  // sum of tables[j][k].max for levels after i, j < k
+    vector<uint32_t> order[MAX_LEVELS];         // each level's styles, most promising first
+    vector<int> potential[MAX_LEVELS];          // best score a style could add with any partners
+};
+
+/* sortLevel
+ * Orders a level's styles by their potential: their best score against any
+ * earlier style plus their best score against any later one.
+ */
+static void sortLevel(ScorePlan& plan, size_t level) {
+    size_t count = plan.levels[level].styles.size();
+    vector<int>& potential = plan.potential[level];
+    potential.assign(count, 0);
+    for (uint32_t x = 0; x < count; x++) {
+        for (size_t i = 0; i < level; i++) potential[x] += plan.tables[i][level].colMax[x];
+        for (size_t j = level + 1; j < plan.levelCount; j++) potential[x] += plan.tables[level][j].rowMax[x];
+    }
+    vector<uint32_t>& order = plan.order[level];
+    order.resize(count);
+    for (uint32_t x = 0; x < count; x++) order[x] = x;
+    stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) { return potential[a] > potential[b]; });
+}
+
+// Branch-and-bound state of one query over a plan
+struct ScoreSearch {
+    const ScorePlan& plan;
+    size_t k;
+
+    struct Found {
+        int score;
+        size_t order;               // discovery order, to break ties deterministically
+        uint32_t styles[MAX_LEVELS];
+    };
+    vector<Found> heap;             // min-heap on score; heap.front() is the k-th best
+    uint32_t chosen[MAX_LEVELS];
+    size_t foundCount = 0;
+
+    ScoreSearch(const ScorePlan& plan, size_t k) : plan(plan), k(k) {}
+
+    static bool worse(const Found& a, const Found& b) {
+        return a.score != b.score ? a.score > b.score : a.order < b.order;
+    }
+
+    bool full() const { return heap.size() == k; }
+    int threshold() const { return heap.front().score; }
+
+    void offer(int score) {
+        if (full() && score <= threshold()) return;
+        Found found{score, foundCount++, {chosen[0], chosen[1], chosen[2], chosen[3]}};
+        if (full()) {
+            pop_heap(heap.begin(), heap.end(), worse);
+            heap.back() = found;
+        }
+        else heap.push_back(found);
+        push_heap(heap.begin(), heap.end(), worse);
+    }
+
+    //The level is a template argument so every loop and index below has a bound the compiler can see
+    template <size_t Level>
+    void search(int partial) {
+        size_t levelCount = min(plan.levelCount, MAX_LEVELS);
+        size_t count = plan.levels[Level].styles.size();
+        bool last = Level + 1 >= levelCount;
+        const PairTable (*tables)[MAX_LEVELS] = plan.tables;
+
+        //What the later levels can add through earlier choices, whichever style is picked here
+        int fixed = plan.pendingMax[Level];
+        for (size_t i = 0; i < Level; i++) {
+            for (size_t j = Level + 1; j < levelCount; j++) fixed += tables[i][j].rowMax[chosen[i]];
+        }
+
+        for (uint32_t x : plan.order[Level]) {
+            //Styles are sorted by potential, so once one cannot win none of the rest can
+            if (full() && partial + fixed + plan.potential[Level][x] <= threshold()) break;
+
+            int score = partial;
+            for (size_t i = 0; i < Level; i++) score += tables[i][Level].scores[chosen[i] * count + x];
+            chosen[Level] = x;
+            if (last) {
+                offer(score);
+                continue;
+            }
+            if constexpr (Level + 1 < MAX_LEVELS) {
+                int bound = score + fixed;
+                for (size_t j = Level + 1; j < levelCount; j++) bound += tables[Level][j].rowMax[x];
+                if (!full() || bound > threshold()) search<Level + 1>(score);
+            }
+        }
+    }
+};
+
+/* planScoring
+ * Does the part of bestOutfits that depends only on the wardrobe and rules:
+ * finds each category's distinct styles, builds the pair tables and their
+ * bounds, and orders the styles for the search.
+ *
+ * Parameters:
+ *   outfits - wardrobe to choose from; it is not modified.
+ *   rules   - compatibility rules to score with.
+ *   options - whether outfits include a jacket; nothing else is used.
+ *
+ * Returns:
+ *   A read-only plan that any number of bestOutfits calls, on any thread, can
+ *   search. It copies what it needs, so it stays valid after the wardrobe
+ *   changes, but then describes the old contents (see OutfitCache.h).
+ */
+shared_ptr<const ScorePlan> planScoring(const Wardrobe& outfits, const StyleRules& rules, const PickOptions& options) {
+    shared_ptr<ScorePlan> plan = make_shared<ScorePlan>();
+    plan->jacket = options.jacket;
+    plan->levelCount = options.jacket ? 4 : 3;
+    StyleLevel* levels = plan->levels;
+    vector<AttributeId> values[3];
+    for (size_t level = 0; level < plan->levelCount; level++) {
+        unordered_map<uint64_t, uint32_t> seen;
+        for (const auto& item : getType(outfits, LEVEL_TYPES[level])) {
+            uint64_t style = uint64_t(item.material) | uint64_t(item.color) << 16 | uint64_t(item.pattern) << 32;
+            if (!seen.emplace(style, uint32_t(seen.size())).second) continue;
+            levels[level].styles.push_back(item);
+            for (uint8_t kind = RULE_COLOR; kind <= RULE_MATERIAL; kind++) values[kind].push_back(attributeOf(item, kind));
+        }
+        if (levels[level].styles.empty()) return plan;
+    }
+    plan->complete = true;
+
+    AttributeMatrix matrices[3];
+    for (uint8_t kind = RULE_COLOR; kind <= RULE_MATERIAL; kind++) {
+        matrices[kind] = buildMatrix(rules, kind, values[kind]);
+        for (size_t level = 0; level < plan->levelCount; level++) {
+            for (const auto& style : levels[level].styles)
+                levels[level].rows[kind].push_back(matrices[kind].localOf[attributeOf(style, kind)]);
+        }
+    }
+
+    for (size_t i = 0; i < plan->levelCount; i++) {
+        for (size_t j = i + 1; j < plan->levelCount; j++) plan->tables[i][j] = buildPairTable(levels[i], levels[j], matrices);
+    }
+    for (size_t i = 0; i < plan->levelCount; i++) {
+        for (size_t j = i + 1; j < plan->levelCount; j++) {
+            for (size_t l = j + 1; l < plan->levelCount; l++) plan->pendingMax[i] += plan->tables[j][l].max;
+        }
+    }
+    for (size_t level = 0; level < plan->levelCount; level++) {
+        sortLevel(*plan, level);
+        //The matrix rows were only needed to fill the tables
+        for (auto& rows : levels[level].rows) vector<uint32_t>().swap(rows);
+    }
+    return plan;
+}
+
+/* scorePlanBytes
+ * Approximate heap and object size of a plan, for cache accounting.
+ */
+size_t scorePlanBytes(const ScorePlan& plan) {
+    size_t bytes = sizeof(ScorePlan);
+    for (size_t i = 0; i < plan.levelCount; i++) {
+        bytes += plan.levels[i].styles.capacity() * sizeof(ClothingItem);
+        bytes += plan.order[i].capacity() * sizeof(uint32_t) + plan.potential[i].capacity() * sizeof(int);
+        for (size_t j = i + 1; j < plan.levelCount; j++) {
+            const PairTable& table = plan.tables[i][j];
+            bytes += (table.scores.capacity() + table.rowMax.capacity() + table.colMax.capacity()) * sizeof(int);
+        }
+    }
+    return bytes;
+}
+
+/* bestOutfits
+ * Finds the highest-scoring outfits in a plan made by planScoring.
+ *
+ * Parameters:
+ *   plan - styles and tables of the wardrobe and rules to choose with.
+ *   k    - number of outfits to return.
+ *
+ * Returns:
+ *   The same as the bestOutfits overload taking the wardrobe the plan was made from.
+ */
+vector<ScoredOutfit> bestOutfits(const ScorePlan& plan, size_t k) {
+    if (!plan.complete || k == 0) return {};
+    //At most every combination of styles can be found, however large k is
+    size_t combinations = 1;
+    for (size_t i = 0; i < plan.levelCount && combinations < k; i++)
+        combinations = combinations > k / plan.levels[i].styles.size() ? k : combinations * plan.levels[i].styles.size();
+    ScoreSearch search(plan, k);
+    search.heap.reserve(min(k, combinations));
+    search.search<0>(0);
+
+    sort(search.heap.begin(), search.heap.end(), ScoreSearch::worse);
+    const StyleLevel* levels = plan.levels;
+    vector<ScoredOutfit> best;
+    best.reserve(search.heap.size());
+    for (const auto& found : search.heap) {
+        ScoredOutfit scored{};
+        scored.score = found.score;
+        scored.outfit.top = levels[0].styles[found.styles[0]];
+        scored.outfit.bottom = levels[1].styles[found.styles[1]];
+        scored.outfit.shoes = levels[2].styles[found.styles[2]];
+        scored.outfit.hasJacket = plan.jacket;
+        if (plan.jacket) scored.outfit.jacket = levels[3].styles[found.styles[3]];
+        best.push_back(scored);
+    }
+    return best;
+}
+
+/* bestOutfits
+ * Finds the highest-scoring outfits in a wardrobe.
+ *
+ * Parameters:
+ *   outfits - wardrobe to choose from; it is not modified.
+ *   rules   - compatibility rules to score with.
+ *   k       - number of outfits to return.
+ *   options - whether each outfit includes a jacket.
+ *
+ * Returns:
+ *   Up to k outfits, best first, each with its scoreOutfit score. Garments with
+ *   the same material, color and pattern count as one style, so the results
+ *   are k different looks; the first such garment in the wardrobe is used.
+ *   Empty if a needed clothing type has no items.
+ *
+ * Details:
+ *   - Equal scores keep the order in which the search reached them, so the
+ *     same wardrobe and rules always give the same answer.
+ *   - Builds a plan for this one query; callers asking repeatedly about a
+ *     wardrobe that rarely changes can keep plans in an OutfitCache.
+ */
+vector<ScoredOutfit> bestOutfits(const Wardrobe& outfits, const StyleRules& rules, size_t k,
+                                 const PickOptions& options) {
+    if (k == 0) return {};
+    return bestOutfits(*planScoring(outfits, rules, options), k);
+}
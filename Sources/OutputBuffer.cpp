@@ -0,0 +1,76 @@
+/* Nolan Pierce - Output Buffer Implementation
+ *
+ * Overview:
+ *   Chunked output used by printClothing/printWardrobe and command mode.
+ */
+#include "../Headers/OutputBuffer.h"
+#include <cstring>
+
+using namespace std;
+
+/* OutputBuffer
+ * Parameters:
+ *   target   - stream the chunks are written to.
+ *   capacity - size of each chunk in bytes.
+ */
+OutputBuffer::OutputBuffer(FILE* target, size_t capacity) : target(target), buffer(capacity < 64 ? 64 : capacity) {}
+
+OutputBuffer::~OutputBuffer() {
+    flush();
+}
+
+/* append
+ * Adds text to the buffer, writing out full chunks as needed.
+ */
+void OutputBuffer::append(string_view text) {
+    while (!text.empty()) {
+        if (used == buffer.size()) flush();
+        size_t room = min(buffer.size() - used, text.size());
+        memcpy(buffer.data() + used, text.data(), room);
+        used += room;
+        text.remove_prefix(room);
+    }
+}
+
+void OutputBuffer::append(char c) {
+    if (used == buffer.size()) flush();
+    buffer[used++] = c;
+}
+
+/* appendNumber
+ * Adds a number in decimal without going through a stream or a temporary string.
+ */
+void OutputBuffer::appendNumber(uint64_t value) {
+    char digits[20];
+    size_t count = 0;
+    do {
+        digits[sizeof(digits) - ++count] = char('0' + value % 10);
+        value /= 10;
+    } while (value != 0);
+    append(string_view(digits + sizeof(digits) - count, count));
+}
+
+/* flush
+ * Writes everything buffered so far in one call and pushes it through the stream.
+ */
+void OutputBuffer::flush() {
+    if (used > 0) fwrite(buffer.data(), 1, used, target);
+    used = 0;
+    fflush(target);
+}
+
+/* setTarget
+ * Sends later output to another stream, after flushing what is buffered.
+ */
+void OutputBuffer::setTarget(FILE* newTarget) {
+    flush();
+    target = newTarget;
+}
+
+/* standardOutput
+ * Returns the shared buffer for stdout.
+ */
+OutputBuffer& standardOutput() {
+    static OutputBuffer out(stdout, 1 << 16);
+    return out;
+}
@@ -0,0 +1,174 @@
+/* Nolan Pierce - Parallel Parse Implementation
+ *
+ * Overview:
+ *   Parses a large wardrobe CSV on every core. The text is split at line
+ *   boundaries into chunks, each chunk is parsed into its own per-type
+ *   vectors with its own attribute numbering, and the chunks are then stitched
+ *   together in file order.
+ *
+ * Determinism:
+ *   Chunks number attributes in the order they first appear in the chunk, and
+ *   the merge interns each chunk's names in chunk order. That is exactly the
+ *   order a single-threaded parse meets them in, so the items, their order and
+ *   the AttributeIds all match parseDatabase, whatever the number of threads.
+ */
+#include "../Headers/ParallelParse.h"
+#include "../Headers/MappedFile.h"
+#include "../Headers/Snapshot.h"
+#include "../Headers/Stats.h"
+#include <algorithm>
+#include <unordered_map>
+
+using namespace std;
+
+// One chunk's items, with IDs into the chunk's own names list
+struct ParsedChunk {
+    string_view text;
+    vector<ClothingItem> items[4];
+    vector<string_view> names;      // chunk attribute ID -> text, first seen first
+    vector<AttributeId> remap;      // chunk attribute ID -> process AttributeId, filled by the merge
+};
+
+/* parseChunk
+ * Parses the lines of one chunk without touching the shared attribute dictionary.
+ */
+static void parseChunk(ParsedChunk& chunk) {
+    unordered_map<string_view, AttributeId> numbering;
+    auto number = [&](string_view name) {
+        auto [entry, added] = numbering.try_emplace(name, AttributeId(chunk.names.size()));
+        if (added) chunk.names.push_back(name);
+        return entry->second;
+    };
+
+    string_view text = chunk.text;
+    ClothingItem item;
+    string_view attributes[3];
+    while (!text.empty()) {
+        size_t end = text.find('\n');
+        string_view line = text.substr(0, end);
+        text.remove_prefix(end == string_view::npos ? text.size() : end + 1);
+
+        if (!splitClothingLine(line, item, attributes)) continue;
+        item.material = number(attributes[0]);
+        item.color = number(attributes[1]);
+        item.pattern = number(attributes[2]);
+        chunk.items[item.type].push_back(item);
+    }
+}
+
+/* indexTypes
+ * Builds the same index as rebuildIndex, one task per clothing type.
+ *
+ * Details:
+ *   - clothingKey includes the type, so each type's keys are its own; every
+ *     task fills a map of its own and the maps are spliced together by moving
+ *     their nodes, without copying any positions.
+ */
+static void indexTypes(Wardrobe& outfits, ThreadPool& pool) {
+    outfits.index = WardrobeIndex();
+    unordered_map<uint64_t, vector<uint32_t>> typed[4];
+    for (uint8_t type = JACKET; type <= SHOES; type++) {
+        pool.submit([&, type] {
+            const vector<ClothingItem>& items = getType(outfits, type);
+            vector<uint32_t>& slots = outfits.index.slots[type];
+            slots.reserve(items.size());
+            for (size_t pos = 0; pos < items.size(); pos++) {
+                vector<uint32_t>& positions = typed[type][clothingKey(items[pos])];
+                slots.push_back(positions.size());
+                positions.push_back(pos);
+            }
+        });
+    }
+    pool.wait();
+    for (auto& positions : typed) outfits.index.positions.merge(positions);
+    stampVersion(outfits);
+}
+
+/* parseDatabase
+ * Parses CSV wardrobe data that is already in memory, using every thread of a pool.
+ *
+ * Parameters:
+ *   contents - full text of a wardrobe CSV file.
+ *   pool     - threads to parse on; the calling thread helps.
+ *
+ * Returns:
+ *   The same Wardrobe parseDatabase(contents) returns.
+ *
+ * Details:
+ *   - A few chunks per thread, of at least PARSE_CHUNK_MIN_BYTES, leave room for
+ *     stealing when some chunks parse slower; text too small for two chunks, or
+ *     a pool of one thread, is parsed on the calling thread.
+ *   - Items are written once more, into their final place, with their IDs
+ *     translated; attribute text is never copied except into the dictionary.
+ *   - The index is built per type in parallel too (see indexTypes).
+ */
+Wardrobe parseDatabase(string_view contents, ThreadPool& pool) {
+    size_t chunkCount = min(pool.size() * 4, contents.size() / PARSE_CHUNK_MIN_BYTES);
+    if (chunkCount < 2 || pool.size() < 2) return parseDatabase(contents);
+
+    //Cut near equal sizes, each cut moved forward to the start of a line
+    vector<ParsedChunk> chunks(chunkCount);
+    size_t begin = 0;
+    for (size_t c = 0; c < chunkCount; c++) {
+        size_t end = contents.size();
+        if (c + 1 < chunkCount) {
+            size_t newline = contents.find('\n', max(begin, contents.size() / chunkCount * (c + 1)));
+            end = newline == string_view::npos ? contents.size() : newline + 1;
+        }
+        chunks[c].text = contents.substr(begin, end - begin);
+        begin = end;
+    }
+    for (auto& chunk : chunks) pool.submit([&chunk] { parseChunk(chunk); });
+    pool.wait();
+
+    //Number attributes in file order, then place every chunk's items after the chunks before it
+    Wardrobe clothingDatabase;
+    vector<size_t> offsets(chunkCount * 4);
+    for (uint8_t type = JACKET; type <= SHOES; type++) {
+        size_t total = 0;
+        for (size_t c = 0; c < chunkCount; c++) {
+            offsets[c * 4 + type] = total;
+            total += chunks[c].items[type].size();
+        }
+        getType(clothingDatabase, type).resize(total);
+    }
+    for (auto& chunk : chunks) {
+        chunk.remap.reserve(chunk.names.size());
+        for (string_view name : chunk.names) chunk.remap.push_back(internAttribute(name));
+    }
+    for (size_t c = 0; c < chunkCount; c++) {
+        pool.submit([&, c] {
+            ParsedChunk& chunk = chunks[c];
+            for (uint8_t type = JACKET; type <= SHOES; type++) {
+                ClothingItem* out = getType(clothingDatabase, type).data() + offsets[c * 4 + type];
+                for (ClothingItem item : chunk.items[type]) {
+                    item.material = chunk.remap[item.material];
+                    item.color = chunk.remap[item.color];
+                    item.pattern = chunk.remap[item.pattern];
+                    *out++ = item;
+                }
+                vector<ClothingItem>().swap(chunk.items[type]);
+            }
+        });
+    }
+    pool.wait();
+
+    indexTypes(clothingDatabase, pool);
+    STAT_ADD(STAT_ITEMS_PARSED, wardrobeSize(clothingDatabase));
+    return clothingDatabase;
+}
+
+/* loadDatabase
+ * Loads wardrobe data from a file like loadDatabase(filename), parsing CSV
+ * files on every thread of a pool.
+ */
+Wardrobe loadDatabase(const string& filename, ThreadPool& pool) {
+    STAT_SCOPE(TIMER_LOAD);
+    MappedFile file(filename);
+    if (isSnapshot(file.view())) {
+        SnapshotView snapshot;
+        if (!snapshot.open(move(file))) throw runtime_error("Damaged or unsupported wardrobe snapshot: " + filename);
+        return snapshot.toWardrobe();
+    }
+    return parseDatabase(file.view(), pool);
+}
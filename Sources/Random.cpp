@@ -0,0 +1,57 @@
+/* Nolan Pierce - Random Implementation
+ *
+ * Overview:
+ *   Owns the per-thread generators the outfit picker draws from. Each thread
+ *   starts from a fresh random seed so runs differ, and remembers that seed so
+ *   any run can be reproduced with seedPicker.
+ */
+#include "../Headers/Random.h"
+#include <chrono>
+#include <random>
+
+using namespace std;
+
+/* freshSeed
+ * Mixes OS entropy with the clock, in case random_device is deterministic on this platform.
+ */
+static uint64_t freshSeed() {
+    random_device device;
+    uint64_t seed = (uint64_t(device()) << 32) ^ device();
+    return seed ^ uint64_t(chrono::steady_clock::now().time_since_epoch().count());
+}
+
+struct PickerState {
+    uint64_t seed = freshSeed();
+    Xoshiro256 rng{seed};
+};
+
+static PickerState& pickerState() {
+    thread_local PickerState state;
+    return state;
+}
+
+/* pickerRng
+ * Returns this thread's outfit picker generator.
+ */
+Xoshiro256& pickerRng() {
+    return pickerState().rng;
+}
+
+/* seedPicker
+ * Restarts this thread's generator from a known seed.
+ *
+ * Parameters:
+ *   seed - any value; the same seed gives the same sequence of picks.
+ */
+void seedPicker(uint64_t seed) {
+    PickerState& state = pickerState();
+    state.seed = seed;
+    state.rng.reseed(seed);
+}
+
+/* pickerSeed
+ * Returns the seed this thread's generator last started from.
+ */
+uint64_t pickerSeed() {
+    return pickerState().seed;
+}
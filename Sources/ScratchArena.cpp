@@ -0,0 +1,56 @@
+/* Nolan Pierce - Scratch Arena Implementation
+ *
+ * Overview:
+ *   Per-operation monotonic arenas over one reusable block per thread, so the
+ *   temporary containers of picks and laundry cost no heap allocations once
+ *   the block has grown to fit them.
+ */
+#include "../Headers/ScratchArena.h"
+#include <new>
+
+using namespace std;
+
+// Size of a thread's block before any operation has needed more
+static const size_t INITIAL_BLOCK_BYTES = 4096;
+
+/* threadBlock
+ * Returns this thread's scratch block, allocating it on first use.
+ */
+ScratchArena::Block& ScratchArena::threadBlock() {
+    thread_local Block block;
+    if (block.bytes.empty()) block.bytes.resize(INITIAL_BLOCK_BYTES);
+    return block;
+}
+
+ScratchArena::ScratchArena()
+    : block(threadBlock().open ? nullptr : &threadBlock()),
+      arena(block ? block->bytes.data() : nullptr, block ? block->bytes.size() : 0, &overflow) {
+    if (block) block->open = true;
+}
+
+/* ~ScratchArena
+ * Releases everything allocated from the arena and, if the block was too
+ * small this time, grows it to fit next time.
+ */
+ScratchArena::~ScratchArena() {
+    arena.release();
+    if (!block) return;
+    if (overflow.requested > 0) {
+        vector<byte> grown(block->bytes.size() + overflow.requested);
+        block->bytes.swap(grown);
+    }
+    block->open = false;
+}
+
+void* ScratchArena::Overflow::do_allocate(size_t bytes, size_t alignment) {
+    requested += bytes;
+    return ::operator new(bytes, align_val_t(alignment));
+}
+
+void ScratchArena::Overflow::do_deallocate(void* pointer, size_t bytes, size_t alignment) {
+    ::operator delete(pointer, bytes, align_val_t(alignment));
+}
+
+bool ScratchArena::Overflow::do_is_equal(const pmr::memory_resource& other) const noexcept {
+    return this == &other;
+}
@@ -0,0 +1,269 @@
+/* Nolan Pierce - Binary Snapshot Implementation
+ *
+ * Overview:
+ *   Compact binary wardrobe format that can be memory-mapped and used without
+ *   a parse step. Item records are written straight out of the Wardrobe vectors
+ *   and read straight back, so loading is bounded by memory bandwidth instead
+ *   of text parsing.
+ */
+#include "../Headers/Snapshot.h"
+#include "../Headers/Stats.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <iterator>
+#include <limits>
+
+using namespace std;
+
+static_assert(sizeof(ClothingItem) == 16, "ClothingItem layout changed; bump SNAPSHOT_VERSION");
+static_assert(offsetof(ClothingItem, wearCount) == RECORD_SIZE_V1, "version 1 records must stay a prefix of ClothingItem");
+
+static const char snapshotMagic[8] = {'O', 'U', 'T', 'F', 'I', 'T', 'P', 'K'};
+
+// Marks a process attribute ID the wardrobe being written does not use
+static const AttributeId UNUSED_ID = numeric_limits<AttributeId>::max();
+
+static uint64_t alignTo8(uint64_t offset) {
+    return (offset + 7) & ~uint64_t(7);
+}
+
+/* isSnapshot
+ * Checks whether file contents start with the binary snapshot magic.
+ */
+bool isSnapshot(string_view contents) {
+    return contents.size() >= sizeof(snapshotMagic) && memcmp(contents.data(), snapshotMagic, sizeof(snapshotMagic)) == 0;
+}
+
+/* isSnapshotPath
+ * Says whether a file name asks for the binary format (a ".bin" extension).
+ */
+bool isSnapshotPath(const string& filename) {
+    return filename.size() >= 4 && filename.compare(filename.size() - 4, 4, ".bin") == 0;
+}
+
+/* writeSnapshot
+ * Saves a wardrobe in the binary snapshot format.
+ *
+ * Parameters:
+ *   src      - wardrobe to save.
+ *   filename - path of the snapshot file.
+ *
+ * Returns:
+ *   true if the whole snapshot was written.
+ *
+ * Details:
+ *   - The dictionary holds only the attributes the wardrobe uses, numbered in
+ *     the order of their process IDs, so other wardrobes' values (e.g. other
+ *     users of the service) stay out of the file.
+ *   - When those are exactly the first IDs of the process, as in a program with
+ *     one wardrobe pair, records are written as-is; otherwise they are
+ *     renumbered in a small buffer on the way out.
+ */
+bool writeSnapshot(const Wardrobe& src, const string& filename) {
+    FILE* file = fopen(filename.c_str(), "wb");
+    if (file == nullptr) {
+        cerr << "Error: Could not open file for writing.";
+        return false;
+    }
+
+    //Number the attributes in use densely, keeping their order
+    vector<string_view> names = attributeTable();
+    vector<AttributeId> fileIds(names.size(), UNUSED_ID);
+    for (uint8_t type = JACKET; type <= SHOES; type++) {
+        for (const ClothingItem& item : getType(src, type)) {
+            fileIds[item.material] = fileIds[item.color] = fileIds[item.pattern] = 0;
+        }
+    }
+    vector<string_view> used;
+    for (size_t id = 0; id < names.size(); id++) {
+        if (fileIds[id] == UNUSED_ID) continue;
+        fileIds[id] = AttributeId(used.size());
+        used.push_back(names[id]);
+    }
+    bool identity = used.empty() || fileIds[used.size() - 1] == used.size() - 1;
+
+    SnapshotHeader header{};
+    memcpy(header.magic, snapshotMagic, sizeof(snapshotMagic));
+    header.version = SNAPSHOT_VERSION;
+    header.byteOrder = 0x01020304;
+    header.recordSize = sizeof(ClothingItem);
+    header.dictionaryCount = used.size();
+    header.dictionaryOffset = sizeof(SnapshotHeader);
+
+    uint64_t dictionaryBytes = 0;
+    for (string_view name : used) dictionaryBytes += sizeof(uint32_t) + name.size();
+    header.itemsOffset = alignTo8(header.dictionaryOffset + dictionaryBytes);
+    uint64_t itemCount = 0;
+    for (uint8_t type = JACKET; type <= SHOES; type++) {
+        header.counts[type] = getType(src, type).size();
+        itemCount += header.counts[type];
+    }
+    header.fileSize = header.itemsOffset + itemCount * sizeof(ClothingItem);
+
+    bool ok = fwrite(&header, sizeof(header), 1, file) == 1;
+    for (string_view name : used) {
+        uint32_t length = name.size();
+        ok = ok && fwrite(&length, sizeof(length), 1, file) == 1;
+        ok = ok && fwrite(name.data(), 1, name.size(), file) == name.size();
+    }
+    static const char padding[8] = {};
+    uint64_t padBytes = header.itemsOffset - header.dictionaryOffset - dictionaryBytes;
+    ok = ok && fwrite(padding, 1, padBytes, file) == padBytes;
+    ClothingItem renumbered[1024];
+    for (uint8_t type = JACKET; type <= SHOES; type++) {
+        const vector<ClothingItem>& items = getType(src, type);
+        if (identity) {
+            ok = ok && fwrite(items.data(), sizeof(ClothingItem), items.size(), file) == items.size();
+            continue;
+        }
+        for (size_t start = 0; ok && start < items.size(); start += size(renumbered)) {
+            size_t batch = min(size(renumbered), items.size() - start);
+            for (size_t i = 0; i < batch; i++) {
+                renumbered[i] = items[start + i];
+                renumbered[i].material = fileIds[renumbered[i].material];
+                renumbered[i].color = fileIds[renumbered[i].color];
+                renumbered[i].pattern = fileIds[renumbered[i].pattern];
+            }
+            ok = fwrite(renumbered, sizeof(ClothingItem), batch, file) == batch;
+        }
+    }
+    ok = fclose(file) == 0 && ok;
+    if (ok) STAT_ADD(STAT_BYTES_WRITTEN, header.fileSize);
+    return ok;
+}
+
+/* validRecords
+ * Checks every record of a snapshot whose layout was already checked.
+ *
+ * Returns:
+ *   false unless each record's type is the section it is in, isLong is 0 or
+ *   1, and its attribute IDs are in the file's dictionary.
+ */
+static bool validRecords(string_view contents, const SnapshotHeader& header) {
+    const char* record = contents.data() + header.itemsOffset;
+    for (uint8_t type = JACKET; type <= SHOES; type++) {
+        for (uint64_t i = 0; i < header.counts[type]; i++, record += header.recordSize) {
+            AttributeId ids[3];
+            uint8_t recordType;
+            uint8_t isLong;
+            memcpy(ids, record + offsetof(ClothingItem, material), sizeof(ids));
+            memcpy(&recordType, record + offsetof(ClothingItem, type), 1);
+            memcpy(&isLong, record + offsetof(ClothingItem, isLong), 1);
+            if (recordType != type || isLong > 1) return false;
+            for (AttributeId id : ids) {
+                if (id >= header.dictionaryCount) return false;
+            }
+        }
+    }
+    return true;
+}
+
+/* open
+ * Maps a snapshot file and validates it.
+ *
+ * Returns:
+ *   false if the file is missing, from another version or byte order, or damaged.
+ */
+bool SnapshotView::open(const string& filename) {
+    return open(MappedFile(filename));
+}
+
+bool SnapshotView::open(MappedFile mapped) {
+    file = move(mapped);
+    header = nullptr;
+    remap.clear();
+    identity = true;
+
+    string_view contents = file.view();
+    if (!isSnapshot(contents) || contents.size() < sizeof(SnapshotHeader)) return false;
+    const SnapshotHeader* candidate = reinterpret_cast<const SnapshotHeader*>(contents.data());
+    bool current = candidate->version == SNAPSHOT_VERSION && candidate->recordSize == sizeof(ClothingItem);
+    bool v1 = candidate->version == SNAPSHOT_VERSION_V1 && candidate->recordSize == RECORD_SIZE_V1;
+    if (!(current || v1) || candidate->byteOrder != 0x01020304 || candidate->fileSize != contents.size()) return false;
+
+    //Every section inside the file, and the counts filling the items section exactly; divisions avoid overflow
+    if (candidate->dictionaryOffset < sizeof(SnapshotHeader) || candidate->dictionaryOffset > candidate->itemsOffset ||
+        candidate->itemsOffset > contents.size())
+        return false;
+    uint64_t itemBytes = contents.size() - candidate->itemsOffset;
+    if (itemBytes % candidate->recordSize != 0) return false;
+    uint64_t unclaimed = itemBytes / candidate->recordSize;
+    for (uint64_t count : candidate->counts) {
+        if (count > unclaimed) return false;
+        unclaimed -= count;
+    }
+    if (unclaimed != 0) return false;
+    if (candidate->dictionaryCount > (candidate->itemsOffset - candidate->dictionaryOffset) / sizeof(uint32_t) ||
+        candidate->dictionaryCount > numeric_limits<AttributeId>::max())
+        return false;
+    if (!validRecords(contents, *candidate)) return false;
+
+    //Intern the dictionary, noting whether file IDs already match this process's IDs
+    size_t offset = candidate->dictionaryOffset;
+    remap.reserve(candidate->dictionaryCount);
+    for (uint64_t id = 0; id < candidate->dictionaryCount; id++) {
+        uint32_t length;
+        if (offset + sizeof(length) > candidate->itemsOffset) return false;
+        memcpy(&length, contents.data() + offset, sizeof(length));
+        offset += sizeof(length);
+        if (offset + length > candidate->itemsOffset) return false;
+        remap.push_back(internAttribute(contents.substr(offset, length)));
+        identity = identity && remap.back() == id;
+        offset += length;
+    }
+    header = candidate;
+    return true;
+}
+
+/* items
+ * Returns the raw records of one clothing type, straight from the mapping.
+ */
+const ClothingItem* SnapshotView::items(uint8_t type) const {
+    if (!isCurrent()) return nullptr;
+    uint64_t skip = 0;
+    for (uint8_t before = JACKET; before < type; before++) skip += header->counts[before];
+    return reinterpret_cast<const ClothingItem*>(file.data() + header->itemsOffset) + skip;
+}
+
+/* item
+ * Returns one record with its attribute IDs translated to this process's IDs.
+ */
+ClothingItem SnapshotView::item(uint8_t type, size_t i) const {
+    ClothingItem result;
+    if (isCurrent()) result = items(type)[i];
+    else {
+        //Version 1 records hold the leading fields only; the history keeps its never-worn defaults
+        uint64_t skip = i;
+        for (uint8_t before = JACKET; before < type; before++) skip += header->counts[before];
+        memcpy(static_cast<void*>(&result), file.data() + header->itemsOffset + skip * RECORD_SIZE_V1, RECORD_SIZE_V1);
+    }
+    if (!identity) {
+        result.material = remap[result.material];
+        result.color = remap[result.color];
+        result.pattern = remap[result.pattern];
+    }
+    return result;
+}
+
+/* toWardrobe
+ * Copies the snapshot into an editable Wardrobe.
+ *
+ * Details:
+ *   - The items are copied as one block each, but the positions index is
+ *     left for keyIndex to build on the first lookup by item, so loading
+ *     costs no hashing; picks and adds never need it.
+ */
+Wardrobe SnapshotView::toWardrobe() const {
+    Wardrobe outfits;
+    for (uint8_t type = JACKET; type <= SHOES; type++) {
+        vector<ClothingItem>& dest = getType(outfits, type);
+        const ClothingItem* src = items(type);
+        if (identity && src) dest.assign(src, src + count(type));
+        else for (size_t i = 0; i < count(type); i++) dest.push_back(item(type, i));
+    }
+    outfits.index.keyed = false;
+    stampVersion(outfits);
+    return outfits;
+}
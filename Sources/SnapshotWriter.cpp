@@ -0,0 +1,177 @@
+/* Nolan Pierce - Snapshot Writer Implementation
+ *
+ * Overview:
+ *   Moves the slow part of saving a wardrobe, formatting both snapshots and
+ *   waiting for fsync, off the thread that picks outfits and does laundry.
+ *   save() copies the item vectors into a spare buffer and returns; a
+ *   background thread writes and syncs the newest copy, then calls the
+ *   owner's commit to switch the pair in.
+ *
+ * Details:
+ *   - The lock is only held to copy items in and to hand buffers over, never
+ *     during file I/O, so save() waits at most for another copy.
+ *   - A crash while writing leaves only ".new" files behind; the snapshots
+ *     themselves are only replaced by commit, which must make the two renames
+ *     recoverable as one step (Journal does so with a marker file).
+ */
+#include "../Headers/SnapshotWriter.h"
+#include "../Headers/DurableFile.h"
+#include <filesystem>
+#include <system_error>
+
+using namespace std;
+
+/* newSnapshotPath
+ * Names the temporary file a snapshot is written to before it is switched in.
+ *
+ * Details:
+ *   - "outfits.csv" becomes "outfits.new.csv", keeping the extension that
+ *     pushDatabase uses to pick the format.
+ */
+string newSnapshotPath(const string& path) {
+    filesystem::path newPath(path);
+    newPath.replace_extension(".new" + newPath.extension().string());
+    return newPath.string();
+}
+
+/* SnapshotWriter
+ * Sets up a writer for a pair of wardrobe snapshots; no thread is started yet.
+ *
+ * Parameters:
+ *   outfitsPath - snapshot of clean clothes, CSV or binary (".bin").
+ *   dirtyPath   - snapshot of dirty clothes.
+ *   commit      - switches the written ".new" files in, on the writer thread.
+ */
+SnapshotWriter::SnapshotWriter(const string& outfitsPath, const string& dirtyPath, Commit commit)
+    : outfitsPath(outfitsPath), dirtyPath(dirtyPath), commit(move(commit)) {}
+
+SnapshotWriter::~SnapshotWriter() {
+    unique_lock<mutex> guard(lock);
+    finished.wait(guard, [&] { return !running; });
+    guard.unlock();
+    if (worker.joinable()) worker.join();
+}
+
+/* save
+ * Queues a copy of the wardrobes to be written in the background.
+ *
+ * Parameters:
+ *   outfits - current clean clothes.
+ *   dirty   - current dirty clothes.
+ *
+ * Returns:
+ *   Ticket for wait(); tickets increase with every save.
+ *
+ * Details:
+ *   - Costs one copy of the items. If an earlier save has not started writing
+ *     yet, this one takes its place and both tickets complete together.
+ */
+uint64_t SnapshotWriter::save(const Wardrobe& outfits, const Wardrobe& dirty) {
+    thread finishedWorker;
+    uint64_t ticket;
+    {
+        lock_guard<mutex> guard(lock);
+        counts.saves++;
+        if (waiting >= 0) counts.coalesced++;
+        else waiting = writing == 0 ? 1 : 0;
+        Buffer& buffer = buffers[waiting];
+        for (uint8_t type = JACKET; type <= SHOES; type++) {
+            getType(buffer.outfits, type).assign(getType(outfits, type).begin(), getType(outfits, type).end());
+            getType(buffer.dirty, type).assign(getType(dirty, type).begin(), getType(dirty, type).end());
+        }
+        ticket = waitingTicket = ++lastTicket;
+        if (!running) {
+            running = true;
+            finishedWorker = move(worker);
+            worker = thread(&SnapshotWriter::run, this);
+        }
+    }
+    //The previous thread already left run(), so this returns at once
+    if (finishedWorker.joinable()) finishedWorker.join();
+    return ticket;
+}
+
+/* wait
+ * Durability barrier: blocks until a save is written or has failed.
+ *
+ * Parameters:
+ *   ticket - value returned by save().
+ *
+ * Returns:
+ *   true if that save, or a later one that replaced it, is on disk.
+ */
+bool SnapshotWriter::wait(uint64_t ticket) {
+    unique_lock<mutex> guard(lock);
+    finished.wait(guard, [&] { return finishedTicket >= ticket; });
+    return durableTicket >= ticket;
+}
+
+/* flush
+ * Waits for every save made so far.
+ *
+ * Returns:
+ *   true if the latest save is on disk, or nothing was ever saved.
+ */
+bool SnapshotWriter::flush() {
+    uint64_t ticket;
+    {
+        lock_guard<mutex> guard(lock);
+        ticket = lastTicket;
+    }
+    return wait(ticket);
+}
+
+/* busy
+ * Says whether a save is waiting or being written.
+ */
+bool SnapshotWriter::busy() const {
+    lock_guard<mutex> guard(lock);
+    return waiting >= 0 || writing >= 0;
+}
+
+SnapshotWriterStats SnapshotWriter::stats() const {
+    lock_guard<mutex> guard(lock);
+    return counts;
+}
+
+/* run
+ * Writer thread: writes waiting buffers until there are none, then exits.
+ */
+void SnapshotWriter::run() {
+    unique_lock<mutex> guard(lock);
+    while (waiting >= 0) {
+        int set = writing = waiting;
+        waiting = -1;
+        uint64_t ticket = waitingTicket;
+        guard.unlock();
+        bool durable = write(buffers[set]);
+        guard.lock();
+        writing = -1;
+        counts.writes++;
+        if (!durable) counts.failures++;
+        finishedTicket = ticket;
+        if (durable) durableTicket = ticket;
+        finished.notify_all();
+    }
+    running = false;
+    finished.notify_all();
+}
+
+/* write
+ * Writes one buffer to the ".new" files, syncs them and commits them.
+ *
+ * Returns:
+ *   true if the save is durable; failed ".new" files are removed.
+ */
+bool SnapshotWriter::write(const Buffer& buffer) {
+    string outfitsNew = newSnapshotPath(outfitsPath);
+    string dirtyNew = newSnapshotPath(dirtyPath);
+    bool written = pushDatabase(buffer.outfits, outfitsNew) && pushDatabase(buffer.dirty, dirtyNew) &&
+                   syncFile(outfitsNew) && syncFile(dirtyNew);
+    if (!written) {
+        error_code error;
+        filesystem::remove(outfitsNew, error);
+        filesystem::remove(dirtyNew, error);
+    }
+    return commit(written);
+}
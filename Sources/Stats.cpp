@@ -0,0 +1,182 @@
+/* Nolan Pierce - Stats Implementation
+ *
+ * Overview:
+ *   Per-thread counter blocks for the STAT_ADD/STAT_SCOPE instrumentation,
+ *   countAllocation for the operator new of AllocationCounter.cpp, and the
+ *   --stats report.
+ *
+ * Threads:
+ *   Every thread counts into its own StatBlock, so counting never contends.
+ *   Blocks of running threads are listed in a registry; a block is added into
+ *   the retired totals when its thread exits, so reports include finished
+ *   worker threads too.
+ */
+#include "../Headers/Stats.h"
+#include <mutex>
+#include <vector>
+
+using namespace std;
+
+static const char* COUNTER_NAMES[] = {"items parsed", "bytes read", "bytes written", "picks", "comparisons",
+                                      "allocations", "cache hits", "cache misses"};
+static const char* COUNTER_KEYS[] = {"itemsParsed", "bytesRead", "bytesWritten", "picks", "comparisons",
+                                     "allocations", "cacheHits", "cacheMisses"};
+static const char* TIMER_NAMES[] = {"load", "laundry", "pick", "save"};
+
+static mutex registryLock;
+static StatBlock retiredStats;
+// Allocations made while a thread's block is being registered, or after it was retired
+static atomic<uint64_t> strayAllocations{0};
+static thread_local bool threadRetired = false;
+
+// Never freed, so threads that exit during shutdown can still unregister
+static vector<StatBlock*>& liveStats() {
+    static vector<StatBlock*>* live = new vector<StatBlock*>;
+    return *live;
+}
+
+/* addBlock
+ * Adds every count of one block into another.
+ */
+static void addBlock(StatBlock& into, const StatBlock& from) {
+    for (size_t c = 0; c < STAT_COUNTER_COUNT; c++) into.counters[c] += from.counters[c].load(memory_order_relaxed);
+    for (size_t t = 0; t < STAT_TIMER_COUNT; t++) {
+        into.calls[t] += from.calls[t].load(memory_order_relaxed);
+        into.timedCalls[t] += from.timedCalls[t].load(memory_order_relaxed);
+        into.nanoseconds[t] += from.nanoseconds[t].load(memory_order_relaxed);
+    }
+}
+
+// A thread's block, registered while the thread runs
+struct ThreadStats {
+    StatBlock block;
+
+    ThreadStats() {
+        lock_guard<mutex> holding(registryLock);
+        liveStats().push_back(&block);
+    }
+    ~ThreadStats() {
+        threadRetired = true;
+        lock_guard<mutex> holding(registryLock);
+        addBlock(retiredStats, block);
+        vector<StatBlock*>& live = liveStats();
+        for (size_t i = 0; i < live.size(); i++) {
+            if (live[i] == &block) {
+                live[i] = live.back();
+                live.pop_back();
+                break;
+            }
+        }
+    }
+};
+
+/* threadStats
+ * Returns the calling thread's block.
+ */
+StatBlock& threadStats() {
+    thread_local ThreadStats stats;
+    return stats.block;
+}
+
+/* countAllocation
+ * Counts one call to operator new in the calling thread's block.
+ *
+ * Details:
+ *   - Registering a thread's block allocates itself; those allocations, and
+ *     any made by the thread after its block was retired, go to a shared
+ *     counter instead, which steady-state allocations never touch.
+ */
+void countAllocation() {
+    thread_local StatBlock* block = nullptr;
+    thread_local bool registering = false;
+    if (block == nullptr || threadRetired) {
+        if (registering || threadRetired) {
+            strayAllocations.fetch_add(1, memory_order_relaxed);
+            return;
+        }
+        registering = true;
+        block = &threadStats();
+        registering = false;
+    }
+    bumpStat(block->counters[STAT_ALLOCATIONS], 1);
+}
+
+/* totals
+ * Sums the retired counts and every running thread's block.
+ */
+static void totals(StatBlock& sum) {
+    lock_guard<mutex> holding(registryLock);
+    addBlock(sum, retiredStats);
+    for (const StatBlock* block : liveStats()) addBlock(sum, *block);
+}
+
+/* statTotal
+ * Returns a counter summed over all threads.
+ */
+uint64_t statTotal(StatCounter counter) {
+    StatBlock sum;
+    totals(sum);
+    if (counter == STAT_ALLOCATIONS) return sum.counters[counter] + strayAllocations.load(memory_order_relaxed);
+    return sum.counters[counter];
+}
+
+/* timerTotal
+ * Returns a timer's calls and time summed over all threads.
+ *
+ * Details:
+ *   - Calls past the exactly timed ones are sampled; the untimed calls are
+ *     assumed to take as long as the timed calls of the same thread did on
+ *     average.
+ */
+TimerTotals timerTotal(StatTimer timer) {
+    TimerTotals total;
+    lock_guard<mutex> holding(registryLock);
+    auto add = [&](const StatBlock& block) {
+        uint64_t calls = block.calls[timer].load(memory_order_relaxed);
+        uint64_t timed = block.timedCalls[timer].load(memory_order_relaxed);
+        total.calls += calls;
+        if (timed > 0) total.seconds += block.nanoseconds[timer].load(memory_order_relaxed) * 1e-9 * calls / timed;
+    };
+    add(retiredStats);
+    for (const StatBlock* block : liveStats()) add(*block);
+    return total;
+}
+
+/* writeStats
+ * Prints every timer and counter.
+ *
+ * Parameters:
+ *   out  - stream to write to, e.g. stderr so command output stays clean.
+ *   json - one JSON object instead of the readable table.
+ */
+void writeStats(FILE* out, bool json) {
+#ifndef OUTFIT_STATS
+    if (json) fprintf(out, "{\"enabled\":false}\n");
+    else fprintf(out, "Stats were compiled out (OUTFIT_NO_STATS).\n");
+    return;
+#endif
+    TimerTotals timers[STAT_TIMER_COUNT];
+    for (uint8_t t = 0; t < STAT_TIMER_COUNT; t++) timers[t] = timerTotal(StatTimer(t));
+    uint64_t counters[STAT_COUNTER_COUNT];
+    for (uint8_t c = 0; c < STAT_COUNTER_COUNT; c++) counters[c] = statTotal(StatCounter(c));
+
+    if (json) {
+        fprintf(out, "{\"enabled\":true,\"timers\":{");
+        for (uint8_t t = 0; t < STAT_TIMER_COUNT; t++) {
+            fprintf(out, "%s\"%s\":{\"calls\":%llu,\"seconds\":%.9f}", t ? "," : "", TIMER_NAMES[t],
+                    (unsigned long long)timers[t].calls, timers[t].seconds);
+        }
+        fprintf(out, "},\"counters\":{");
+        for (uint8_t c = 0; c < STAT_COUNTER_COUNT; c++)
+            fprintf(out, "%s\"%s\":%llu", c ? "," : "", COUNTER_KEYS[c], (unsigned long long)counters[c]);
+        fprintf(out, "}}\n");
+        return;
+    }
+    fprintf(out, "Stats:\n");
+    for (uint8_t t = 0; t < STAT_TIMER_COUNT; t++) {
+        fprintf(out, "  %-14s %10llu calls %12.3f ms\n", TIMER_NAMES[t], (unsigned long long)timers[t].calls,
+                timers[t].seconds * 1e3);
+    }
+    for (uint8_t c = 0; c < STAT_COUNTER_COUNT; c++)
+        fprintf(out, "  %-14s %16llu\n", COUNTER_NAMES[c], (unsigned long long)counters[c]);
+}
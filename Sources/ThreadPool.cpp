@@ -0,0 +1,136 @@
+/* Nolan Pierce - Thread Pool Implementation
+ *
+ * Overview:
+ *   Work-stealing pool used to spread independent wardrobe jobs across cores.
+ */
+#include "../Headers/ThreadPool.h"
+#include <algorithm>
+#include <chrono>
+
+using namespace std;
+
+//Which pool and deque the current thread works for, so nested submits stay local
+static thread_local ThreadPool* currentPool = nullptr;
+static thread_local size_t currentQueue = 0;
+
+/* ThreadPool
+ * Starts the worker threads.
+ *
+ * Parameters:
+ *   threadCount - number of workers; 0 uses hardware_concurrency.
+ */
+ThreadPool::ThreadPool(size_t threadCount) {
+    if (threadCount == 0) threadCount = max(1u, thread::hardware_concurrency());
+    for (size_t i = 0; i < threadCount; i++) queues.push_back(make_unique<TaskQueue>());
+    for (size_t i = 0; i < threadCount; i++) workers.emplace_back(&ThreadPool::workerLoop, this, i);
+}
+
+/* ~ThreadPool
+ * Finishes any queued tasks, then stops and joins the workers.
+ */
+ThreadPool::~ThreadPool() {
+    {
+        lock_guard<mutex> guard(sleepLock);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (auto& worker : workers) worker.join();
+}
+
+/* submit
+ * Queues a task to run on one of the workers.
+ *
+ * Parameters:
+ *   task - function to run; must not block waiting on other tasks of this pool.
+ */
+void ThreadPool::submit(function<void()> task) {
+    size_t target = currentPool == this ? currentQueue : nextQueue++ % queues.size();
+    unfinished++;
+    {
+        lock_guard<mutex> guard(queues[target]->lock);
+        queues[target]->tasks.push_back(move(task));
+    }
+    {
+        lock_guard<mutex> guard(sleepLock);     //paired with the wait predicate so no wakeup is lost
+        queued++;
+    }
+    wake.notify_one();
+}
+
+/* wait
+ * Blocks until every submitted task has finished, running tasks meanwhile.
+ *
+ * Throws:
+ *   The first exception thrown by a task since the last wait().
+ */
+void ThreadPool::wait() {
+    while (unfinished > 0) {
+        if (runOne(queues.size())) continue;
+        unique_lock<mutex> guard(sleepLock);
+        idle.wait_for(guard, chrono::milliseconds(1), [&] { return unfinished == 0 || queued > 0; });
+    }
+
+    lock_guard<mutex> guard(sleepLock);
+    if (failure) {
+        exception_ptr thrown = failure;
+        failure = nullptr;
+        rethrow_exception(thrown);
+    }
+}
+
+/* runOne
+ * Runs a single task, preferring the newest one in this thread's own deque.
+ *
+ * Parameters:
+ *   self - index of this thread's deque, or queues.size() to only steal.
+ *
+ * Returns:
+ *   true if a task was run; false if every deque was empty.
+ */
+bool ThreadPool::runOne(size_t self) {
+    function<void()> task;
+    if (self < queues.size()) {
+        lock_guard<mutex> guard(queues[self]->lock);
+        if (!queues[self]->tasks.empty()) {
+            task = move(queues[self]->tasks.back());
+            queues[self]->tasks.pop_back();
+        }
+    }
+    //Steal the oldest task from the other deques, starting just after our own
+    for (size_t i = 1; !task && i <= queues.size(); i++) {
+        TaskQueue& victim = *queues[(self + i) % queues.size()];
+        lock_guard<mutex> guard(victim.lock);
+        if (!victim.tasks.empty()) {
+            task = move(victim.tasks.front());
+            victim.tasks.pop_front();
+        }
+    }
+    if (!task) return false;
+    queued--;
+
+    try {
+        task();
+    } catch (...) {
+        lock_guard<mutex> guard(sleepLock);
+        if (!failure) failure = current_exception();
+    }
+    if (--unfinished == 0) {
+        lock_guard<mutex> guard(sleepLock);
+        idle.notify_all();
+    }
+    return true;
+}
+
+/* workerLoop
+ * Body of each worker thread: run tasks until the pool is destroyed.
+ */
+void ThreadPool::workerLoop(size_t self) {
+    currentPool = this;
+    currentQueue = self;
+    while (true) {
+        if (runOne(self)) continue;
+        unique_lock<mutex> guard(sleepLock);
+        wake.wait(guard, [&] { return stopping || queued > 0; });
+        if (stopping && queued == 0) return;
+    }
+}
@@ -0,0 +1,207 @@
+/* Nolan Pierce - Versioned Wardrobe Implementation
+ *
+ * Overview:
+ *   Copy-on-write versions of a wardrobe for read-mostly sharing between
+ *   threads. Readers never block, not even on each other: they only write
+ *   their own slot and read one pointer. Writers pay for the copy of the
+ *   clothing types they change.
+ *
+ * Reclamation:
+ *   A global epoch advances every time a version is replaced, and the old
+ *   version is stamped with the epoch it was replaced in. A reader announces
+ *   the epoch it started in before loading the current pointer, so a reader
+ *   that announced a later epoch can only have loaded a newer version. A
+ *   replaced version is freed once every announced reader started after it.
+ */
+#include "../Headers/VersionedWardrobe.h"
+#include <algorithm>
+#include <thread>
+
+using namespace std;
+
+/* size
+ * Returns the total number of items across all 4 clothing types.
+ */
+size_t WardrobeVersion::size() const {
+    return types[JACKET]->size() + types[TOP]->size() + types[BOTTOM]->size() + types[SHOES]->size();
+}
+
+VersionedWardrobe::ReadGuard::ReadGuard(ReadGuard&& other) noexcept : slot(other.slot), version(other.version) {
+    other.slot = nullptr;
+}
+
+VersionedWardrobe::ReadGuard::~ReadGuard() {
+    if (slot) slot->store(0, memory_order_release);
+}
+
+/* VersionedWardrobe
+ * Publishes the initial contents as version 0.
+ */
+VersionedWardrobe::VersionedWardrobe(Wardrobe initial) : master(move(initial)) {
+    WardrobeVersion* first = new WardrobeVersion;
+    for (uint8_t type = JACKET; type <= SHOES; type++)
+        first->types[type] = make_shared<const vector<ClothingItem>>(getType(master, type));
+    current.store(first);
+}
+
+VersionedWardrobe::~VersionedWardrobe() {
+    for (const auto& old : retired) delete old.version;
+    delete current.load();
+}
+
+/* read
+ * Returns a guard holding the current version, without taking any lock.
+ *
+ * Details:
+ *   - Each thread starts at its own home slot, so readers normally claim
+ *     an uncontended cache line; nested reads use the next free slot.
+ */
+VersionedWardrobe::ReadGuard VersionedWardrobe::read() const {
+    static atomic<size_t> nextHome{0};
+    thread_local size_t home = nextHome.fetch_add(1) % MAX_READERS;
+    for (size_t attempt = 0;; attempt++) {
+        atomic<uint64_t>& slot = slots[(home + attempt) % MAX_READERS].epoch;
+        uint64_t free = 0;
+        //Announce first, then load: both sequentially consistent, so a writer's scan sees the announcement
+        if (slot.load(memory_order_relaxed) == 0 && slot.compare_exchange_strong(free, epoch.load()))
+            return ReadGuard(&slot, current.load());
+        if (attempt % MAX_READERS == MAX_READERS - 1) this_thread::yield();
+    }
+}
+
+/* write
+ * Applies an edit to the wardrobe and publishes the result.
+ *
+ * Parameters:
+ *   typeMask - typeBit of every clothing type the edit may change; the others
+ *              are shared with the previous version. 0 publishes nothing, for
+ *              edits that only look at the wardrobe.
+ *   edit     - called with the writers' indexed Wardrobe, under the writer lock.
+ */
+void VersionedWardrobe::write(uint8_t typeMask, const function<void(Wardrobe&)>& edit) {
+    lock_guard<mutex> holding(writer);
+    edit(master);
+    publish(typeMask);
+}
+
+/* publish
+ * Makes the master wardrobe the current version and retires the previous one.
+ *
+ * Details:
+ *   - Called with the writer lock held.
+ */
+void VersionedWardrobe::publish(uint8_t typeMask) {
+    if (typeMask == 0) return;
+    const WardrobeVersion* previous = current.load(memory_order_relaxed);
+    WardrobeVersion* next = new WardrobeVersion;
+    next->number = previous->number + 1;
+    for (uint8_t type = JACKET; type <= SHOES; type++) {
+        if (typeMask & typeBit(type)) next->types[type] = make_shared<const vector<ClothingItem>>(getType(master, type));
+        else next->types[type] = previous->types[type];
+    }
+    current.store(next);
+    retired.push_back({previous, epoch.fetch_add(1)});
+    reclaim();
+}
+
+/* reclaim
+ * Frees retired versions that no reader can still be holding.
+ */
+void VersionedWardrobe::reclaim() {
+    uint64_t oldest = UINT64_MAX;
+    for (const auto& slot : slots) {
+        uint64_t started = slot.epoch.load();
+        if (started != 0) oldest = min(oldest, started);
+    }
+    //A reader that started in epoch e may hold any version retired in epoch e or later
+    auto kept = remove_if(retired.begin(), retired.end(), [&](const Retired& old) {
+        if (old.epoch >= oldest) return false;
+        delete old.version;
+        return true;
+    });
+    retired.erase(kept, retired.end());
+}
+
+/* retiredVersions
+ * Returns the number of replaced versions still waiting for readers to leave.
+ */
+size_t VersionedWardrobe::retiredVersions() {
+    lock_guard<mutex> holding(writer);
+    return retired.size();
+}
+
+/* writeBoth
+ * Applies one edit to two wardrobes at once, e.g. moving items between clean and dirty.
+ *
+ * Parameters:
+ *   first, second - two different wardrobes; both writer locks are held during the edit.
+ *   edit          - called with both writers' Wardrobes.
+ *   typeMask      - types to publish in both, as in write().
+ *
+ * Details:
+ *   - Each wardrobe publishes on its own, so a reader of both may briefly see a
+ *     moved item in both or in neither.
+ */
+void writeBoth(VersionedWardrobe& first, VersionedWardrobe& second,
+               const function<void(Wardrobe&, Wardrobe&)>& edit, uint8_t typeMask) {
+    scoped_lock holding(first.writer, second.writer);
+    edit(first.master, second.master);
+    first.publish(typeMask);
+    second.publish(typeMask);
+}
+
+/* addClothing
+ * Adds items and publishes only the types they belong to.
+ */
+void addClothing(VersionedWardrobe& outfits, const vector<ClothingItem>& items) {
+    uint8_t typeMask = 0;
+    for (const auto& item : items) typeMask |= typeBit(item.type);
+    outfits.write(typeMask, [&](Wardrobe& master) { insertClothing(master, items); });
+}
+
+/* removeClothing
+ * Removes every item equal to the given one.
+ *
+ * Returns:
+ *   Number of items removed.
+ */
+size_t removeClothing(VersionedWardrobe& outfits, const ClothingItem& item) {
+    size_t removed = 0;
+    outfits.write(typeBit(item.type), [&](Wardrobe& master) { removed = eraseAllClothing(master, item); });
+    return removed;
+}
+
+/* updateWardrobes
+ * Moves items between two versioned wardrobes, excluding items that should stay
+ * (see updateWardrobes on Wardrobe).
+ */
+void updateWardrobes(VersionedWardrobe& src, VersionedWardrobe& dest, const Wardrobe& stay,
+                     vector<ClothingItem>* moved) {
+    writeBoth(src, dest, [&](Wardrobe& from, Wardrobe& to) { updateWardrobes(from, to, stay, moved); });
+}
+
+/* moveClothing
+ * Moves the given items between versioned wardrobes (see moveClothing on
+ * Wardrobe), publishing only the types they belong to.
+ */
+size_t moveClothing(VersionedWardrobe& src, VersionedWardrobe& dest, const vector<ClothingItem>& items,
+                    vector<ClothingItem>* moved) {
+    uint8_t typeMask = 0;
+    for (const auto& item : items) typeMask |= typeBit(item.type);
+    size_t count = 0;
+    writeBoth(src, dest, [&](Wardrobe& from, Wardrobe& to) { count = moveClothing(from, to, items, moved); },
+              typeMask);
+    return count;
+}
+
+/* pickOutfits
+ * Plans outfits from a versioned wardrobe (see pickOutfits on Wardrobe).
+ */
+PickResult pickOutfits(VersionedWardrobe& outfits, VersionedWardrobe& dirty, size_t n, const PickOptions& options,
+                       Xoshiro256& rng) {
+    PickResult result;
+    writeBoth(outfits, dirty, [&](Wardrobe& clean, Wardrobe& worn) {
+        result = pickOutfits(clean, worn, n, options, rng);
+    });
+    return result;
+}
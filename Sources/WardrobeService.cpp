@@ -0,0 +1,715 @@
+/* Nolan Pierce - Wardrobe Service Implementation
+ *
+ * Overview:
+ *   Long-running daemon mode: keeps every user's wardrobes in memory and
+ *   answers add, remove, laundry, pick, best and list requests over a Unix domain
+ *   socket, so scripts pay neither process start-up nor CSV parsing per change.
+ *   The protocol is described in WardrobeService.h.
+ *
+ * Files (for user alice, under ServiceOptions::dataDir):
+ *   alice/outfits.csv, alice/dirtyLaundry.csv   - snapshots, as in interactive mode
+ *   alice/outfits.csv.journal                   - changes since the last compaction
+ *   alice/outfits.csv.journal.sealed            - changes a background compaction is folding in
+ */
+#include "../Headers/WardrobeService.h"
+#include <cctype>
+#include <charconv>
+#include <csignal>
+#include <cstring>
+#include <filesystem>
+#include <thread>
+#ifndef _WIN32
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif
+
+using namespace std;
+
+// A connection that sends this much without a newline is dropped
+static const size_t MAX_REQUEST_BYTES = 1 << 20;
+// Largest count= a pick request takes; more is refused rather than attempted
+static const uint64_t MAX_PICK_COUNT = 100000;
+// Largest count= a best request takes
+static const uint64_t MAX_BEST_COUNT = 10000;
+
+/* validUser
+ * Checks that a user name is safe to use as a directory name.
+ */
+static bool validUser(string_view user) {
+    if (user.empty() || user.size() > 64 || user.front() == '.') return false;
+    for (char c : user) {
+        if (!isalnum((unsigned char)c) && c != '_' && c != '.' && c != '-') return false;
+    }
+    return true;
+}
+
+/* replyError
+ * Writes an ERR status line.
+ */
+static void replyError(OutputBuffer& out, string_view message) {
+    out.append("ERR ");
+    out.append(message);
+    out.append('\n');
+}
+
+/* replyOk
+ * Writes an OK status line announcing the number of lines that follow.
+ */
+static void replyOk(OutputBuffer& out, size_t lines) {
+    out.append("OK ");
+    out.appendNumber(lines);
+    out.append('\n');
+}
+
+/* parseItems
+ * Reads every argument from the given index on as a CSV item.
+ *
+ * Returns:
+ *   false, with an ERR already written, if any argument is not an item.
+ */
+static bool parseItems(const vector<string_view>& fields, size_t first, vector<ClothingItem>& items,
+                       OutputBuffer& out) {
+    for (size_t i = first; i < fields.size(); i++) {
+        ClothingItem item;
+        if (!parseClothingLine(fields[i], item)) {
+            replyError(out, "not an item: " + string(fields[i]));
+            return false;
+        }
+        items.push_back(item);
+    }
+    return true;
+}
+
+/* findItems
+ * Reads every argument from the given index on as a CSV item to look for.
+ *
+ * Returns:
+ *   false, with an ERR already written, if any argument is not an item.
+ *
+ * Details:
+ *   - Attributes are looked up, not interned: an item with a value no wardrobe
+ *     has cannot match anything and is left out, so remove and laundry requests
+ *     never grow the dictionary every user shares.
+ */
+static bool findItems(const vector<string_view>& fields, size_t first, vector<ClothingItem>& items,
+                      OutputBuffer& out) {
+    for (size_t i = first; i < fields.size(); i++) {
+        ClothingItem item;
+        string_view attributes[3];
+        if (!splitClothingLine(fields[i], item, attributes)) {
+            replyError(out, "not an item: " + string(fields[i]));
+            return false;
+        }
+        if (findAttribute(attributes[0], item.material) && findAttribute(attributes[1], item.color) &&
+            findAttribute(attributes[2], item.pattern))
+            items.push_back(item);
+    }
+    return true;
+}
+
+/* parseNumber
+ * Reads the unsigned number after "key=" in a pick argument.
+ */
+static bool parseNumber(string_view text, uint64_t& value) {
+    auto [end, error] = from_chars(text.data(), text.data() + text.size(), value);
+    return !text.empty() && error == errc() && end == text.data() + text.size();
+}
+
+WardrobeService::WardrobeService(ServiceOptions options)
+    : options(move(options)), rules(loadStyleRules(this->options.rulesPath)), cache(this->options.cacheBytes) {}
+
+/* ~WardrobeService
+ * Closes the socket and flushes every loaded user's journal.
+ *
+ * Details:
+ *   - Call stop() and wait for serve() to return before destroying the service.
+ */
+WardrobeService::~WardrobeService() {
+#ifndef _WIN32
+    if (listenFd >= 0) {
+        ::close(listenFd);
+        unlink(options.socketPath.c_str());
+    }
+#endif
+}
+
+/* listen
+ * Creates the data directory and starts listening on the socket.
+ *
+ * Returns:
+ *   false, with a message on stderr, if the socket cannot be set up, e.g.
+ *   because another service is already answering on it.
+ *
+ * Details:
+ *   - Ignores SIGPIPE for the whole process, so a client that disconnects
+ *     mid-response only ends its own connection.
+ */
+bool WardrobeService::listen() {
+#ifdef _WIN32
+    cerr << "Error: The wardrobe service needs Unix domain sockets.\n";
+    return false;
+#else
+    signal(SIGPIPE, SIG_IGN);
+    error_code error;
+    filesystem::create_directories(options.dataDir, error);
+
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    if (options.socketPath.size() >= sizeof(address.sun_path)) {
+        cerr << "Error: Socket path is too long: " << options.socketPath << "\n";
+        return false;
+    }
+    memcpy(address.sun_path, options.socketPath.c_str(), options.socketPath.size() + 1);
+
+    //A socket file nobody answers on is left over from a crash and can be replaced
+    ServiceClient probe;
+    if (probe.connect(options.socketPath)) {
+        cerr << "Error: A wardrobe service is already running on " << options.socketPath << "\n";
+        return false;
+    }
+    unlink(options.socketPath.c_str());
+
+    listenFd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listenFd < 0 || bind(listenFd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 ||
+        ::listen(listenFd, SOMAXCONN) != 0) {
+        cerr << "Error: Could not listen on " << options.socketPath << ": " << strerror(errno) << "\n";
+        if (listenFd >= 0) ::close(listenFd);
+        listenFd = -1;
+        return false;
+    }
+    return true;
+#endif
+}
+
+/* serve
+ * Accepts connections until stop() is called, then waits for open ones to finish.
+ *
+ * Details:
+ *   - Each connection gets its own thread, as clients block between requests.
+ *   - The accept loop wakes up every 200 ms to notice stop(), which may be
+ *     called from a signal handler.
+ */
+void WardrobeService::serve() {
+#ifndef _WIN32
+    while (!stopping) {
+        pollfd listening{listenFd, POLLIN, 0};
+        if (poll(&listening, 1, 200) <= 0) continue;
+        int fd = accept(listenFd, nullptr, nullptr);
+        if (fd < 0) continue;
+        {
+            lock_guard<mutex> holding(connectionsLock);
+            connections.insert(fd);
+        }
+        thread([this, fd] { serveConnection(fd); }).detach();
+    }
+
+    //Wake connections blocked in read, then wait for their threads to let go of the service
+    unique_lock<mutex> holding(connectionsLock);
+    for (int fd : connections) shutdown(fd, SHUT_RDWR);
+    connectionsDone.wait(holding, [this] { return connections.empty(); });
+#endif
+}
+
+/* stop
+ * Asks serve() to return. Safe to call from a signal handler.
+ */
+void WardrobeService::stop() {
+    stopping = true;
+}
+
+/* serveConnection
+ * Answers one client's requests until it disconnects.
+ *
+ * Details:
+ *   - Every complete line read is answered before the responses are written,
+ *     so pipelined requests share one write.
+ */
+void WardrobeService::serveConnection(int fd) {
+#ifndef _WIN32
+    //Declared first, so the stream is closed after out's destructor has flushed it
+    unique_ptr<FILE, int (*)(FILE*)> stream(fdopen(dup(fd), "w"), fclose);
+    if (stream) {
+        OutputBuffer out(stream.get(), 1 << 16);
+        string pending;
+        char chunk[1 << 16];
+        while (!stopping) {
+            ssize_t got = read(fd, chunk, sizeof(chunk));
+            if (got < 0 && errno == EINTR) continue;
+            if (got <= 0) break;
+            pending.append(chunk, got);
+
+            size_t start = 0;
+            for (size_t end = pending.find('\n'); end != string::npos; end = pending.find('\n', start)) {
+                string_view line(pending.data() + start, end - start);
+                if (!line.empty() && line.back() == '\r') line.remove_suffix(1);
+                handle(line, out);
+                start = end + 1;
+            }
+            pending.erase(0, start);
+            out.flush();
+            if (ferror(stream.get()) || pending.size() > MAX_REQUEST_BYTES) break;
+        }
+    }
+    stream.reset();
+
+    lock_guard<mutex> holding(connectionsLock);
+    connections.erase(fd);
+    ::close(fd);
+    connectionsDone.notify_all();
+#endif
+}
+
+/* account
+ * Finds a user's account, creating an empty, not yet loaded one on first use.
+ *
+ * Returns:
+ *   null if maxAccounts users are loaded and every one of them is in use.
+ *
+ * Details:
+ *   - The caller's reference keeps the account from being unloaded.
+ */
+shared_ptr<WardrobeService::Account> WardrobeService::account(string_view user) {
+    string name(user);
+    shared_ptr<Account> found;
+    {
+        shared_lock<shared_mutex> reading(accountsLock);
+        auto slot = users.find(name);
+        if (slot != users.end()) found = slot->second;
+    }
+    if (!found) {
+        unique_lock<shared_mutex> writing(accountsLock);
+        auto slot = users.find(name);
+        if (slot == users.end()) {
+            if (users.size() >= options.maxAccounts && !unloadIdleAccount()) return nullptr;
+            slot = users.emplace(name, make_shared<Account>()).first;
+        }
+        found = slot->second;
+    }
+    found->lastUsed.store(++useClock, memory_order_relaxed);
+    return found;
+}
+
+/* unloadIdleAccount
+ * Drops the least recently used account nobody is using, flushing its journal.
+ *
+ * Returns:
+ *   false if every account is in use.
+ *
+ * Details:
+ *   - Called with accountsLock held for writing. References are only taken under
+ *     that lock, so an account the map alone refers to cannot be picked up meanwhile.
+ *   - The account is destroyed before the lock is released, so its journal is
+ *     flushed before a new request could load the user again.
+ */
+bool WardrobeService::unloadIdleAccount() {
+    auto oldest = users.end();
+    for (auto slot = users.begin(); slot != users.end(); slot++) {
+        if (slot->second.use_count() != 1) continue;
+        if (oldest == users.end() || slot->second->lastUsed.load(memory_order_relaxed) <
+                                         oldest->second->lastUsed.load(memory_order_relaxed))
+            oldest = slot;
+    }
+    if (oldest == users.end()) return false;
+    users.erase(oldest);
+    return true;
+}
+
+/* accounts
+ * Returns the number of users loaded or being loaded.
+ */
+size_t WardrobeService::accounts() {
+    shared_lock<shared_mutex> reading(accountsLock);
+    return users.size();
+}
+
+/* handle
+ * Answers one request line.
+ *
+ * Parameters:
+ *   request - the line, without its newline.
+ *   out     - buffer the response is appended to; not flushed.
+ *
+ * Details:
+ *   - Holds only the requesting user's lock while it works, so other users'
+ *     requests are not held up.
+ *   - Changes are journaled, and with syncEachRequest the journal is fsynced
+ *     before the response is written, as command mode does before exiting.
+ *   - Anything answer() throws is replied as ERR, so one bad request cannot
+ *     take down the connection threads of every other user.
+ */
+void WardrobeService::handle(string_view request, OutputBuffer& out) {
+    try {
+        answer(request, out);
+    } catch (const exception& error) {
+        replyError(out, string("request failed: ") + error.what());
+    }
+}
+
+/* answer
+ * Parses and carries out one request line (see handle).
+ */
+void WardrobeService::answer(string_view request, OutputBuffer& out) {
+    thread_local vector<string_view> fields;
+    fields.clear();
+    while (true) {
+        size_t tab = request.find('\t');
+        fields.push_back(request.substr(0, tab));
+        if (tab == string_view::npos) break;
+        request.remove_prefix(tab + 1);
+    }
+    if (fields.size() < 2) {
+        replyError(out, "expected user<TAB>command");
+        return;
+    }
+    if (!validUser(fields[0])) {
+        replyError(out, "bad user name");
+        return;
+    }
+    string_view command = fields[1];
+    if (command != "add" && command != "remove" && command != "laundry" && command != "pick" && command != "best" &&
+        command != "list") {
+        replyError(out, "unknown command: " + string(command));
+        return;
+    }
+
+    shared_ptr<Account> held = account(fields[0]);
+    if (!held) {
+        replyError(out, "too many users at once; try again later");
+        return;
+    }
+    Account& user = *held;
+    if (command == "list" && !listWardrobe(user, fields, out)) return;
+
+    lock_guard<mutex> holding(user.lock);
+    filesystem::path directory = filesystem::path(options.dataDir) / string(fields[0]);
+    try {
+        if (!user.loaded) {
+            //The directory is made by the first add, so asking about a user creates nothing on disk
+            error_code error;
+            user.stored = filesystem::exists(directory, error);
+            user.journal = make_unique<Journal>((directory / "outfits.csv").string(),
+                                                (directory / "dirtyLaundry.csv").string(), options.journalBatch);
+            writeBoth(user.outfits, user.dirty, [&](Wardrobe& outfits, Wardrobe& dirty) {
+                user.journal->load(outfits, dirty);
+            });
+            user.loaded.store(true, memory_order_release);
+        }
+    } catch (const exception& error) {
+        replyError(out, string("could not load wardrobe: ") + error.what());
+        return;
+    }
+    Journal& journal = *user.journal;
+    bool changed = true;
+
+    if (command == "add") {
+        vector<ClothingItem> items;
+        if (!parseItems(fields, 2, items, out)) return;
+        if (!items.empty() && !user.stored) {
+            filesystem::create_directories(directory);
+            user.stored = true;
+        }
+        addClothing(user.outfits, items);
+        journal.record(JOURNAL_ADD, items);
+        replyOk(out, 1);
+        out.appendNumber(items.size());
+        out.append('\n');
+    }
+    else if (command == "remove") {
+        vector<ClothingItem> items;
+        if (!findItems(fields, 2, items, out)) return;
+        uint8_t typeMask = 0;
+        for (const auto& item : items) typeMask |= typeBit(item.type);
+        vector<ClothingItem> removed;
+        user.outfits.write(typeMask, [&](Wardrobe& outfits) {
+            for (const auto& item : items) removed.insert(removed.end(), eraseAllClothing(outfits, item), item);
+        });
+        journal.record(JOURNAL_REMOVE, removed);
+        replyOk(out, 1);
+        out.appendNumber(removed.size());
+        out.append('\n');
+    }
+    else if (command == "laundry") {
+        if (fields.size() < 3) {
+            replyError(out, "laundry needs 'all', the items to keep dirty, or 'wash' and the items washed");
+            return;
+        }
+        vector<ClothingItem> washed;
+        if (fields[2] == "wash") {
+            //Only the washed items change, and only their types are republished
+            vector<ClothingItem> items;
+            if (!findItems(fields, 3, items, out)) return;
+            moveClothing(user.dirty, user.outfits, items, &washed);
+        }
+        else {
+            vector<ClothingItem> keep;
+            bool all = fields.size() == 3 && fields[2] == "all";
+            if (!all && !findItems(fields, 2, keep, out)) return;
+            writeBoth(user.dirty, user.outfits, [&](Wardrobe& dirty, Wardrobe& outfits) {
+                Wardrobe unwashed;
+                keyIndex(dirty);
+                for (const auto& item : keep) {
+                    if (countClothing(dirty, item) > 0) insertClothing(unwashed, item);
+                }
+                updateWardrobes(dirty, outfits, unwashed, &washed);
+            });
+        }
+        journal.record(JOURNAL_WASH, washed);
+        replyOk(out, 1);
+        out.appendNumber(washed.size());
+        out.append('\n');
+    }
+    else if (command == "pick") {
+        PickOptions pick;
+        uint64_t count = 1;
+        bool seeded = false;
+        uint64_t seed = 0;
+        for (size_t i = 2; i < fields.size(); i++) {
+            string_view arg = fields[i];
+            bool ok = true;
+            if (arg == "jacket") pick.jacket = true;
+            else if (arg == "rotate") pick.rotation = true;
+            else if (arg.substr(0, 6) == "count=") ok = parseNumber(arg.substr(6), count);
+            else if (arg.substr(0, 5) == "seed=") ok = seeded = parseNumber(arg.substr(5), seed);
+            else if (arg.substr(0, 4) == "day=") ok = parseDay(arg.substr(4), pick.day);
+            else ok = false;
+            if (!ok) {
+                replyError(out, "bad pick argument: " + string(arg));
+                return;
+            }
+        }
+        if (count > MAX_PICK_COUNT) {
+            replyError(out, "count must be at most " + to_string(MAX_PICK_COUNT));
+            return;
+        }
+        Xoshiro256 seededRng(seed);
+        PickResult result = pickOutfits(user.outfits, user.dirty, count, pick, seeded ? seededRng : pickerRng());
+        for (const auto& outfit : result.outfits) {
+            journal.record(JOURNAL_WORN, outfit.shoes);
+            journal.record(JOURNAL_WEAR, outfit.bottom);
+            journal.record(JOURNAL_WEAR, outfit.top);
+            if (outfit.hasJacket) journal.record(JOURNAL_WEAR, outfit.jacket);
+        }
+
+        thread_local vector<string_view> names;
+        attributeTable(names);
+        out.append("OK ");
+        out.appendNumber(result.outfits.size());
+        if (result.ranDry) {
+            out.append(" dry=");
+            out.append(typeName(result.dryType));
+        }
+        out.append('\n');
+        for (const auto& outfit : result.outfits) formatOutfit(out, outfit, names);
+        changed = !result.outfits.empty();
+    }
+    else if (command == "best") {
+        PickOptions pick;
+        uint64_t count = 1;
+        for (size_t i = 2; i < fields.size(); i++) {
+            string_view arg = fields[i];
+            bool ok = true;
+            if (arg == "jacket") pick.jacket = true;
+            else if (arg.substr(0, 6) == "count=") ok = parseNumber(arg.substr(6), count);
+            else ok = false;
+            if (!ok) {
+                replyError(out, "bad best argument: " + string(arg));
+                return;
+            }
+        }
+        if (count > MAX_BEST_COUNT) {
+            replyError(out, "count must be at most " + to_string(MAX_BEST_COUNT));
+            return;
+        }
+        //An empty write reaches the indexed wardrobe, whose version keys the cache
+        vector<ScoredOutfit> best;
+        user.outfits.write(0, [&](Wardrobe& outfits) { best = bestOutfits(outfits, rules, count, pick, cache); });
+
+        thread_local vector<string_view> names;
+        attributeTable(names);
+        replyOk(out, best.size());
+        for (const auto& scored : best) {
+            if (scored.score < 0) out.append('-');
+            out.appendNumber(uint64_t(scored.score < 0 ? -int64_t(scored.score) : scored.score));
+            out.append(" | ");
+            formatOutfit(out, scored.outfit, names);
+        }
+        changed = false;
+    }
+    else if (command == "list") {
+        listWardrobe(user, fields, out);
+        changed = false;
+    }
+
+    if (!changed) return;
+    if (options.syncEachRequest) journal.flush();
+    writeBoth(user.outfits, user.dirty, [&](Wardrobe& outfits, Wardrobe& dirty) {
+        if (journal.needsCompaction(wardrobeSize(outfits) + wardrobeSize(dirty)) &&
+            !journal.compactInBackground(outfits, dirty))
+            cerr << "Error: Could not compact the journal of user " << fields[0] << ".\n";
+    }, 0);
+}
+
+/* listWardrobe
+ * Answers a list request from the current version of a loaded user's wardrobe.
+ *
+ * Returns:
+ *   true if the user is not loaded yet, so nothing was written and the caller
+ *   has to load it first.
+ *
+ * Details:
+ *   - Takes no lock: changes the user makes meanwhile publish new versions
+ *     and leave this one as it was.
+ */
+bool WardrobeService::listWardrobe(Account& user, const vector<string_view>& fields, OutputBuffer& out) {
+    if (!user.loaded.load(memory_order_acquire)) return true;
+    bool laundry = fields.size() == 3 && fields[2] == "laundry";
+    if (fields.size() > 3 || (fields.size() == 3 && !laundry)) {
+        replyError(out, "list takes only 'laundry'");
+        return false;
+    }
+
+    VersionedWardrobe::ReadGuard listed = (laundry ? user.dirty : user.outfits).read();
+    thread_local vector<string_view> names;
+    attributeTable(names);
+    replyOk(out, listed->size());
+    for (uint8_t type = JACKET; type <= SHOES; type++) {
+        for (const auto& item : listed->items(type)) {
+            formatClothing(out, item, names, OUTPUT_COMPACT);
+            out.append('\n');
+        }
+    }
+    return false;
+}
+
+ServiceClient::~ServiceClient() {
+    close();
+}
+
+/* connect
+ * Opens a connection to a running service.
+ *
+ * Returns:
+ *   false if nothing is listening on the socket.
+ */
+bool ServiceClient::connect(const string& socketPath) {
+    close();
+#ifdef _WIN32
+    return false;
+#else
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    if (socketPath.size() >= sizeof(address.sun_path)) return false;
+    memcpy(address.sun_path, socketPath.c_str(), socketPath.size() + 1);
+    fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd >= 0 && ::connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == 0) return true;
+    close();
+    return false;
+#endif
+}
+
+/* request
+ * Sends one request line and reads the whole response.
+ *
+ * Parameters:
+ *   line     - request without its newline.
+ *   response - filled with the status line followed by any lines it announces.
+ *
+ * Returns:
+ *   false if the connection failed.
+ */
+bool ServiceClient::request(string_view line, vector<string>& response) {
+    response.clear();
+#ifdef _WIN32
+    return false;
+#else
+    if (fd < 0) return false;
+    string message(line);
+    message += '\n';
+    for (size_t sent = 0; sent < message.size();) {
+        ssize_t wrote = ::send(fd, message.data() + sent, message.size() - sent, MSG_NOSIGNAL);
+        if (wrote < 0 && errno == EINTR) continue;
+        if (wrote <= 0) return false;
+        sent += wrote;
+    }
+
+    response.emplace_back();
+    if (!readLine(response.back())) return false;
+    uint64_t lines = 0;
+    if (response.back().compare(0, 3, "OK ") == 0) {
+        string_view status(response.back());
+        status.remove_prefix(3);
+        from_chars(status.data(), status.data() + status.size(), lines);
+    }
+    for (uint64_t i = 0; i < lines; i++) {
+        response.emplace_back();
+        if (!readLine(response.back())) return false;
+    }
+    return true;
+#endif
+}
+
+/* readLine
+ * Reads up to the next newline, which is dropped.
+ */
+bool ServiceClient::readLine(string& line) {
+#ifdef _WIN32
+    return false;
+#else
+    size_t end;
+    while ((end = received.find('\n')) == string::npos) {
+        char chunk[1 << 16];
+        ssize_t got = read(fd, chunk, sizeof(chunk));
+        if (got < 0 && errno == EINTR) continue;
+        if (got <= 0) return false;
+        received.append(chunk, got);
+    }
+    line.assign(received, 0, end);
+    received.erase(0, end + 1);
+    return true;
+#endif
+}
+
+void ServiceClient::close() {
+#ifndef _WIN32
+    if (fd >= 0) ::close(fd);
+#endif
+    fd = -1;
+    received.clear();
+}
+
+// Service that SIGINT/SIGTERM should stop
+static WardrobeService* runningService = nullptr;
+
+static void stopRunningService(int) {
+    if (runningService) runningService->stop();
+}
+
+/* runService
+ * Runs the wardrobe service in the foreground until SIGINT or SIGTERM.
+ *
+ * Returns:
+ *   Process exit code: 0 after a clean shutdown, 1 if the socket could not be set up.
+ */
+int runService(const ServiceOptions& options) {
+    WardrobeService service(options);
+    if (!service.listen()) return 1;
+    runningService = &service;
+    signal(SIGINT, stopRunningService);
+    signal(SIGTERM, stopRunningService);
+    cerr << "Serving wardrobes from '" << options.dataDir << "' on " << options.socketPath << "\n";
+    service.serve();
+    runningService = nullptr;
+    cerr << "Stopped with " << service.accounts() << " users loaded.\n";
+    OutfitCacheStats cache = service.cacheStats();
+    if (cache.hits + cache.misses > 0) {
+        cerr << "Outfit cache: " << cache.hits << " hits, " << cache.misses << " misses ("
+             << 100.0 * cache.hits / (cache.hits + cache.misses) << "% hit rate), " << cache.evictions
+             << " evictions, " << cache.bytes / 1024 << " KiB in use.\n";
+    }
+    return 0;
+}
@@ -0,0 +1,234 @@
+/* Nolan Pierce - Wardrobe Stream Implementation
+ *
+ * Overview:
+ *   One-pass reading of wardrobe files that may be larger than memory, e.g.
+ *   retailer inventory dumps. Items are parsed out of a fixed-size buffer and
+ *   handed to per-type callbacks, so a count, a statistic or a random sample
+ *   never needs the whole Wardrobe.
+ */
+#include "../Headers/WardrobeStream.h"
+#include "../Headers/Stats.h"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+using namespace std;
+
+/* WardrobeStream
+ * Opens a wardrobe file for streaming.
+ *
+ * Parameters:
+ *   filename - CSV file or binary snapshot to read.
+ *   budget   - size of the read buffer in bytes; at least STREAM_MIN_BUDGET.
+ *
+ * Throws:
+ *   runtime_error if the file is a damaged snapshot, as loadDatabase does.
+ */
+WardrobeStream::WardrobeStream(const string& filename, size_t budget) : buffer(max(budget, STREAM_MIN_BUDGET)) {
+    file = fopen(filename.c_str(), "rb");
+    if (file == nullptr) return;
+    refill();
+    if (!isSnapshot(string_view(buffer.data(), end))) return;
+
+    fclose(file);
+    file = nullptr;
+    snapshot = true;
+    if (!view.open(filename)) throw runtime_error("Damaged or unsupported wardrobe snapshot: " + filename);
+}
+
+WardrobeStream::~WardrobeStream() {
+    STAT_ADD(STAT_ITEMS_PARSED, parsed);
+    STAT_ADD(STAT_BYTES_READ, bytes);
+    if (file) fclose(file);
+}
+
+/* refill
+ * Moves the unread bytes to the front of the buffer and reads more after them.
+ *
+ * Returns:
+ *   false at the end of the file.
+ *
+ * Details:
+ *   - If the unread bytes already fill the buffer, they are one line too long
+ *     to ever fit; they are dropped and the rest of that line is skipped.
+ */
+bool WardrobeStream::refill() {
+    if (file == nullptr) return false;
+    if (end - begin == buffer.size()) {
+        discarding = true;
+        begin = end = 0;
+    }
+    memmove(buffer.data(), buffer.data() + begin, end - begin);
+    end -= begin;
+    begin = 0;
+
+    size_t got = fread(buffer.data() + end, 1, buffer.size() - end, file);
+    end += got;
+    bytes += got;
+    return got > 0;
+}
+
+/* next
+ * Reads the next item of the file.
+ *
+ * Parameters:
+ *   item - receives the item.
+ *
+ * Returns:
+ *   false once the file is exhausted.
+ */
+bool WardrobeStream::next(ClothingItem& item) {
+    if (snapshot) {
+        for (; type <= SHOES; type++, position = 0) {
+            if (position < view.count(type)) {
+                item = view.item(type, position++);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    while (true) {
+        string_view line;
+        const char* newline = static_cast<const char*>(memchr(buffer.data() + begin, '\n', end - begin));
+        if (newline != nullptr) {
+            line = string_view(buffer.data() + begin, newline - (buffer.data() + begin));
+            begin = newline - buffer.data() + 1;
+        }
+        else if (refill()) continue;
+        else if (begin == end) {
+            skippedLines += discarding;
+            discarding = false;
+            return false;
+        }
+        else {
+            //Last line, without a newline
+            line = string_view(buffer.data() + begin, end - begin);
+            begin = end;
+        }
+
+        if (discarding) {
+            discarding = false;
+            skippedLines++;
+            continue;
+        }
+        if (line.empty() || line == "\r") continue;
+        if (parseClothingLine(line, item)) {
+            parsed++;
+            return true;
+        }
+        skippedLines++;
+    }
+}
+
+/* offer
+ * Shows the reservoir one more item of the stream.
+ *
+ * Parameters:
+ *   item - the item.
+ *   rng  - generator deciding whether it replaces a sampled item.
+ *
+ * Details:
+ *   - Algorithm R: the k-th item of a type (counting from 1) is kept with
+ *     probability perType / k, replacing a uniformly chosen sample, so every
+ *     item seen so far is in the sample with the same probability.
+ */
+void ClothingReservoir::offer(const ClothingItem& item, Xoshiro256& rng) {
+    uint64_t before = counts[item.type]++;
+    vector<ClothingItem>& kept = samples[item.type];
+    if (kept.size() < capacity) {
+        kept.push_back(item);
+        return;
+    }
+    uint64_t slot = uniformIndex(rng, before + 1);
+    if (slot < capacity) kept[slot] = item;
+}
+
+/* streamDatabase
+ * Reads a wardrobe file in one pass, calling the handler of each item's type.
+ *
+ * Parameters:
+ *   filename - CSV file or binary snapshot to read.
+ *   handlers - per-type callbacks; empty ones skip their type.
+ *   budget   - read buffer size in bytes (see WardrobeStream).
+ *   summary  - optional counts of what was read.
+ *
+ * Returns:
+ *   Number of items read.
+ */
+uint64_t streamDatabase(const string& filename, const ClothingHandlers& handlers, size_t budget,
+                        StreamSummary* summary) {
+    WardrobeStream stream(filename, budget);
+    StreamSummary seen;
+    ClothingItem item;
+    uint64_t total = 0;
+    while (stream.next(item)) {
+        total++;
+        seen.items[item.type]++;
+        if (handlers.byType[item.type]) handlers.byType[item.type](item);
+    }
+    if (summary) {
+        seen.skipped = stream.skipped();
+        seen.bytes = stream.bytesRead();
+        *summary = seen;
+    }
+    return total;
+}
+
+/* sampleOutfits
+ * Draws random outfits from a wardrobe file in one pass, without loading it
+ * and without wearing anything.
+ *
+ * Parameters:
+ *   filename - CSV file or binary snapshot to read.
+ *   n        - number of outfits.
+ *   jacket   - whether each outfit includes a jacket.
+ *   rng      - generator for the sample.
+ *   budget   - read buffer size in bytes.
+ *   summary  - optional counts of what was read.
+ *
+ * Returns:
+ *   Up to n outfits. As in pickOutfits, tops, bottoms and jackets differ
+ *   between outfits while shoes may repeat; if a type has too few items the
+ *   result is short and ranDry/dryType say which.
+ *
+ * Details:
+ *   - Memory is the read buffer plus n items of each type.
+ */
+PickResult sampleOutfits(const string& filename, size_t n, bool jacket, Xoshiro256& rng, size_t budget,
+                         StreamSummary* summary) {
+    ClothingReservoir reservoir(n);
+    ClothingHandlers handlers;
+    for (uint8_t type = jacket ? JACKET : TOP; type <= SHOES; type++)
+        handlers.byType[type] = [&](const ClothingItem& item) { reservoir.offer(item, rng); };
+    streamDatabase(filename, handlers, budget, summary);
+
+    //The first n items of a type fill the reservoir in file order; shuffle before pairing them up
+    vector<ClothingItem> drawn[4];
+    for (uint8_t type = JACKET; type <= SHOES; type++) {
+        drawn[type] = reservoir.sample(type);
+        for (size_t i = drawn[type].size(); i > 1; i--) swap(drawn[type][i - 1], drawn[type][uniformIndex(rng, i)]);
+    }
+
+    PickResult result;
+    const uint8_t needed[] = {SHOES, BOTTOM, TOP, JACKET};
+    size_t possible = n;
+    for (size_t t = 0; t < (jacket ? 4 : 3); t++) {
+        size_t available = needed[t] == SHOES ? (drawn[SHOES].empty() ? 0 : n) : drawn[needed[t]].size();
+        if (available < possible) {
+            possible = available;
+            result.ranDry = true;
+            result.dryType = needed[t];
+        }
+    }
+    for (size_t i = 0; i < possible; i++) {
+        Outfit outfit{};
+        outfit.shoes = drawn[SHOES][uniformIndex(rng, drawn[SHOES].size())];
+        outfit.bottom = drawn[BOTTOM][i];
+        outfit.top = drawn[TOP][i];
+        outfit.hasJacket = jacket;
+        if (jacket) outfit.jacket = drawn[JACKET][i];
+        result.outfits.push_back(outfit);
+    }
+    return result;
+}
@@ -25,6 +25,10 @@
 #include <algorithm>
 #include <limits>
 #include "Headers/OutfitPicker.h"
+#include "Headers/Commands.h"
+#include "Headers/Journal.h"
+#include "Headers/Conditions.h"
+#include "Headers/Stats.h"
 
 
 /* promptAdditions
@@ -32,6 +36,7 @@
  *
  * Parameters:
  *   outfits - reference to the Wardrobe object containing all available clothes.
+ *   journal - journal the additions are recorded in.
  *
  * Details:
  *   - Asks the user if they have new clothes to add.
@@ -39,7 +44,7 @@
  *   - Converts all input to lowercase for case-insensitive matching.
  *   - Prints the updated wardrobe when finished.
  */
-void promptAdditions(Wardrobe& outfits) {
+void promptAdditions(Wardrobe& outfits, Journal& journal) {
     string action;      //re-usable variable to store user input
     cout << "\n Do you have any clothes to add? (Yes/No): ";
     cin >> action;
@@ -48,7 +53,9 @@ void promptAdditions(Wardrobe& outfits) {
     checkBool(action);
     if (action == "no")  return;        //Abort function to improve runtime
     while (action != "no") {        //ensures user can add multiple items
-        addClothing(outfits);
+        vector<ClothingItem> added;
+        addClothing(outfits, &added);
+        journal.record(JOURNAL_ADD, added);
         cout << "\n Do you want to add more clothes? (Yes/No): ";  
         cin >> action;
         cin.ignore(numeric_limits<streamsize>::max(), '\n');
@@ -63,6 +70,7 @@ void promptAdditions(Wardrobe& outfits) {
  *
  * Parameters:
  *   outfits - reference to the Wardrobe object containing all available clothes.
+ *   journal - journal the removals are recorded in.
  *
  * Details:
  *   - Asks the user if they have clothes to remove.
@@ -70,7 +78,7 @@ void promptAdditions(Wardrobe& outfits) {
  *   - Converts all input to lowercase for case-insensitive matching.
  *   - Prints the updated wardrobe when finished.
  */
-void promptRemovals(Wardrobe& outfits) {
+void promptRemovals(Wardrobe& outfits, Journal& journal) {
     string action;
     cout << "\n Do you have any clothes to remove? (Yes/No): ";
     cin >> action;
@@ -79,7 +87,9 @@ void promptRemovals(Wardrobe& outfits) {
     checkBool(action);
     if (action == "no") return;         //Abort function to improve runtime
     while (action != "no") {        //ensures user can remove multiple items
-        removeClothing(outfits);
+        vector<ClothingItem> removed;
+        removeClothing(outfits, &removed);
+        journal.record(JOURNAL_REMOVE, removed);
         cout << "\n Do you want to remove more clothes? (Yes/No): ";  
         cin >> action;
         cin.ignore(numeric_limits<streamsize>::max(), '\n');
@@ -96,6 +106,7 @@ void promptRemovals(Wardrobe& outfits) {
  * Parameters:
  *   outfits      - reference to the Wardrobe object containing clean clothes.
  *   dirtyLaundry - reference to the Wardrobe object containing dirty clothes.
+ *   journal      - journal the washed items are recorded in.
  *
  * Details:
  *   - If laundry is done, asks whether all dirty clothes were washed.
@@ -103,7 +114,7 @@ void promptRemovals(Wardrobe& outfits) {
  *   - Updates wardrobe and dirty laundry lists accordingly.
  *   - Persists changes for future outfit selections.
  */
-void promptLaundry(Wardrobe& outfits, Wardrobe& dirtyLaundry) {
+void promptLaundry(Wardrobe& outfits, Wardrobe& dirtyLaundry, Journal& journal) {
     Wardrobe unwashed;
     string action;
     cout << " \nHave you done laundry? (Yes/No)";
@@ -127,18 +138,14 @@ void promptLaundry(Wardrobe& outfits, Wardrobe& dirtyLaundry) {
         cin >> numDirty;
         cin.ignore(numeric_limits<streamsize>::max(), '\n');
 
-        //Lambda checks if the clothing item is in the vector to avoid accidental typos
-        auto containsClothing = [](const vector<ClothingItem>& list, const ClothingItem& item) {
-                                return find(list.begin(), list.end(), item) != list.end();};
-
         //User describes each item they left dirty to ensure it doesn't become available to pick from
         for (int i = 1; i <= numDirty; i++) {
             cout << "\nPlease describe item " << i << " that you didn't wash \n";
             ClothingItem dirty = getUsersClothing();
 
-            vector<ClothingItem>& dirtyList = getType(dirtyLaundry, dirty);
-            if (containsClothing(dirtyList, dirty)) {
-                getType(unwashed, dirty).push_back(dirty);
+            //Indexed lookup checks the item is really dirty; after a typo the closest dirty items are offered
+            if (countClothing(dirtyLaundry, dirty) > 0 || offerSuggestions(dirtyLaundry, dirty)) {
+                insertClothing(unwashed, dirty);
             } 
             else {
                 cerr << "That item is not in your dirty laundry list. Please try again.\n";
@@ -149,7 +156,10 @@ void promptLaundry(Wardrobe& outfits, Wardrobe& dirtyLaundry) {
         cout << "\nHere are the clothes that are still dirty: \n";      //allows user to ensure correctness of their answers
         printWardrobe(unwashed);
     }  
-    updateWardrobes(dirtyLaundry, outfits, unwashed);       //Saves changes so outfit picked can include washed items
+    vector<ClothingItem> washed;
+    washed.reserve(wardrobeSize(dirtyLaundry));
+    updateWardrobes(dirtyLaundry, outfits, unwashed, &washed);      //Saves changes so outfit picked can include washed items
+    journal.record(JOURNAL_WASH, washed);
     cout << "Good job! I have updated the outfit database to now include the clean clothes!";
 }
 
@@ -159,14 +169,16 @@ void promptLaundry(Wardrobe& outfits, Wardrobe& dirtyLaundry) {
  * Parameters:
  *   outfits - reference to the Wardrobe object containing clean clothes.
  *   dirty   - reference to the Wardrobe object containing dirty clothes.
+ *   journal - journal the worn items are recorded in.
  *
  * Details:
  *   - Asks whether the user wants an outfit suggestion.
- *   - If yes, asks whether to include a jacket.
+ *   - If yes, dresses for today's weather from Other Files/conditions.csv, or
+ *     asks whether to include a jacket when there is no forecast for today.
  *   - Picks a random outfit (and jacket if desired).
- *   - Moves selected clothes to dirty laundry.
+ *   - Moves selected clothes to dirty laundry and records today as their last wear.
  */
-void promptOutfit(Wardrobe& outfits, Wardrobe& dirty) {
+void promptOutfit(Wardrobe& outfits, Wardrobe& dirty, Journal& journal) {
     string action;
 
     cout << "\nDo you want an outfit suggestion? (Yes/No): ";
@@ -176,23 +188,73 @@ void promptOutfit(Wardrobe& outfits, Wardrobe& dirty) {
     checkBool(action);
     if (action == "no") return;     //Aborts function to improve runtime
 
-    cout << "   Do you need a jacket? (Yes/No): ";      //FUTURE PLANS: check weather API to suggest jacket or not
-    cin >> action;
-    cin.ignore(numeric_limits<streamsize>::max(), '\n');
-    toLower(action);
-    checkBool(action);
-    bool jacket;
-    action == "yes" ? jacket = true : jacket = false;
+    //Today's forecast, if there is one, decides the jacket and sleeve length instead of asking
+    PickOptions options;
+    FileConditionsProvider forecast("Other Files/conditions.csv");
+    Conditions conditions;
+    if (forecast.conditionsFor(today(), conditions)) {
+        options = adviseOutfit(conditions);
+        cout << "   Today's forecast: " << conditions.temperature << " C, " << conditions.precipitation
+             << " mm of rain. " << (options.jacket ? "Adding a jacket." : "No jacket needed.");
+    }
+    else {
+        cout << "   Do you need a jacket? (Yes/No): ";
+        cin >> action;
+        cin.ignore(numeric_limits<streamsize>::max(), '\n');
+        toLower(action);
+        checkBool(action);
+        options.jacket = action == "yes";
+    }
 
-    pickOutfit(outfits, dirty, jacket);
+    vector<ClothingItem> worn;
+    Outfit outfit = pickOutfit(outfits, dirty, options, &worn);
+    journal.record(JOURNAL_WORN, outfit.shoes);     //shoes stay clean, but their wear history changed
+    journal.record(JOURNAL_WEAR, worn);
 }
 
 
 
-int main() {
-    // 1. Load clothing database from file
-    Wardrobe outfits = loadDatabase("Other Files/outfits.csv");
-    Wardrobe dirty = loadDatabase("Other Files/dirtyLaundry.csv");
+/* takeStatsFlag
+ * Removes --stats or --stats=json from the arguments.
+ *
+ * Returns:
+ *   0 if the flag is absent, 1 for the summary, 2 for JSON.
+ */
+int takeStatsFlag(int& argc, char** argv) {
+    int mode = 0;
+    int kept = 1;
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "--stats") mode = 1;
+        else if (arg == "--stats=json") mode = 2;
+        else argv[kept++] = argv[i];
+    }
+    argc = kept;
+    argv[argc] = nullptr;
+    return mode;
+}
+
+int main(int argc, char** argv) {
+    int statsMode = takeStatsFlag(argc, argv);
+
+    // 0. Scripts pass a command and skip the prompts entirely (see Sources/Commands.cpp)
+    if (argc > 1) {
+        int status = runCommand(argc, argv);
+        if (statsMode) {
+            cout << flush;
+            writeStats(stderr, statsMode == 2);
+        }
+        return status;
+    }
+
+    // 1. Load clothing database from file, replaying changes journaled since the last save
+    Journal journal("Other Files/outfits.csv", "Other Files/dirtyLaundry.csv");
+    Wardrobe outfits;
+    Wardrobe dirty;
+    journal.load(outfits, dirty);
+    //  A journal that outgrew the CSVs is folded into them while the prompts run
+    if (journal.needsCompaction(wardrobeSize(outfits) + wardrobeSize(dirty)))
+        journal.compactInBackground(outfits, dirty);
 
     //2. Welcome and print current database
     cout << "\n Welcome to the Outfit Picker!" << endl;
@@ -201,21 +263,28 @@ int main() {
 
     // 3. Prompt user for:
     //  a. Add clothes?
-    promptAdditions(outfits);
+    promptAdditions(outfits, journal);
 
     //  b. Remove clothes?
-    promptRemovals(outfits);
+    promptRemovals(outfits, journal);
     
     //  c. Laundry done?
-    promptLaundry(outfits, dirty);
+    promptLaundry(outfits, dirty, journal);
 
     //  d. Pick outfit?
-    promptOutfit(outfits, dirty);
+    promptOutfit(outfits, dirty, journal);
 
-    // 4. Save updated data to files
-    pushDatabase(outfits, "Other Files/outfits.csv");
-    pushDatabase(dirty, "Other Files/dirtyLaundry.csv");
+    // 4. Save updated data: only this run's changes are appended, and the CSV
+    //    files are rewritten once the journal outgrows them
+    journal.flush();
+    if (journal.needsCompaction(wardrobeSize(outfits) + wardrobeSize(dirty)))
+        journal.compactInBackground(outfits, dirty);
+    journal.waitForCompaction();
 
     cout << "\nAll databases updated. Have a great day!";
+    if (statsMode) {
+        cout << endl;
+        writeStats(stderr, statsMode == 2);
+    }
     return 0;
 }
\ No newline at end of file